@@ -14,6 +14,7 @@
 #include <string>
 #include <vector>
 #include "logic_values.h"
+#include "klsCircuitSnapshot.h"
 using namespace std;
 
 class GUICanvas;
@@ -47,6 +48,15 @@ public:
 	//JV - Changed to return new canvases
 	vector<GUICanvas*> parseFile();
 	bool saveCircuit(string, vector< GUICanvas* >, unsigned int currPage = 0);
+	// The two halves of saveCircuit: build the file contents from the pages
+	// (which must be done on the GUI thread), then write them out. Writing
+	// only uses its arguments, so it may be done on another thread:
+	string serializeCircuit(vector< GUICanvas* >, unsigned int currPage = 0);
+	// Building the file contents can be split again, into a plain copy of
+	// the pages (GUI thread) and its formatting (any thread):
+	static void snapshotCircuit(vector< GUICanvas* >, unsigned int currPage, circuitSnapshot& snap);
+	string serializeCircuit(const circuitSnapshot& snap);
+	bool writeCircuit(string filename, const string& circuitXML, bool syncToDisk = false);
 	// Save in v1.x compatible format (no version tag, no sentinel, single wire IDs)
 	bool saveCircuitLegacy(string, vector< GUICanvas* >, unsigned int currPage = 0);
 	// Get detailed error message from last save operation
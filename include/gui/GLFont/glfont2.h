@@ -8,6 +8,9 @@
 #ifndef GLFONT2_H
 #define GLFONT2_H
 
+#include <string>
+#include <vector>
+
 //*******************************************************************
 //GLFont Interface
 //*******************************************************************
@@ -148,6 +151,11 @@ public:
 	//Begins text output with this font
 	void Begin (void);
 
+	//Builds the quads (x, y and s, t per corner) of a string, so that it
+	//can be drawn later with glDrawArrays(GL_QUADS, ...)
+	void GetStringQuads (const std::string &text, float x, float y,
+		std::vector<float> *vertices, std::vector<float> *tex_coords);
+
 	//Template function to output a character array
 	template<class T> void DrawString (const T *text, float x,
 		float y)
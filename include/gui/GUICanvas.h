@@ -27,6 +27,7 @@ class cmdPasteBlock;
 #include "GUICircuit.h"
 #include "klsCollisionChecker.h"
 #include "wireSegment.h"
+#include "klsWireBatch.h"
 
 class klsCommand;
 class guiWire;
@@ -94,6 +95,14 @@ struct ConnectionSource {
 
 #define ZOOM_ALL_MARGIN 0.25
 
+// Level of detail: when zoomed out past LOD_BOX_ZOOM (in world units per
+// pixel), gates are drawn as filled boxes with no text. Past
+// LOD_OVERVIEW_ZOOM, wires are also drawn without connection dots or bus
+// end caps.
+#define LOD_BOX_ZOOM 0.2
+#define LOD_OVERVIEW_ZOOM 0.4
+#define LOD_BOX_INTENSITY 0.6
+
 // DragStates
 enum DragState {
 	DRAG_NONE = 0,
@@ -151,6 +160,9 @@ public:
 	// Update the collision checker and refresh
 	void Update();
 
+	// Refresh only if part of the region (in world coords) is in view:
+	void refreshRegion( klsBBox region );
+
 	// Return the gate and wire lists for this page
 	unordered_map < unsigned long, guiGate* >* getGateList() { return &gateList; };
 	unordered_map < unsigned long, guiWire* >* getWireList() { return &wireList; };
@@ -161,6 +173,11 @@ public:
 	void insertWire(guiWire*);
 	void removeWire(unsigned long);
 
+	// Note that wires were given their trees in open mode, and merge them
+	// the first time the page is shown:
+	void markOpenShapes() { openShapesPending = true; };
+	void finishOpenShapes();
+
 	// Add a gate
 	void addGate(string gate, GLPoint2f m);
 	
@@ -180,6 +197,7 @@ public:
 		this->minimap = minimap;
 		//Josh Edit 4/9/07
 		if( minimap != NULL ){
+			finishOpenShapes();
 			minimap->setCanvas( this );
 			minimap->setLists( &gateList, &wireList );
 			updateMiniMap();
@@ -203,6 +221,13 @@ public:
 
 private:
 
+	// The area of the page on screen, padded for wide lines and dots:
+	klsBBox getViewBox();
+
+	// Tint the gates and wires by how often they change, with a legend
+	// in the corner of the view. Only the objects in view are tinted:
+	void drawActivityOverlay( const CollisionGroup& inView );
+
 	// Contains all collision information for the page
 	klsCollisionChecker collisionChecker;
 	klsCollisionObject* mouse;
@@ -218,6 +243,13 @@ private:
 	vector < unsigned long > selectedGates;
 	vector < unsigned long > selectedWires;
 
+	// Vertex arrays for drawing all of the page's wires at once
+	klsWireBatch wireBatch;
+
+	// True when some wires on the page still have unmerged trees from
+	// opening a file:
+	bool openShapesPending;
+
 	// Hotspot and wire highlights:
 	unsigned long hotspotGate; // The gate in which a hotspot is highlighted.
 	string hotspotHighlight; // The hotSpot to highlight when rendering. If == "", then none are highlighted.
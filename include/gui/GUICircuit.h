@@ -12,6 +12,7 @@
 #define GUICIRCUIT_H_
 
 #include <map>
+#include <set>
 #include <stack>
 #include <vector>
 #include <fstream>
@@ -22,6 +23,7 @@
 #include "gl_wrapper.h"
 #include "klsMessage.h"
 #include "logic_values.h"
+#include "klsBBox.h"
 using namespace std;
 
 class GUICanvas;
@@ -53,16 +55,33 @@ public:
 	// Sets a named input/output of a gate to be connected; returns pointer to wire
 	guiWire* setWireConnection(const std::vector<IDType> &wireIds, long gid, string connection, bool openMode = false);
 
-	// Sync wire states from shared buffer
-	void syncWireStates();
+	// Sync wire states from shared buffer. Returns the area covered by the
+	// wires that changed state and the gates they connect to:
+	klsBBox syncWireStates();
 	// Delete components and sync the core
 	void deleteWire(unsigned long wid);
 	void deleteGate(unsigned long gid, bool waitToUpdate = false);
+	// Take a gate out of the circuit (and out of the gate indexes below)
+	// without deleting it, as for the gate dragged from the palette:
+	void detachGate(unsigned long gid);
 	
 	// Maps of gates and wires to their IDs
 	unordered_map< unsigned long, guiGate* >* getGates() { return &gateList; };
 	unordered_map< unsigned long, guiWire* >* getWires() { return &wireList; };
 	
+	// The placed gates of a GUI type (such as "TO"), kept up to date as
+	// gates are created and deleted, so they can be found without walking
+	// every gate on every page:
+	const set< unsigned long >& getGatesOfType( const string& guiType );
+
+	// Find the placed gates of a GUI type by name (the JUNCTION_ID of a TO
+	// or FROM, or the LABEL_TEXT of a label):
+	vector< guiGate* > findGatesByName( const string& guiType, const string& name );
+
+	// File a gate again under its name. Call this whenever a gate's
+	// JUNCTION_ID or LABEL_TEXT may have been set:
+	void refileGateName( unsigned long gid );
+
 	unsigned long getNextAvailableGateID() { nextGateID++; while (gateList.find(nextGateID) != gateList.end()) nextGateID++; return nextGateID; };
 	unsigned long getNextAvailableWireID() { nextWireID++; while (wireList.find(nextWireID) != wireList.end()) nextWireID++; return nextWireID; };
 
@@ -78,6 +97,10 @@ public:
 	void setOscope(OscopeFrame* of) { myOscope = of; };
 	
 	void setCurrentCanvas(GUICanvas* gc) { gCanvas = gc; };
+
+	// The logic core's performance counters, as last sent with a DONESTEP
+	// (about once a second):
+	const CircuitStats& getLogicStats() { return logicStats; };
 	
 	bool panic;
 	bool pausing;
@@ -91,12 +114,24 @@ private:
 
 	unordered_map<IDType, guiWire *> buslineToWire;
 
+	// The gate IDs by GUI type, and by type and name:
+	map< string, set< unsigned long > > gatesByType;
+	map< string, map< string, set< unsigned long > > > gatesByName;
+	// The name that each gate is filed under in gatesByName:
+	unordered_map< unsigned long, string > gateNames;
+
+	static string getGateName( guiGate* gate );
+
 	unsigned long nextGateID;
 	unsigned long nextWireID;
 	
 	OscopeFrame* myOscope;
 	GUICanvas* gCanvas;
 
+	// The area of the page that has changed how it looks since the last
+	// DONESTEP, so that steps which change nothing on screen don't repaint:
+	klsBBox dirtyRegion;
+
 	bool   m_init;
     GLuint m_gllist;
 	double lastDragX;
@@ -117,6 +152,8 @@ private:
     unsigned long  m_LastRedraw;
  
     vector < klsMessage::Message > messageQueue;
+
+	CircuitStats logicStats;
 };
 
 #endif /*GUICIRCUIT_H*/
@@ -92,6 +92,12 @@ public:
 	map < string, map < string, LibraryGate > >* getGateDefs() { return &gates; };
 
 private:
+	// Fill in the app's libraries and gateNameToLibrary from gates:
+	void registerGates();
+
+	// Where to cache parsed libraries, or "" if there's nowhere to put it:
+	static string getCacheFile();
+
 	XMLParser* mParse;
 	string fileName;
 	string libName;
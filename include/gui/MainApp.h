@@ -26,6 +26,8 @@
 #include "LibraryParse.h"
 #include "gl_defs.h"
 #include "klsMessage.h"
+#include "klsThumbnailAtlas.h"
+#include <atomic>
 #include <deque>
 #include <string>
 #include <unordered_map>
@@ -52,6 +54,7 @@ struct ApplicationSettings {
     bool wireConnVisible;
     bool gridlineVisible;
     bool rightClickRotate;
+    int undoMemoryLimit; // MB, 0 for no limit
 };
 
 class MainApp : public wxApp {
@@ -79,6 +82,14 @@ public:
 	deque< klsMessage::Message > dLOGICtoGUI;
 	wxMutex wireStateMutex;
 	unordered_map<IDType, StateType> wireStateBuffer;
+	// Gate updates and wire toggles per second, sampled by the logic
+	// thread while the activity heat map is shown:
+	wxMutex activityMutex;
+	unordered_map<IDType, float> gateActivity;
+	unordered_map<IDType, float> wireActivity;
+	// Whether the activity heat map is shown (set by the GUI, and read by
+	// the logic thread):
+	std::atomic<bool> activityVisible;
 	// Use a stopwatch for timing between step calls
 	wxStopWatch appSystemTime;
 	unsigned long timeStepMod;
@@ -90,6 +101,9 @@ public:
 	LibraryParse libParser;
 	map < string, map < string, LibraryGate > > libraries;
 	map < string, string > gateNameToLibrary;
+
+	// The palette pictures of the library gates:
+	klsThumbnailAtlas gateThumbnails;
 		
     // the last exiting thread should post to m_semAllDone if this is true
     // (protected by the same m_critsect)
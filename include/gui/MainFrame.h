@@ -31,6 +31,8 @@
 class OscopeFrame;
 #include "klsMiniMap.h"
 #include "autoSaveThread.h"
+#include "klsCommandProcessor.h"
+#include "klsImageWriter.h"
 
 enum
 {
@@ -39,6 +41,7 @@ enum
 	File_ExportLegacy,
 	
 	View_Oscope,
+	View_Activity,
 	View_Gridline,
 	View_WireConn,
 	View_RightClickRotate,
@@ -96,6 +99,7 @@ public:
 	void OnCopy(wxCommandEvent& event);
 	void OnPaste(wxCommandEvent& event);	
 	void OnOscope(wxCommandEvent& event);
+	void OnViewActivity(wxCommandEvent& event);
 	void OnViewGridline(wxCommandEvent& event);
 	void OnViewWireConn(wxCommandEvent& event);
 	void OnViewRightClickRotate(wxCommandEvent& event);
@@ -135,6 +139,8 @@ public:
 	//Julian: Added functions to help with auto save functionality
 	void autosave();
 	bool fileIsDirty();
+	// Show the logic core's performance counters in the status bar:
+	void showLogicStats(const CircuitStats& stats);
 	void removeTempFile();
 	bool isHandlingEvent();
 	void lock();
@@ -146,6 +152,10 @@ public:
 
 	//Julian: Added to simplify exporting and copying to clipboard
 	wxBitmap getBitmap(bool withGrid, bool noColor = false, int multiplier = 2);
+
+	// Render the page straight into an image file a band at a time, so that
+	// big images never have to fit in memory. Returns false on failure:
+	bool exportImageFile(const wxString& path, klsImageWriter& out, bool withGrid, bool noColor, int multiplier);
 	
 private:
     // helper function - creates a new thread (but doesn't run it)
@@ -158,7 +168,7 @@ private:
 	GUICanvas* currentCanvas;
 	klsMiniMap* miniMap;
 	
-	wxCommandProcessor* commandProcessor;
+	klsCommandProcessor* commandProcessor;
 
 	wxPanel* mainPanel;
 	wxToolBar* toolBar;
@@ -18,6 +18,7 @@ class OscopeCanvas;
 #include "wx/glcanvas.h"
 #include "GUICircuit.h"
 #include "logic_values.h"
+#include "OscopeTrace.h"
 
 #include <map>
 #include <vector>
@@ -53,15 +54,38 @@ public:
     wxImage generateImage();
     
     void clearData( void ) {
-    	stateValues.clear();
+    	traces.clear();
+    	bindingsValid = false;
+    	sampleTime = 0;
     };
 
 	// Pointer to the main application graphic circuit
 	GUICircuit* gCircuit;
 
 private:
-	// Stored values of wire states:
-	map< string, deque< StateType > > stateValues;
+	// Find the TO gate that each feed is read from:
+	void bindFeeds( void );
+
+	// Draw a trace's runs as line (or box) segments:
+	void drawTrace( const OscopeTrace& trace, unsigned int wireNum );
+
+	// Stored values of wire states, by junction name:
+	map< string, OscopeTrace > traces;
+
+	// The number of samples taken since the data was cleared:
+	unsigned long sampleTime;
+
+	// Where each traced junction's state comes from:
+	struct feedBinding {
+		unsigned long gateID; // The TO gate
+		string input; // The TO's input hotspot
+		OscopeTrace* trace;
+	};
+	vector< feedBinding > bindings;
+
+	// The feed names that the bindings were made for:
+	vector< string > boundFeeds;
+	bool bindingsValid;
 	
 	bool m_init;
 	
@@ -0,0 +1,54 @@
+/*****************************************************************************
+   Project: CEDAR Logic Simulator
+   Copyright 2006 Cedarville University, Benjamin Sprague,
+                     Matt Lewellyn, and David Knierim
+   All rights reserved.
+   For license information see license.txt included with distribution.
+
+   OscopeTrace: Run-length encoded history of one oscope signal
+*****************************************************************************/
+
+#ifndef OSCOPETRACE_H_
+#define OSCOPETRACE_H_
+
+#include <vector>
+#include "logic_values.h"
+
+using namespace std;
+
+// The most state changes kept for a trace. Once full, the oldest changes
+// are dropped, so a trace never takes more memory than this:
+#define OSCOPE_TRACE_RUNS 1024
+
+// Stores a signal's history as the sample times at which its state
+// changed, in a fixed-size ring. A sample that matches the last state
+// doesn't take any space.
+class OscopeTrace {
+public:
+	// A run of samples with the same state, starting at startTime and
+	// lasting until the next run's startTime:
+	struct run {
+		unsigned long startTime;
+		StateType state;
+	};
+
+	OscopeTrace();
+
+	// Record the signal's state at a sample time:
+	// (Times must not go backwards.)
+	void addSample( unsigned long time, StateType state );
+
+	void clear( void );
+
+	// The number of runs stored, and the runs themselves from oldest (0)
+	// to newest (numRuns() - 1):
+	unsigned int numRuns( void ) const { return count; };
+	const run& getRun( unsigned int i ) const;
+
+private:
+	vector< run > runs;
+	unsigned int first; // Index of the oldest run
+	unsigned int count;
+};
+
+#endif /*OSCOPETRACE_H_*/
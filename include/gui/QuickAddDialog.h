@@ -3,6 +3,7 @@
 
 #include "MainApp.h"
 #include "LibraryParse.h"
+#include "klsPrefixTrie.h"
 #include <vector>
 #include <string>
 #include <map>
@@ -24,7 +25,7 @@ private:
 	void updateList(const string& query);
 	void updatePreview();
 	void confirm();
-	int fuzzyScore(const string& query, const string& target);
+	int fuzzyScore(const string& lowerQuery, const string& lowerTarget);
 	wxBitmap renderGatePreview(const string& gateName, int width, int height);
 
 	wxTextCtrl* searchField;
@@ -36,8 +37,19 @@ private:
 		string gateName;
 		string caption;
 		string libraryName;
+		// Lowercased once, for matching:
+		string lowerName;
+		string lowerCaption;
 	};
 	vector<GateEntry> allGates;
+
+	// The gates by name and caption, for prefix matches:
+	klsPrefixTrie gateTrie;
+
+	// The last query and the gates that matched it. A query that adds to
+	// the end of the last one can only match gates that matched it, too:
+	string lastQuery;
+	vector<size_t> lastMatches;
 	map<string, wxBitmap> previewCache;
 };
 
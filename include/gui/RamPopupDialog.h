@@ -2,6 +2,8 @@
 #define RAMPOPUPDIALOG_H_
 
 #include <wx/grid.h>
+#include <wx/timer.h>
+#include <set>
 
 #define RAM_TITLE "Ram Info"
 #define RAM_WIDTH 1500
@@ -11,6 +13,10 @@
 #define RAM_X_POS 20
 #define RAM_Y_POS 30
 
+// How often (in ms) changed cells are redrawn while the simulation runs.
+// Changes that come in between redraws are drawn together.
+#define RAM_REFRESH_INTERVAL 33
+
 
 #include "MainApp.h"
 
@@ -34,9 +40,11 @@ public:
 	void OnSize();
 	wxString OnGetItemText(long item, long column) const;
 	
-	//This is called by the guiGateRAM when an item changes
-	void updateGridDisplay( );
+	//This is called by the guiGateRAM when the value or
+	//highlight of an address changes
+	void updateGridDisplay( long address );
 	void notifyAllChanged();
+	void OnRefreshTimer( wxTimerEvent& event );
 
 protected:
 	DECLARE_EVENT_TABLE()
@@ -49,6 +57,11 @@ private:
     wxButton* loadBtn;
     wxButton* saveBtn;
     wxCheckBox* hexOrDecCB;
+
+    //The addresses to redraw on the next refresh tick
+    std::set< long > changedAddresses;
+    bool allChanged;
+    wxTimer refreshTimer;
     
 };
 
@@ -59,6 +72,7 @@ class virtualGrid : public wxGridTableBase {
 public:
 	
 	virtualGrid (int addressSize, int dataSize, guiGateRAM* newM_ramGuiGate, GUICircuit* newGUICircuit, wxCheckBox* hexOrDecCBArg);
+	virtual ~virtualGrid ();
 	
 	virtual int GetNumberRows ();
 	virtual int GetNumberCols ();
@@ -83,6 +97,11 @@ private:
 	
     int addressSize;
     int dataSize;
+
+    //Shared by every highlighted cell, rather than
+    //making a new one each time a cell is drawn
+    wxGridCellAttr* readAttr;
+    wxGridCellAttr* writtenAttr;
     
 };
 
@@ -14,12 +14,14 @@ public:
 	double getWireConnRadius() const;
 	bool getGridlineVisible() const;
 	int getRefreshRate() const;
+	int getUndoMemoryLimit() const;
 
 private:
 	wxCheckBox* wireConnVisibleCtrl;
 	wxSpinCtrlDouble* wireConnRadiusCtrl;
 	wxCheckBox* gridlineVisibleCtrl;
 	wxSpinCtrl* refreshRateCtrl;
+	wxSpinCtrl* undoMemoryLimitCtrl;
 };
 
 #endif
@@ -6,7 +6,11 @@
 #define AUTO_SAVE_THREAD_H
 
 #include <ctime>
+#include <string>
 #include "wx/thread.h"
+#include "klsCircuitSnapshot.h"
+
+using namespace std;
 
 class autoSaveThread : public wxThread
 {
@@ -17,11 +21,31 @@ public:
 
 	virtual void OnExit();
 
+	// Hand over a copy of the circuit to be formatted and written to a file
+	// by this thread. (Called from the GUI thread.)
+	void queueSnapshot(const string& filename, const circuitSnapshot& snapshot);
+
+	// Drop any snapshot that hasn't been written yet, and wait for one that
+	// is being written to finish, so that the file can be safely removed.
+	void cancelSnapshot();
+
 private:
+	// Write the queued snapshot, if there is one:
+	void writeSnapshot();
 
 	time_t timeout;
 	const int WAIT_TIME = 180;
 
+	// Guards the snapshot, and is held while it is written (but not while
+	// it is formatted):
+	wxMutex snapshotMutex;
+	bool hasSnapshot;
+	string snapshotFile;
+	circuitSnapshot snapshot;
+	// Counts cancels, so that a snapshot taken out to be formatted isn't
+	// written after it has been cancelled:
+	unsigned long cancelCount;
+
 };
 
 #endif //AUTO_SAVE_THREAD_H
\ No newline at end of file
@@ -6,17 +6,24 @@
 // cmdCreateGate - creates a gate on a given canvas at position (x,y)
 class cmdCreateGate : public klsCommand {
 public:
+	// (A gate created with fromString set is treated like one read from
+	// text, as when pasting: its params are set without touching the oscope.)
 	cmdCreateGate(GUICanvas* gCanvas, GUICircuit* gCircuit,
-		unsigned long gid, std::string gateType, float x, float y);
+		unsigned long gid, std::string gateType, float x, float y,
+		bool fromString = false);
 
 	cmdCreateGate(std::string def);
 
+	virtual ~cmdCreateGate();
+
 	bool Do();
 
 	bool Undo();
 
 	virtual std::string toString() const override;
 
+	virtual size_t getMemorySize() const override;
+
 	virtual void setPointers(GUICircuit* gCircuit, GUICanvas* gCanvas,
 		TranslationMap &gateids, TranslationMap &wireids) override;
 
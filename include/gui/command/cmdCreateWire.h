@@ -26,6 +26,8 @@ public:
 
 	virtual std::string toString() const override;
 
+	virtual size_t getMemorySize() const override;
+
 	virtual void setPointers(GUICircuit* gCircuit, GUICanvas* gCanvas,
 		TranslationMap &gateids, TranslationMap &wireids) override;
 
@@ -14,6 +14,8 @@ public:
 
 	bool Undo();
 
+	virtual size_t getMemorySize() const override;
+
 private:
 		IDType gateId;
 		std::stack<klsCommand *> cmdList;
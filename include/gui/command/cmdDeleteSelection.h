@@ -16,6 +16,8 @@ public:
 
 	bool Undo();
 
+	virtual size_t getMemorySize() const override;
+
 private:
 	std::vector<unsigned long> gates;
 	std::vector<unsigned long> wires;
@@ -27,6 +27,8 @@ public:
 
 	bool Undo();
 
+	virtual size_t getMemorySize() const override;
+
 protected:
 	std::vector < unsigned long > gates;
 	std::vector < unsigned long > wires;
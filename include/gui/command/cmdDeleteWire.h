@@ -15,6 +15,8 @@ public:
 
 	bool Undo();
 
+	virtual size_t getMemorySize() const override;
+
 private:
 	std::vector<IDType> wireIds;
 	std::stack<klsCommand *> cmdList;
@@ -4,6 +4,7 @@
 #include <vector>
 #include <map>
 #include "../wireSegment.h"
+#include "../klsSegmentDelta.h"
 #include "../GUICanvas.h"
 
 // Just a map of wire segments
@@ -16,17 +17,21 @@ public:
 		vector<WireState> &preMoveWire, float startX, float startY,
 		float endX, float endY);
 
+	virtual ~cmdMoveSelection();
+
 	bool Do();
 
 	bool Undo();
 
+	virtual size_t getMemorySize() const override;
+
 	vector<klsCommand *> * getConnections();
 
 protected:
 	vector<unsigned long> gateList;
 	vector<unsigned long> wireList;
 	map<unsigned long, SegmentMap> oldSegMaps;
-	map<unsigned long, SegmentMap> newSegMaps;
+	map<unsigned long, klsSegmentDelta> newSegDeltas;
 	float startX, startY, endX, endY;
 	int wireMove;
 	vector<klsCommand *> proxconnects;
@@ -8,12 +8,16 @@ class cmdPasteBlock : public klsCommand {
 public:
 	cmdPasteBlock(std::vector<klsCommand*> &cmdList);
 
+	virtual ~cmdPasteBlock();
+
 	bool Do();
 
 	bool Undo();
 
 	void addCommand(klsCommand* cmd) { cmdList.push_back(cmd); };
 
+	virtual size_t getMemorySize() const override;
+
 private:
 	std::vector<klsCommand *> cmdList;
 	bool m_init;
@@ -21,12 +21,19 @@ public:
 
 	cmdSetParams(std::string def);
 
+	// Set the params of a gate that is being pasted. Like the string
+	// constructor, there are no old params to undo back to.
+	cmdSetParams(unsigned long gid, const ParameterMap &gParams,
+		const ParameterMap &lParams);
+
 	bool Do();
 
 	bool Undo();
 
 	virtual std::string toString() const override;
 
+	virtual size_t getMemorySize() const override;
+
 	virtual void setPointers(GUICircuit* gCircuit, GUICanvas* gCanvas,
 		TranslationMap &gateids, TranslationMap &wireids) override;
 
@@ -3,6 +3,7 @@
 #include "klsCommand.h"
 #include <map>
 #include "../wireSegment.h"
+#include "../klsSegmentDelta.h"
 
 // cmdWireSegDrag - Set's a wire's tree after dragging a segment
 class cmdWireSegDrag : public klsCommand {
@@ -13,8 +14,10 @@ public:
 
 	bool Undo();
 
+	virtual size_t getMemorySize() const override;
+
 private:
 	std::map<long, wireSegment> oldSegMap;
-	std::map<long, wireSegment> newSegMap;
+	klsSegmentDelta newSegDelta;
 	unsigned long wireID;
 };
\ No newline at end of file
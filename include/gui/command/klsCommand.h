@@ -3,6 +3,8 @@
 
 #include <string>
 #include <unordered_map>
+#include <vector>
+#include <stack>
 #include "wx/cmdproc.h"
 #include "logic_values.h"
 
@@ -27,7 +29,14 @@ public:
 	virtual void setPointers(GUICircuit* gCircuit, GUICanvas* gCanvas,
 		TranslationMap &gateids, TranslationMap &wireids);
 
+	// About how many bytes the command takes up in the undo history:
+	virtual size_t getMemorySize() const;
+
 protected:
+	// About how many bytes a list of sub-commands takes up:
+	static size_t sumMemorySize(const std::vector<klsCommand *> &cmdList);
+	static size_t sumMemorySize(const std::stack<klsCommand *> &cmdList);
+
 	GUICircuit *gCircuit;
 	GUICanvas *gCanvas;
 	bool fromString;
@@ -46,16 +46,8 @@ public:
 	string getGateName() { return gateName; };
 
 private:
-	void setViewport();
-	void generateImage();
-	void renderMap();
-	void update();
-	
-	guiGate* m_gate;
-
 	string gateName;
 	bool inImage;
-	wxImage gImage;
 	
 	wxDragImage* m_dragImage;
 	bool m_init;
@@ -21,5 +21,9 @@ class glImageCtx {
 public:
 	glImageCtx(int width, int height, wxWindow *parent);
 	wxImage getImage();
+
+	// Copy the bottom-left w x h pixels that were rendered into rgb as
+	// packed 24-bit rows, top row first:
+	void readPixels(int w, int h, unsigned char *rgb);
 	~glImageCtx();
 };
@@ -29,6 +29,7 @@ class guiWire;
 #include "guiText.h"
 #include "klsCollisionChecker.h"
 #include "klsMessage.h"
+#include "klsCircuitSnapshot.h"
 #include "wx/docview.h"
 
 #include "RamPopupDialog.h"
@@ -37,6 +38,10 @@ using namespace std;
 
 #define GATE_HOTSPOT_THICKNESS 0.05
 
+// Cell size of the grid that a gate's hotspots are filed in, for finding
+// the hotspot under the mouse:
+#define GATE_HOTSPOT_GRID_CELL_SIZE 1.0
+
 class gateHotspot : public klsCollisionObject {
 friend class guiGate;
 public:
@@ -127,6 +132,7 @@ public:
 	// Set and get param virtual functions, simply assigns a string
 	virtual void setGUIParam( string paramName, string value ) {
 		gparams[paramName] = value;
+		shapeRevision++;
 		if( paramName == "angle" ) {
 			// Update the matrices and bounding box:
 			updateConnectionMerges();
@@ -137,6 +143,7 @@ public:
 	map < string, string >* getAllGUIParams() { return &gparams; };
 	virtual void setLogicParam( string paramName, string value ) {
 		lparams[paramName] = value;
+		shapeRevision++; // (Labels and displays draw their params)
 	};
 	virtual string getLogicParam( string paramName ) { return lparams[paramName]; };
 	map < string, string >* getAllLogicParams() { return &lparams; };
@@ -146,6 +153,10 @@ public:
 	virtual void draw(bool color = true);
 	void setGLcoords( float x, float y, bool noUpdateWires = false );
 	void getGLcoords( float &x, float &y );
+
+	// A count that goes up whenever the gate moves, turns, or has a
+	// parameter set, so that cached drawings of it know to redraw:
+	unsigned long getShapeRevision() const { return shapeRevision; };
 	
 	// Shift the gate by x and y, relative to its current location:
 	void translateGLcoords( float x, float y );
@@ -230,7 +241,10 @@ public:
 	bool isSelected() { return selected; };
 	bool isConnectionInput(string idx) { return isInput[idx]; };
 	
-	void saveGate(XMLParser*);
+	// Copy what is saved for this gate (done on the GUI thread), and write
+	// such a copy out (which may be done on any thread):
+	void snapshotGate( gateSnapshot& snap );
+	static void saveGate( XMLParser* xparse, const gateSnapshot& snap );
 	// Save in v1.x compatible format (single wire IDs)
 	void saveGateLegacy(XMLParser*);
 
@@ -244,9 +258,12 @@ public:
 	//it wants to into the file.
 	//Also any other gate that wishes too, can also
 	//save specific stuff.
-	virtual void saveGateTypeSpecifics( XMLParser* xparse ){};
+	void saveGateTypeSpecifics( XMLParser* xparse );
 	//End of edit***********************
 
+	// Add any extra logic params that this type of gate saves:
+	virtual void getTypeSpecificParams( vector< pair< string, string > >& params ) {};
+
 
 	// Return the map of hotspot names to their coordinates:
 	map<string, GLPoint2f> getHotspotList( void ) { 
@@ -266,14 +283,23 @@ protected:
 	GLfloat myX, myY;
 
 	bool selected; // Is this gate selected or not?
+	unsigned long shapeRevision;
 
 	// Model space bounding box:
 	klsBBox modelBBox;
 	
 	vector<GLPoint2f> vertices;
 	vector<GLPoint2f> labelVertices;
+
+	// The "angle" gui param as a number, and the label lines counter-rotated
+	// by it so they stay upright. (Kept up to date by updateBBoxes(), so that
+	// draw() doesn't need to parse the param.)
+	GLfloat renderInfo_angle;
+	vector<GLPoint2f> renderInfo_labelVertices;
 	// map i/o name to hotspot coord
 	map< string, gateHotspot* > hotspots;
+	// The hotspots, filed by world location
+	klsSpatialGrid hotspotIndex;
 	// map i/o name to wire id
 	map< string, guiWire* > connections;
 	// map i/o name to status as input (true = input, false = output)
@@ -408,6 +434,10 @@ public:
 
 private:
 	guiText theText;
+
+	// Which way the text is scooted when it is flipped upright:
+	// (+1 for TO gates, -1 for FROM gates. Set by calcBBox().)
+	int renderInfo_textDirection;
 };
 
 
@@ -431,7 +461,7 @@ public:
 	
 	//Saves the ram contents to the circuit file
 	//when the circuit saves
-	virtual void saveGateTypeSpecifics( XMLParser* xparse );
+	virtual void getTypeSpecificParams( vector< pair< string, string > >& params );
 	
 	//Because the ram gui will be passed lots of data
 	//from the ram logic, we don't want it all going
@@ -15,6 +15,7 @@
 #include "gl_wrapper.h"
 
 #include <string>
+#include <vector>
 
 using namespace std;
 
@@ -77,6 +78,10 @@ public:
 	void setText( string newString ) { textString = newString; };
 
 private:
+	// Build the glyph quads and size of the text string, if the string or
+	// the font has changed since they were last built:
+	void updateRenderInfo( void );
+
 	// The text color:
 	GLfloat color[4];
 	
@@ -88,6 +93,18 @@ private:
 
 	// The text string to be displayed:	
 	string textString;
+
+	// Glyph quads and size (in unscaled font units) of the text, built from
+	// renderInfo_text with font number renderInfo_fontRevision:
+	vector< GLfloat > renderInfo_vertices;
+	vector< GLfloat > renderInfo_texCoords;
+	int renderInfo_width, renderInfo_height;
+	string renderInfo_text;
+	unsigned long renderInfo_fontRevision;
+
+	// Bumped each time a different font file is loaded:
+	static unsigned long fontRevision;
+	static string fontFile;
 	
 	// The font loading initialization flag:
 	static bool fontIsLoaded;
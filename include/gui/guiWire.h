@@ -17,6 +17,7 @@
 #include "logic_values.h" // StateType
 #include "klsCollisionChecker.h"
 #include "wireSegment.h"
+#include "klsCircuitSnapshot.h"
 
 class guiGate;
 class XMLParser;
@@ -52,6 +53,15 @@ public:
 
 	void draw(bool color = true);
 
+	// Get the color that the wire is drawn in, based on its state:
+	void getColor(GLfloat rgba[4], bool color = true) const;
+
+	// Counts that go up whenever this wire changes, so that cached drawings
+	// of it know what to rebuild. The shape revision covers its lines,
+	// ids, and selection; the state revision covers only its color:
+	unsigned long getShapeRevision() const { return shapeRevision; }
+	unsigned long getStateRevision() const { return stateRevision; }
+
 	bool hover(float cx, float cy, float delta);
 
 	GLPoint2f getCenter();
@@ -93,8 +103,17 @@ public:
 	// Get the intersection points for drawing connection dots
 	const std::vector<GLPoint2f>& getIntersectPoints() const { return renderInfo.intersectPoints; }
 
+	// Get the line segments that make up the drawn wire
+	const std::vector<GLLine2f>& getLineSegments() const { return renderInfo.lineSegments; }
+
+	// Get the points where the wire meets gate hotspots
+	const std::vector<GLPoint2f>& getVertexPoints() const { return renderInfo.vertexPoints; }
+
 	// Give directions for XML tag definition of wire
-	void saveWire(XMLParser* xparse);
+	// Copy what is saved for this wire (done on the GUI thread), and write
+	// such a copy out (which may be done on any thread):
+	void snapshotWire(wireSnapshot& snap);
+	static void saveWire(XMLParser* xparse, const wireSnapshot& snap);
 	// Save in v1.x compatible format (single wire ID)
 	void saveWireLegacy(XMLParser* xparse);
 
@@ -107,7 +126,13 @@ public:
 	// Set the map/tree from which the wire will generate its shape.
 	//	Tree must contain valid wireConnection information.
 	//	IMPORTANT: Also must set nextSegID to be a valid ID
-	void setSegmentMap(map < long, wireSegment > newSegMap);
+	//	If openMode is true, the tree is only stored; it isn't merged or
+	//	added to the bbox until finishOpenShape is called.
+	void setSegmentMap(map < long, wireSegment > newSegMap, bool openMode = false);
+
+	// Merge a tree that was set in open mode, so that the wire can be
+	//	drawn and hit tested. Does nothing if no tree is waiting.
+	void finishOpenShape();
 
 	// We need to hold an initial seg map for undo/redo functionality.
 	map < long, wireSegment > getOldSegmentMap();
@@ -157,6 +182,7 @@ private:
 	// Instance vars
 	bool selected;
 	bool setVerticalBar;
+	bool shapePending; // Tree set in open mode, not merged yet
 	long headSegment; // reference segment
 	
 	// The wire ids for each wire in the bus.
@@ -176,6 +202,9 @@ private:
 	long currentDragSegment;
 
 	glWireRenderInfo renderInfo;
+
+	unsigned long shapeRevision;
+	unsigned long stateRevision;
 };
 
 #endif /*GUIWIRE_H_*/
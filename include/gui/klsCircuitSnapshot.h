@@ -0,0 +1,68 @@
+/*****************************************************************************
+   Project: CEDAR Logic Simulator
+   Copyright 2006 Cedarville University, Benjamin Sprague,
+                     Matt Lewellyn, and David Knierim
+   All rights reserved.
+   For license information see license.txt included with distribution.
+
+   klsCircuitSnapshot: A plain copy of what is saved for a circuit
+*****************************************************************************/
+
+#ifndef KLSCIRCUITSNAPSHOT_H_
+#define KLSCIRCUITSNAPSHOT_H_
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+using namespace std;
+
+#include "gl_defs.h"
+#include "logic_values.h"
+
+// These hold only values (no pointers into the GUI objects, and no
+// collision data), so that once they are taken on the GUI thread they can
+// be written out as XML on another thread while the user keeps editing.
+
+// A connection of a gate hotspot to a wire (or bus):
+struct hotspotSnapshot {
+	string name;
+	bool isInput;
+	vector< IDType > wireIds;
+};
+
+struct gateSnapshot {
+	unsigned long id;
+	string type;
+	float x, y;
+	vector< hotspotSnapshot > connections;
+	vector< pair< string, string > > guiParams;
+	// The logic params to save, including any that the gate type adds:
+	vector< pair< string, string > > logicParams;
+};
+
+struct segmentSnapshot {
+	long id;
+	bool isVertical;
+	GLPoint2f begin, end;
+	vector< pair< unsigned long, string > > connections; // Gate id and hotspot
+	map < GLfloat, vector < long > > intersects;
+};
+
+struct wireSnapshot {
+	vector< IDType > ids;
+	vector< segmentSnapshot > segments;
+};
+
+struct pageSnapshot {
+	GLPoint2f topLeft, bottomRight; // The page viewport
+	vector< gateSnapshot > gates;
+	vector< wireSnapshot > wires;
+};
+
+struct circuitSnapshot {
+	unsigned int currPage;
+	vector< pageSnapshot > pages;
+};
+
+#endif /*KLSCIRCUITSNAPSHOT_H_*/
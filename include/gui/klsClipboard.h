@@ -12,19 +12,79 @@
 #define KLSCLIPBOARD_H_
 
 #include <vector>
+#include <map>
+#include <string>
+#include <memory>
 using namespace std;
 
+#include "wireSegment.h"
+
 class cmdPasteBlock;
+class klsCommand;
+class blockTextDataObject;
 class GUICircuit;
 class GUICanvas;
 
+// A copied gate, with the params it had when it was copied:
+struct clipboardGate {
+	unsigned long id;
+	string type;
+	float x, y;
+	map < string, string > gParams;
+	map < string, string > lParams;
+};
+
+// A copied wire, trimmed down to its connections to the copied gates:
+struct clipboardWire {
+	vector < unsigned long > ids;
+	vector < pair < unsigned long, string > > connections; // gate id, hotspot
+	map < long, wireSegment > shape;
+};
+
+struct clipboardBlock {
+	vector < clipboardGate > gates;
+	vector < clipboardWire > wires;
+};
+
+// The last copied block is kept here as a clipboardBlock, and the system
+// clipboard gets its text form (for other programs and other instances)
+// along with a small token that marks it as this process's copy. While the
+// token is still on the clipboard, pasting builds the commands straight
+// from the block instead of parsing the text. The text form is only built
+// if something actually asks the clipboard for it.
 class klsClipboard {
+	friend class blockTextDataObject;
+
 public:
 	klsClipboard() { return; };
 	virtual ~klsClipboard() { return; };
 	
 	cmdPasteBlock* pasteBlock( GUICircuit* gCircuit, GUICanvas* gCanvas );
 	void copyBlock( GUICircuit* gCircuit, GUICanvas* gCanvas, vector < unsigned long > gates, vector < unsigned long > wires );
+
+private:
+	// The commands that recreate a block, with the block's own ids:
+	// (They still need setPointers() before they are done.)
+	static vector < klsCommand* > makeCommands( const clipboardBlock& block );
+
+	// The text form of a block, one command string per line:
+	static string blockToText( const clipboardBlock& block );
+
+	// Put copiedBlock's token, and a text form that renders itself when it is
+	// first asked for, on the (open) clipboard:
+	static void putOnClipboard( void );
+
+	// Is copiedBlock's token still on the (open) clipboard?
+	static bool holdsCopiedBlock( void );
+
+	// Add one to the number on the end of a TO/FROM's junction name.
+	// Returns false if there is no number to add to:
+	static bool incrementJunction( clipboardGate& gate );
+
+	// Never changed once it is shared with the clipboard; auto-increment
+	// replaces it instead:
+	static shared_ptr< const clipboardBlock > copiedBlock;
+	static unsigned long copySerial;
 };
 
 #endif /*KLSCLIPBOARD_H_*/
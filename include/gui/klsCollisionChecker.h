@@ -17,6 +17,7 @@
 using namespace std;
 
 #include "klsBBox.h"
+#include "klsSpatialGrid.h"
 
 
 enum klsCollisionObjectType {
@@ -40,7 +41,7 @@ class klsCollisionObject;
 class klsCollisionChecker;
 
 // An arbitrary-ordered group of collision objects:
-typedef set< klsCollisionObject* > CollisionGroup;
+// (CollisionGroup is declared in klsSpatialGrid.h.)
 
 class klsCollisionObject {
 friend class klsCollisionChecker;
@@ -81,6 +82,10 @@ public:
 	// (Returns a list of subobjects of this object involved in any collisions.)
 	CollisionGroup checkSubsToSubs( klsCollisionObject* objB, bool resetOverlaps = true );
 
+	// Check if any of this object's subobjects overlap a box, without
+	// copying the groups or touching any overlap information:
+	bool subsOverlap( klsBBox box );
+
 	// Return the overlaps of this object:
 	CollisionGroup getOverlaps();
 
@@ -135,6 +140,11 @@ private:
 		// A flag to tell if the bounding box of the object has changed:
 		bool bboxChanged;
 
+		// The collision checker that this object has been added to, if any:
+		// (The checker is told whenever the bbox changes, to keep its
+		// spatial index up to date.)
+		klsCollisionChecker* checker;
+
 		// Temporary data:
 		// (This is filled out by a call to the collision checker.)
 		CollisionGroup overlaps; // Other objects that overlap this one.
@@ -142,10 +152,11 @@ private:
 };
 
 class klsCollisionChecker {
+friend class klsCollisionObject;
 public:
 	klsCollisionChecker() = default;
 
-	virtual ~klsCollisionChecker() = default;
+	virtual ~klsCollisionChecker();
 	
 	// Check the overlaps of all of the collision objects stored in this checker,
 	// and update their status:
@@ -171,9 +182,36 @@ public:
 	map< klsCollisionObjectType, CollisionGroup > overlaps;
 
 	void clear();
+
+	// Return the objects in this checker whose bboxes overlap the box:
+	// (This uses the spatial index, so it only costs as much as the number
+	// of objects near the box.)
+	CollisionGroup getObjectsInBox( klsBBox box );
 	
 private:
+	// Called by an object in this checker when its bbox changes:
+	void objectMoved( klsCollisionObject* obj );
+
+	// Called by an object in this checker when it gains its first overlap
+	// or loses its last one:
+	void objectOverlapsChanged( klsCollisionObject* obj );
+
+	// Take an object out of all of this checker's lists:
+	void forgetObject( klsCollisionObject* obj );
+
 	CollisionGroup collisionObjects;
+
+	// The objects in collisionObjects, filed by location:
+	klsSpatialGrid index;
+
+	// Objects whose bboxes have changed since the last update(), and the
+	// special-type objects (view box, sel box, mouse, etc) that are
+	// checked on every update():
+	CollisionGroup changedObjects;
+	CollisionGroup specialObjects;
+
+	// Objects that currently have any overlaps:
+	CollisionGroup overlappingObjects;
 };
 
 #endif /*KLSCOLLISIONCHECKER_H_*/
@@ -0,0 +1,61 @@
+/*****************************************************************************
+   Project: CEDAR Logic Simulator
+   Copyright 2006 Cedarville University, Benjamin Sprague,
+                     Matt Lewellyn, and David Knierim
+   All rights reserved.
+   For license information see license.txt included with distribution.
+
+   klsCommandProcessor: Undo history with a memory budget
+*****************************************************************************/
+
+#ifndef KLSCOMMANDPROCESSOR_H_
+#define KLSCOMMANDPROCESSOR_H_
+
+#include <unordered_map>
+#include "wx/cmdproc.h"
+
+// A wxCommandProcessor that forgets the oldest undo steps once the history
+// grows past appSettings.undoMemoryLimit megabytes (0 means no limit).
+// Sizes come from klsCommand::getMemorySize(), measured once when each
+// command is stored, and a running total is kept.
+class klsCommandProcessor : public wxCommandProcessor {
+public:
+	klsCommandProcessor() : historySize( 0 ), savedStateDropped( false ) { return; };
+
+	virtual void Store( wxCommand* command ) override;
+	virtual void ClearCommands() override;
+
+	// Once the commands back to the last save have been dropped, the saved
+	// state can't be reached again, so the circuit stays dirty until it is
+	// saved again (even if everything left is undone):
+	bool IsDirty() const;
+	void MarkAsSaved();
+
+	// Measure the current command again, after more has been added to it
+	// since it was stored:
+	void remeasureCurrentCommand( void );
+
+	// Drop the oldest done commands until the history fits the budget:
+	// (The current command and anything that can be redone are kept.)
+	void trimHistory( void );
+
+	// About how many bytes the whole history takes up:
+	size_t getMemorySize( void ) const { return historySize; };
+
+private:
+	static size_t getMemorySize( wxCommand* command );
+
+	// Take a command that is about to be deleted out of the total:
+	void forget( wxCommand* command );
+
+	// Called before the oldest command is dropped:
+	void droppingOldest( wxList::compatibility_iterator oldest );
+
+	// The size of each command in the history, as it was last measured:
+	std::unordered_map< wxCommand*, size_t > commandSizes;
+	size_t historySize;
+
+	bool savedStateDropped;
+};
+
+#endif /*KLSCOMMANDPROCESSOR_H_*/
@@ -16,6 +16,7 @@ class klsGLCanvas;
 #include "MainApp.h"
 #include "wx/glcanvas.h"
 #include "klsMiniMap.h"
+#include "klsImageWriter.h"
 // For GLPoint2f:
 
 // Included for floor() method:
@@ -48,6 +49,9 @@ using namespace std;
 #define SCROLL_TIMER_RATE 30
 #define SCROLL_TIMER_ID 1
 
+// The largest tile rendered at once when rendering an image (in pixels).
+#define EXPORT_TILE_SIZE 512
+
 #define GRID_INTENSITY 0.08
 #define MIN_GRID_SCREEN_SPACING 13
 
@@ -75,6 +79,11 @@ public:
 	// Print the canvas contents to a bitmap:
 	wxImage renderToImage( unsigned long width, unsigned long height, unsigned long colorDepth = 32, bool noColor = false );
 
+	// Render the canvas contents as an image of the given size, one tile
+	// at a time, handing each band of tiles to the writer as it is done:
+	// (Only a band of EXPORT_TILE_SIZE rows is ever held in memory.)
+	bool renderTiled( klsImageWriter& out, unsigned long width, unsigned long height, bool noColor = false );
+
 	//TODO: Add some scrollbars and some methods for setting the usable canvas size.
 
 	// Handle events from wxWidgets:
@@ -184,6 +193,10 @@ public:
 	// Retrieves the current viewport (left/top and right/bottom)
 	void getViewport(GLPoint2f&, GLPoint2f&);
 
+	// Retrieves the part of the viewport being rendered right now. This is
+	// the whole viewport, except while rendering one tile of an image:
+	void getRenderArea(GLPoint2f&, GLPoint2f&);
+
 	// map a point in surface local coordinates to coordinates on the canvas
 	GLPoint2f mapToCanvas(wxPoint m);
 
@@ -222,6 +235,10 @@ private:
 	// Zoom and OpenGL coordinate of upper-left corner of this canvas:
 	GLdouble viewZoom;
 	GLdouble panX, panY;
+
+	// The tile being rendered by renderTiled(), if any:
+	bool renderingTile;
+	GLPoint2f tileTopLeft, tileBottomRight;
 	
 	// Scrolling timer used to auto-scroll the canvas when dragged outside of the
 	// window:
@@ -0,0 +1,54 @@
+/*****************************************************************************
+   Project: CEDAR Logic Simulator
+   Copyright 2006 Cedarville University, Benjamin Sprague,
+                     Matt Lewellyn, and David Knierim
+   All rights reserved.
+   For license information see license.txt included with distribution.
+
+   klsImageWriter: Receives an image a band of rows at a time
+*****************************************************************************/
+
+#ifndef KLSIMAGEWRITER_H_
+#define KLSIMAGEWRITER_H_
+
+#include "wx/image.h"
+#include "wx/string.h"
+
+// Takes the rows of an image from top to bottom as packed 24-bit RGB, so
+// that an image can be written out without ever being whole in memory.
+class klsImageWriter {
+public:
+	virtual ~klsImageWriter() {};
+
+	// Start an image of the given size. Returns false on failure:
+	virtual bool begin( unsigned long width, unsigned long height ) = 0;
+
+	// Add the next rows of the image. Returns false on failure:
+	virtual bool writeRows( const unsigned char* rgb, unsigned long rows ) = 0;
+
+	// Finish the image after its last row. Returns false on failure:
+	virtual bool finish( void ) = 0;
+
+	// Make a writer that streams the rows into an image file. Returns NULL
+	// for types that can't be written a row at a time:
+	// (The caller owns the writer.)
+	static klsImageWriter* create( const wxString& path, wxBitmapType fileType );
+};
+
+// Collects the rows into a wxImage in memory:
+class klsMemoryImageWriter : public klsImageWriter {
+public:
+	klsMemoryImageWriter() : nextRow(0) {};
+
+	bool begin( unsigned long width, unsigned long height );
+	bool writeRows( const unsigned char* rgb, unsigned long rows );
+	bool finish( void );
+
+	wxImage getImage( void ) { return image; };
+
+private:
+	wxImage image;
+	unsigned long nextRow;
+};
+
+#endif /*KLSIMAGEWRITER_H_*/
@@ -0,0 +1,43 @@
+/*****************************************************************************
+   Project: CEDAR Logic Simulator
+   Copyright 2006 Cedarville University, Benjamin Sprague,
+                     Matt Lewellyn, and David Knierim
+   All rights reserved.
+   For license information see license.txt included with distribution.
+
+   klsLibraryCache: Binary cache of a parsed gate library
+*****************************************************************************/
+
+#ifndef KLSLIBRARYCACHE_H_
+#define KLSLIBRARYCACHE_H_
+
+#include <map>
+#include <string>
+using namespace std;
+
+#include "LibraryParse.h"
+
+// The layout of the cache file. Bump this whenever LibraryGate (or the
+// way the library is parsed) changes, so old caches are ignored:
+#define LIBRARY_CACHE_VERSION 1
+
+// Saves the gates parsed from a library file so that later launches can
+// load them with one read instead of parsing the XML again. A cache only
+// loads if it was made from library text with the same hash.
+class klsLibraryCache {
+public:
+	// Hash the text of a library file (64-bit FNV-1a):
+	static unsigned long long hashText( const string& text );
+
+	// Load the gates (and the name of the last library) from a cache file.
+	// Returns false if the file is missing, from another version or
+	// library, or damaged:
+	static bool load( const string& cacheFile, unsigned long long textHash,
+		string& libName, map < string, map < string, LibraryGate > >& gates );
+
+	// Write the gates out to a cache file. Returns false on failure:
+	static bool save( const string& cacheFile, unsigned long long textHash,
+		const string& libName, const map < string, map < string, LibraryGate > >& gates );
+};
+
+#endif /*KLSLIBRARYCACHE_H_*/
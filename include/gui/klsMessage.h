@@ -3,6 +3,7 @@
 
 #include <string>
 #include <sstream>
+#include "logic_stats.h"
 
 // ALL inter-thread message structures defined here
 namespace klsMessage {
@@ -47,7 +48,10 @@ namespace klsMessage {
 	class Message_DONESTEP {
 	public:
 		int logicTime;
-		Message_DONESTEP( int lt ) : logicTime(lt) {};
+		// The logic core's counters, sent only now and then (NULL otherwise):
+		CircuitStats *stats;
+		Message_DONESTEP( int lt, CircuitStats *st = NULL ) : logicTime(lt), stats(st) {};
+		~Message_DONESTEP() { delete stats; };
 	};
 
 	// no parameters for COMPLETE_INTERIM_STEP
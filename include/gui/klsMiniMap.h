@@ -18,6 +18,7 @@ class klsMiniMap;
 #include "wx/bitmap.h"
 #include "wx/dcmemory.h"
 #include "klsGLCanvas.h"
+#include "klsBBox.h"
 #include <unordered_map>
 using namespace std;
 
@@ -30,11 +31,13 @@ public:
         const wxPoint& pos = wxDefaultPosition,
         const wxSize& size = wxDefaultSize,
         long style = 0, const wxString& name = "klsMiniMap");
+	// (The page texture is freed along with the shared GL context.)
 	virtual ~klsMiniMap() { return; };
 	
 	void setLists( unordered_map< unsigned long, guiGate* >* gateList, unordered_map< unsigned long, guiWire* >* wireList ) {
 		this->gateList = gateList;
 		this->wireList = wireList;
+		pageValid = false;
 	};
 	
 	void update(GLPoint2f origin = GLPoint2f(0,0), GLPoint2f endpoint = GLPoint2f(0,0));
@@ -43,9 +46,39 @@ public:
 	void OnMouseEvent(wxMouseEvent& evt);
 	
 private:
-	void setViewport();
+	// Pick the area of the page to show, and set up the projection for it.
+	// Returns true if the area is different from the last call:
+	bool setViewport();
 	void generateImage();
-	void renderMap();
+
+	// Draw the gates and wires that overlap the box (or all of them if the
+	// box is empty):
+	void renderMap( klsBBox region );
+
+	// Draw the canvas' viewport rectangle over the map:
+	void renderViewportRect();
+
+	// Compare the gates' and wires' bboxes and shape revisions with the
+	// ones from the last render, and return the area that has changed:
+	klsBBox findChangedRegion();
+
+	// An object's bbox and shape revision as of the last render:
+	struct renderedObject {
+		klsBBox box;
+		unsigned long revision;
+	};
+
+	// Add the old and new bboxes of an object to the changed region if it
+	// moved or changed since the last render, and record it in newRendered:
+	template< class T >
+	static void checkObject( T* obj, unordered_map< T*, renderedObject >& rendered,
+		unordered_map< T*, renderedObject >& newRendered, klsBBox& changed );
+
+	// Copy the rendered page (or a part of it, in pixels) into pageTexture:
+	void copyToTexture( int x, int y, int width, int height );
+
+	// Draw pageTexture over the whole window:
+	void drawPageTexture();
 	
 	// viewport rect
 	GLPoint2f origin, endpoint;
@@ -55,6 +88,20 @@ private:
 	
 	wxImage mapImage;
 
+	// The rendered page is kept in a texture, so that panning only redraws
+	// the viewport rectangle and edits only redraw the area they touch:
+	GLuint pageTexture;
+	int textureWidth, textureHeight; // Power-of-two texture size
+	int imageWidth, imageHeight; // Size of the page image in the texture
+	bool pageValid;
+
+	// The area of the page that the map shows:
+	GLPoint2f pageTL, pageBR;
+
+	// Gates and wires as of the last render:
+	unordered_map< guiGate*, renderedObject > renderedGates;
+	unordered_map< guiWire*, renderedObject > renderedWires;
+
 	klsGLCanvas* currentCanvas;	
 	
 	GLPoint2f minCorner, maxCorner;
@@ -0,0 +1,51 @@
+/*****************************************************************************
+   Project: CEDAR Logic Simulator
+   Copyright 2006 Cedarville University, Benjamin Sprague,
+                     Matt Lewellyn, and David Knierim
+   All rights reserved.
+   For license information see license.txt included with distribution.
+
+   klsPrefixTrie: Finds the names that start with what has been typed
+*****************************************************************************/
+
+#ifndef KLSPREFIXTRIE_H_
+#define KLSPREFIXTRIE_H_
+
+#include <map>
+#include <string>
+#include <vector>
+using namespace std;
+
+// Files names letter by letter, so that every name starting with a prefix
+// is found by walking the prefix rather than comparing against each name.
+// Names are matched without regard to case. Each name carries a value (such
+// as its index in a list), and a value may be filed under several names.
+class klsPrefixTrie {
+public:
+	klsPrefixTrie();
+
+	void clear( void );
+
+	// File a value under a name:
+	void insert( const string& name, size_t value );
+
+	// Add the values filed under every name that starts with the prefix
+	// to found. (An empty prefix finds everything.) A value filed under
+	// more than one matching name is only added once:
+	void find( const string& prefix, vector< size_t >& found ) const;
+
+	// Lowercase a name the same way the trie does:
+	static string fold( const string& name );
+
+private:
+	struct trieNode {
+		map< char, size_t > children;
+		vector< size_t > values;
+	};
+
+	// The nodes, with the root first. Children are found by index so that
+	// the nodes can live in one vector:
+	vector< trieNode > nodes;
+};
+
+#endif /*KLSPREFIXTRIE_H_*/
@@ -0,0 +1,52 @@
+/*****************************************************************************
+   Project: CEDAR Logic Simulator
+   Copyright 2006 Cedarville University, Benjamin Sprague,
+                     Matt Lewellyn, and David Knierim
+   All rights reserved.
+   For license information see license.txt included with distribution.
+
+   klsSegmentDelta: The change between two shapes of a wire
+*****************************************************************************/
+
+#ifndef KLSSEGMENTDELTA_H_
+#define KLSSEGMENTDELTA_H_
+
+#include <map>
+#include <vector>
+using namespace std;
+
+#include "wireSegment.h"
+
+// Holds a wire's new shape as a change to its old shape, so that undo
+// history doesn't need two full segment maps per wire. A shape that is
+// the old one shifted over is kept as just the shift; otherwise only the
+// segments that were added or changed, and the ids of removed ones, are
+// kept.
+class klsSegmentDelta {
+public:
+	klsSegmentDelta();
+
+	klsSegmentDelta( const map < long, wireSegment >& oldMap, const map < long, wireSegment >& newMap );
+
+	// Rebuild the new shape from the old one:
+	map < long, wireSegment > apply( const map < long, wireSegment >& oldMap ) const;
+
+	// About how many bytes the delta takes up:
+	size_t getMemorySize( void ) const;
+
+	// About how many bytes a segment map takes up:
+	static size_t getMemorySize( const map < long, wireSegment >& segMap );
+
+private:
+	// Is b the same as a shifted by (dx, dy)?
+	static bool sameSegment( const wireSegment& a, const wireSegment& b, GLfloat dx, GLfloat dy );
+
+	static wireSegment shiftSegment( const wireSegment& seg, GLfloat dx, GLfloat dy );
+
+	bool isShift;
+	GLPoint2f shift;
+	map < long, wireSegment > changed;
+	vector < long > removed;
+};
+
+#endif /*KLSSEGMENTDELTA_H_*/
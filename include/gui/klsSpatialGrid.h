@@ -0,0 +1,85 @@
+/*****************************************************************************
+   Project: CEDAR Logic Simulator
+   Copyright 2006 Cedarville University, Benjamin Sprague,
+                     Matt Lewellyn, and David Knierim
+   All rights reserved.
+   For license information see license.txt included with distribution.
+
+   klsSpatialGrid: Uniform grid of collision objects for area queries
+*****************************************************************************/
+
+#ifndef KLSSPATIALGRID_H_
+#define KLSSPATIALGRID_H_
+
+#include <unordered_map>
+#include <vector>
+#include <set>
+using namespace std;
+
+#include "klsBBox.h"
+
+class klsCollisionObject;
+typedef set< klsCollisionObject* > CollisionGroup;
+
+// The width and height of a grid cell, in world units:
+// (A typical gate covers one to four cells.)
+#define SPATIAL_GRID_CELL_SIZE 8.0
+
+// Objects that would cover more cells than this are kept in a separate
+// list that every query checks, rather than being filed in every cell:
+#define SPATIAL_GRID_MAX_CELLS 1024
+
+// Files collision objects into the cells of a uniform grid by their
+// bounding boxes, so that the objects near a point or inside a box can be
+// found without looking at every object on the page.
+class klsSpatialGrid {
+public:
+	klsSpatialGrid( GLfloat cellSize = SPATIAL_GRID_CELL_SIZE );
+
+	// File an object under its current bounding box. If the object is
+	// already in the grid, it is moved to the cells of its new bbox:
+	void update( klsCollisionObject* obj );
+
+	// Take an object out of the grid:
+	void remove( klsCollisionObject* obj );
+
+	void clear( void );
+
+	// Add the objects whose bounding boxes overlap the box (or contain the
+	// point) to the found group:
+	void query( klsBBox box, CollisionGroup& found );
+	void query( GLPoint2f pt, CollisionGroup& found );
+
+	// The number of objects in the grid:
+	size_t size( void ) const { return filed.size(); };
+
+private:
+	// An inclusive range of cell coordinates:
+	struct cellRange {
+		long left, bottom, right, top;
+
+		bool empty( void ) const { return left > right || bottom > top; };
+		unsigned long long count( void ) const;
+		bool operator==( const cellRange& other ) const;
+	};
+
+	cellRange getCells( klsBBox box );
+
+	static unsigned long long cellKey( long x, long y );
+
+	void fileObject( klsCollisionObject* obj, const cellRange& cells );
+	void unfileObject( klsCollisionObject* obj, const cellRange& cells );
+
+	GLfloat cellSize;
+
+	// The objects in each occupied cell:
+	unordered_map< unsigned long long, vector< klsCollisionObject* > > cells;
+
+	// Objects too big to file by cell:
+	CollisionGroup oversized;
+
+	// The cells that each object is filed under:
+	unordered_map< klsCollisionObject*, cellRange > filed;
+};
+
+#endif /*KLSSPATIALGRID_H_*/
@@ -0,0 +1,55 @@
+/*****************************************************************************
+   Project: CEDAR Logic Simulator
+   Copyright 2006 Cedarville University, Benjamin Sprague,
+                     Matt Lewellyn, and David Knierim
+   All rights reserved.
+   For license information see license.txt included with distribution.
+
+   klsThumbnailAtlas: One image holding the palette pictures of every gate
+*****************************************************************************/
+
+#ifndef KLSTHUMBNAILATLAS_H_
+#define KLSTHUMBNAILATLAS_H_
+
+#include "wx/bitmap.h"
+#include "wx/gdicmn.h"
+#include "wx/window.h"
+#include <map>
+#include <string>
+#include "klsBBox.h"
+
+using namespace std;
+
+// The number of thumbnails in each row of the atlas:
+#define ATLAS_COLUMNS 16
+
+// Renders a thumbnail of every gate in the libraries into the cells of a
+// single offscreen image, in one pass with one GL context, so that each
+// palette entry only has to copy its cell out of the shared bitmap.
+class klsThumbnailAtlas {
+public:
+	klsThumbnailAtlas() { return; };
+
+	// Render the thumbnails, unless that was already done:
+	// (The window is only needed to set up the offscreen GL context.)
+	void build( wxWindow* parent );
+
+	// Throw the thumbnails away, so the next build() renders them again:
+	// (MainFrame calls this when it loads the gate library.)
+	void clear( void );
+
+	// Where a gate's thumbnail is in the atlas, or an empty rect if the
+	// gate has none:
+	wxRect getRect( const string& gateName ) const;
+
+	const wxBitmap& getBitmap( void ) const { return atlas; };
+
+private:
+	// Set up the projection to fit a gate's bbox into a square cell:
+	static void setProjection( klsBBox gateBox );
+
+	wxBitmap atlas;
+	map < string, wxRect > cells;
+};
+
+#endif /*KLSTHUMBNAILATLAS_H_*/
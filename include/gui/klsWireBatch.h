@@ -0,0 +1,101 @@
+/*****************************************************************************
+   Project: CEDAR Logic Simulator
+   Copyright 2006 Cedarville University, Benjamin Sprague,
+                     Matt Lewellyn, and David Knierim
+   All rights reserved.
+   For license information see license.txt included with distribution.
+
+   klsWireBatch: Retained vertex arrays for drawing a page's wires at once
+*****************************************************************************/
+
+#ifndef KLSWIREBATCH_H_
+#define KLSWIREBATCH_H_
+
+#include <vector>
+#include "gl_wrapper.h"
+
+using namespace std;
+
+class guiWire;
+
+// Holds the geometry and colors of the visible wires on a page in a few
+// vertex arrays, so that they are drawn with a handful of glDrawArrays()
+// calls. The arrays are only rebuilt when a wire changes shape or selection,
+// or when the set of wires to draw changes. When a wire only changes state
+// (as they do on every step of a running simulation), just its colors are
+// rewritten.
+class klsWireBatch {
+public:
+	klsWireBatch();
+
+	// Rebuild the arrays on the next draw:
+	// (Call this when wires are added to or removed from the page.)
+	void invalidate( void ) { valid = false; };
+
+	// Draw the wires in the list, rebuilding the arrays first if anything
+	// has changed. When drawing in color, selected wires are left out so
+	// the caller can draw them with their dotted pattern. Without detail,
+	// only the lines are drawn (no connection dots or bus end caps).
+	void draw( const vector< guiWire* >& wires, bool color, bool detail = true );
+
+private:
+	// Positions (x, y) and colors (r, g, b, a) of a set of vertices:
+	struct vertexArray {
+		vector< GLfloat > points;
+		vector< GLfloat > colors;
+
+		void clear( void );
+		void add( GLfloat x, GLfloat y, const GLfloat rgba[4] );
+		void draw( GLenum mode );
+
+		// The number of vertices:
+		size_t size( void ) const { return points.size() / 2; };
+
+		// Change the color of a run of vertices:
+		void setColor( size_t first, size_t count, const GLfloat rgba[4] );
+	};
+
+	// A run of vertices in one of the arrays:
+	struct vertexRange {
+		size_t first, count;
+	};
+
+	// Where a wire's vertices are in the arrays, and the revisions of the
+	// wire that they were built from:
+	struct wireRecord {
+		guiWire* wire;
+		unsigned long shapeRevision;
+		unsigned long stateRevision;
+		vertexRange lines;       // In wireLines or busLines
+		vertexRange caps;        // In busCaps
+		vertexRange dots;        // In connectDots
+	};
+
+	void rebuild( const vector< guiWire* >& wires, bool color );
+
+	// Check the wires against their records. Returns false if any of them
+	// changed shape (so the arrays must be rebuilt); otherwise rewrites the
+	// colors of the wires that changed state:
+	bool updateColors( bool color );
+
+	// Add a wire's lines, bus end caps, and dots to the arrays:
+	void addWire( guiWire* wire, bool isBus, bool connVisible, bool color );
+
+	// Add a filled connection dot to the dot array:
+	void addConnectDot( GLfloat x, GLfloat y, const GLfloat rgba[4] );
+
+	vertexArray wireLines;   // Single wires
+	vertexArray busLines;    // Bus wires (drawn wider)
+	vertexArray busCaps;     // Points that round off the bus wire ends
+	vertexArray connectDots; // Connection and intersection dots
+
+	// What the arrays were built from:
+	bool valid;
+	vector< wireRecord > records;
+	vector< guiWire* > builtWires;
+	bool builtColor;
+	bool builtConnVisible;
+	float builtConnRadius;
+};
+
+#endif /*KLSWIREBATCH_H_*/
@@ -16,6 +16,7 @@
 #include <fstream>
 
 class GUICanvas;
+class svgWriter;
 
 class SVGExporter {
 public:
@@ -31,9 +32,9 @@ public:
 
 private:
     // Helper functions for SVG generation
-    static std::string getSVGHeader(float width, float height, float viewX, float viewY,
-                                   float viewWidth, float viewHeight);
-    static std::string getSVGFooter();
+    static void writeSVGHeader(svgWriter& out, float width, float height, float viewX, float viewY,
+                               float viewWidth, float viewHeight);
+    static void writeSVGFooter(svgWriter& out);
     static std::string getWireColorSVG(int state, bool noColor);
     static std::string escapeXML(const std::string& str);
 };
@@ -14,6 +14,7 @@
 #include "wx/wxprec.h"
 #include "wx/wx.h"
 #include "wx/thread.h"
+#include "wx/stopwatch.h"
 #include "klsMessage.h"
 #include "logic_values.h"
 #include <fstream>
@@ -42,9 +43,21 @@ public:
     void sendMessage(klsMessage::Message message);
     
 private:
+	// Sample how busy each gate and wire is for the activity heat map:
+	void sampleActivity();
+
 	Circuit* cir;
 	map < IDType, IDType >* logicIDs;
 	ofstream logfile;
+
+	// The counts at the last activity sample, and the time since then:
+	map < IDType, unsigned long long > lastGateEvaluations;
+	map < IDType, unsigned long long > lastWireToggles;
+	wxStopWatch activityTimer;
+	bool activitySampled;
+
+	// The time since the performance counters were last sent:
+	wxStopWatch statsTimer;
 };
 
 #endif /*THREADLOGIC_H_*/
@@ -18,6 +18,8 @@
 #include "logic_wire.h"
 #include "logic_gate.h"
 #include "logic_junction.h"
+#include "logic_snapshot.h"
+#include "logic_stats.h"
 
 #include<queue>
 #include<functional>  // KAS 2016
@@ -63,7 +65,40 @@ public:
 	// Step the simulation forward by one timestep:
 	// If a pointer to a set is passed, then it will
 	// return a set of all the changed wires to the calling function.
-	void step(  ID_SET< IDType > *changedWires = NULL );
+	// Returns true when the timestep is complete. If an event budget is set
+	// and more events than that are due, step() returns false after handling
+	// a batch of them, without finishing the timestep or reporting any changed
+	// wires yet. Calling step() again carries on where it left off.
+	bool step(  ID_SET< IDType > *changedWires = NULL );
+
+	// Set the number of events handled per call to step(), as a hint for
+	// callers that want to time-slice very busy timesteps (0 = no limit,
+	// which is the default). No events are ever dropped either way.
+	void setEventBudget( unsigned long budget );
+	unsigned long getEventBudget();
+
+	// The number of timesteps that had more events than the event budget,
+	// and how many events they had past the budget in total:
+	unsigned long long getOverflowSteps();
+	unsigned long long getOverflowEvents();
+
+	// Get the performance counters that have built up since the circuit
+	// was created or resetStats() was last called:
+	CircuitStats getStats();
+	void resetStats();
+
+	// The number of times a gate has been updated, to help find the gates
+	// that cost the most to simulate:
+	unsigned long long getGateEvaluations( IDType gateID );
+
+	// The number of times a wire has changed state:
+	unsigned long long getWireToggles( IDType wireID );
+
+	// The per-gate update and per-wire toggle counts, for sampling the
+	// activity of the whole circuit at once:
+	// (Gates and wires that haven't done anything are left out.)
+	const ID_MAP< IDType, unsigned long long >* getGateEvaluationCounts();
+	const ID_MAP< IDType, unsigned long long >* getWireToggleCounts();
 	
 	// Create a new gate, and return its ID:
 	// NOTE: There should also be some way to pass
@@ -114,6 +149,17 @@ public:
 
 	// Create Junction Event and put it in the event queue:
 	void createJunctionEvent( TimeType eventTime, IDType juncID, bool newState );
+
+	// Choose how a new event on a gate output treats the events for that
+	// output that are still pending:
+	// With transport delays (the default), pending events at or after the
+	// new event's time are cancelled, since the new event supersedes them.
+	// With inertial delays, all of the pending events are cancelled, and the
+	// new event is dropped if it doesn't change the state the wire is already
+	// being driven with. This swallows pulses that are shorter than the gate
+	// delay, like glitches in a combinational cone.
+	void setInertialDelays( bool inertial );
+	bool getInertialDelays();
 	
 	// Clear out the event queue, destroying all events,
 	// and also erase all events in the gateUpdateList and wireUpdateList.
@@ -122,6 +168,18 @@ public:
 	// from the outside world reaches them.
 	void destroyAllEvents( );
 
+	// Capture the dynamic state of the simulation (wire and junction states,
+	// pending events, gate internal state such as register values and RAM
+	// contents, and the system time) as a compact binary blob.
+	string saveSimulationState();
+
+	// Restore a blob made by saveSimulationState() in place. The circuit must
+	// still have the same gates, wires and junctions as when it was saved;
+	// if it doesn't, false is returned and the circuit is left as it was.
+	// If a pointer to a set is passed, it is filled with every restored wire,
+	// the same way that step() reports its changed wires.
+	bool restoreSimulationState( const string &snapshot, ID_SET< IDType > *restoredWires = NULL );
+
 	// Set a gate parameter:
 	// (If the gate's parameter change requires the gate to be
 	// re-evaluated during the next cycle, then add it to the update list.)
@@ -171,6 +229,24 @@ protected:
 	JUNC_PTR getJunction(IDType theJunc);
 
 private:
+	// Apply a snapshot to the circuit. Returns false if it doesn't
+	// match the circuit, in which case it may have been partly applied.
+	bool applySimulationState( const string &snapshot );
+
+	// Cancel the pending events of a gate output that happen at or
+	// after fromTime:
+	void cancelOutputEvents( IDType gateID, const string &gateOutputID, TimeType fromTime = 0 );
+
+	// Stop tracking an event that has been taken off of the event queue.
+	// Returns false if the event was cancelled and should be ignored.
+	bool retireEvent( const Event &theEvent );
+
+	// Push an event onto the event queue, keeping count of it:
+	void queueEvent( const Event &theEvent );
+
+	// Update a gate, keeping count of it:
+	void evaluateGate( IDType gateID );
+
 	// All the gates in the circuit, and the ID counter:
 	ID_MAP< IDType, GATE_PTR > gateList;
 	IDType gateIDCount;
@@ -204,10 +280,38 @@ private:
 
 	// This is the event queue for the Circuit:
 	priority_queue< Event, vector< Event >, greater< Event > > eventQueue;
+
+	// The events in the queue that are still pending for each gate output,
+	// as a map of event creation time to event time:
+	ID_MAP< pair< IDType, string >, ID_MAP< TimeType, TimeType > > pendingOutputEvents;
+
+	// The creation times of the events in the queue that have been cancelled.
+	// (They are left in the queue and skipped when they come off of it.)
+	ID_SET< TimeType > cancelledEvents;
+
+	// Whether new events cancel pending events with inertial delay semantics:
+	bool inertialDelays;
 	
 	// This is the current system time:
 	TimeType systemTime;
 
+	// The number of events that step() may handle per call (0 = no limit):
+	unsigned long eventBudget;
+
+	// True while step() is part of the way through a timestep because it ran
+	// out of event budget, along with the progress that it has made so far:
+	bool stepInProgress;
+	unsigned long stepEventCount;
+	ID_SET< IDType > stepChangedWires;
+
+	// The performance counters, along with the logic type and number of
+	// updates of each gate (which are added into the counters when asked for),
+	// and the number of state changes of each wire:
+	CircuitStats stats;
+	ID_MAP< IDType, string > gateTypes;
+	ID_MAP< IDType, unsigned long long > gateEvaluations;
+	ID_MAP< IDType, unsigned long long > wireToggles;
+
 	vector < changedParam > paramUpdateList;
 };
 
@@ -12,6 +12,7 @@
 #include "logic_defaults.h"
 #include "logic_event.h"
 #include "logic_wire.h"
+#include "logic_snapshot.h"
 
 class Circuit;
 
@@ -63,6 +64,17 @@ public:
 	// Get the value of a gate parameter:
 	virtual string getParameter( string paramName );
 
+	// Save and restore the gate's dynamic simulation state (the last events
+	// sent on its outputs, edge history, and any internal memory) for
+	// Circuit snapshots. Gates with internal state extend these.
+	// (Parameters set from the outside are not part of the snapshot.)
+	virtual void saveState( SnapshotWriter &out );
+	virtual void loadState( SnapshotReader &in );
+
+	// Call loadState() with the circuit pointer set, so that the parameters
+	// the gate restores are listed in the Circuit for the GUI right away:
+	void restoreState( IDType myID, Circuit * theCircuit, SnapshotReader &in );
+
 	// ********* Standard Gate mutator functions ************
 
 	// Connect a wire to the input of this gate:
@@ -374,6 +386,10 @@ public:
 	// Get the parameters:
 	string getParameter( string paramName );
 
+	// Save and restore the internal state:
+	void saveState( SnapshotWriter &out );
+	void loadState( SnapshotReader &in );
+
 protected:
 	bool syncSet, syncClear, syncLoad, disableHold, unknownOutputs;
 
@@ -410,6 +426,10 @@ public:
 	// Get the clock rate:
 	string getParameter( string paramName );
 
+	// Save and restore the internal state:
+	void saveState( SnapshotWriter &out );
+	void loadState( SnapshotReader &in );
+
 private:
 	TimeType halfCycle;
 	StateType theState;
@@ -428,6 +448,10 @@ public:
 
 	// Set the pulse:
 	bool setParameter( string paramName, string value );
+
+	// Save and restore the internal state:
+	void saveState( SnapshotWriter &out );
+	void loadState( SnapshotReader &in );
 private:
 	TimeType pulseRemaining;
 };
@@ -565,6 +589,10 @@ public:
 	// Get the parameters:
 	string getParameter( string paramName );
 
+	// Save and restore the internal state:
+	void saveState( SnapshotWriter &out );
+	void loadState( SnapshotReader &in );
+
 protected:
 	StateType currentState;
 	bool syncSet, syncClear;
@@ -587,6 +615,10 @@ public:
 	// Get the parameters:
 	string getParameter( string paramName );
 
+	// Save and restore the internal state:
+	void saveState( SnapshotWriter &out );
+	void loadState( SnapshotReader &in );
+
 	// Write a file containing the memory data:
 	void outputMemoryFile( string fName );
 
@@ -605,6 +637,9 @@ public:
 //End of edit**************************************
 
 protected:
+	// List the whole memory as changed, for the GUI:
+	void listMemoryContents( void );
+
 	unsigned long dataBits;
 	unsigned long addressBits;
 
@@ -689,6 +724,10 @@ public:
 	// Handle gate events:
 	void gateProcess( void );
 
+	// Save and restore the internal state:
+	void saveState( SnapshotWriter &out );
+	void loadState( SnapshotReader &in );
+
 	// Connect a wire to the input of this gate:
 	void connectInput( string inputID, IDType wireID );
 
@@ -0,0 +1,60 @@
+/*****************************************************************************
+   Project: CEDAR Logic Simulator
+   Copyright 2006 Cedarville University, Benjamin Sprague,
+                     Matt Lewellyn, and David Knierim
+   All rights reserved.
+   For license information see license.txt included with distribution.
+
+   logic_snapshot: Compact binary encoding for Circuit state snapshots
+*****************************************************************************/
+
+#ifndef LOGIC_SNAPSHOT_H_
+#define LOGIC_SNAPSHOT_H_
+
+#include "logic_defaults.h"
+
+// Appends values to a binary snapshot blob.
+// Integers are stored as variable-length (7 bits per byte) values, so the
+// small IDs and states that make up most of a circuit take a single byte.
+class SnapshotWriter
+{
+public:
+	void writeULong( unsigned long long value );
+	void writeBool( bool value ) { writeULong( value ? 1 : 0 ); };
+	void writeState( StateType value ) { writeULong( value ); };
+	void writeString( const string &value );
+
+	// Get the blob that has been written so far:
+	const string &getData() const { return data; };
+
+private:
+	string data;
+};
+
+// Reads values back out of a blob made by SnapshotWriter.
+// Reading past the end of the blob (or reading a malformed value) returns
+// zero values and marks the reader as failed, so callers can read a whole
+// record and check good() once afterwards.
+class SnapshotReader
+{
+public:
+	SnapshotReader( const string &newData ) : data(newData), position(0), failed(false) {}
+
+	unsigned long long readULong();
+	bool readBool() { return readULong() != 0; };
+	StateType readState() { return (StateType) readULong(); };
+	string readString();
+
+	// True if every read so far has succeeded:
+	bool good() const { return !failed; };
+
+	// True if the whole blob has been read:
+	bool atEnd() const { return position == data.size(); };
+
+private:
+	const string &data;
+	size_t position;
+	bool failed;
+};
+
+#endif /*LOGIC_SNAPSHOT_H_*/
@@ -0,0 +1,64 @@
+/*****************************************************************************
+   Project: CEDAR Logic Simulator
+   Copyright 2006 Cedarville University, Benjamin Sprague,
+                     Matt Lewellyn, and David Knierim
+   All rights reserved.
+   For license information see license.txt included with distribution.
+
+   logic_stats: Counters describing the work done by a Circuit
+*****************************************************************************/
+
+#ifndef LOGIC_STATS_H_
+#define LOGIC_STATS_H_
+
+#include <map>
+#include <string>
+
+// Running totals kept by Circuit while it simulates. They are cheap enough to
+// leave on all the time, and are read with Circuit::getStats().
+struct CircuitStats
+{
+	CircuitStats() : steps(0), eventsScheduled(0), eventsProcessed(0), eventsDropped(0),
+		queueHighWater(0), wireGroupsResolved(0), wiresResolved(0), largestWireGroup(0), wireToggles(0),
+		gatesEvaluated(0), overflowSteps(0), overflowEvents(0),
+		gateQueueSeconds(0), eventSeconds(0), wireSeconds(0), gateSeconds(0) {}
+
+	// Timesteps completed:
+	unsigned long long steps;
+
+	// Events put on the queue, events that happened, and events that were
+	// cancelled or swallowed before they could happen:
+	unsigned long long eventsScheduled;
+	unsigned long long eventsProcessed;
+	unsigned long long eventsDropped;
+
+	// The deepest that the event queue has been:
+	unsigned long long queueHighWater;
+
+	// Wire groups (wires joined by junctions) that had their state
+	// calculated, the wires in them, and the biggest group seen:
+	unsigned long long wireGroupsResolved;
+	unsigned long long wiresResolved;
+	unsigned long long largestWireGroup;
+
+	// Wire state changes:
+	unsigned long long wireToggles;
+
+	// Gate updates, in total and by logic type:
+	unsigned long long gatesEvaluated;
+	std::map< std::string, unsigned long long > gatesEvaluatedByType;
+
+	// Timesteps that had more events than the event budget, and how many
+	// events they had past the budget:
+	unsigned long long overflowSteps;
+	unsigned long long overflowEvents;
+
+	// Seconds spent in each phase of Circuit::step():
+	// (Polled and waiting gates, events, wire states, and gate updates.)
+	double gateQueueSeconds;
+	double eventSeconds;
+	double wireSeconds;
+	double gateSeconds;
+};
+
+#endif /*LOGIC_STATS_H_*/
@@ -15,6 +15,7 @@
 #include <algorithm>
 #include <stack>
 #include <iterator>
+#include <chrono>
 
 #ifndef _PRODUCTION_
 ofstream* logiclog;
@@ -31,6 +32,14 @@ Circuit::Circuit()
 	gateIDCount = 0;
 	wireIDCount = 0;
 	juncIDCount = 0;
+
+	// Events follow transport delays unless asked otherwise:
+	inertialDelays = false;
+
+	// Steps always finish unless an event budget is set:
+	eventBudget = 0;
+	stepInProgress = false;
+	stepEventCount = 0;
 	
 #ifndef _PRODUCTION_
 	logiclog = new ofstream( "corelog.log");
@@ -63,76 +72,100 @@ void Circuit::stepOnlyGates(){
 	// recalculate correctly:
 	ID_SET< IDType >::iterator updateGate = gateUpdateList.begin();
 	while( updateGate != gateUpdateList.end() ) {
-		gateList[*updateGate]->updateGate( *updateGate, this );
+		evaluateGate( *updateGate );
 		updateGate++;
 	}
 	gateUpdateList.clear();
 }
 //End of Edit*****************************
 
+// Add the time since lastTime to one of the step phase timers, and start
+// timing the next phase:
+static void addPhaseTime( double &phaseSeconds, chrono::steady_clock::time_point &lastTime ) {
+	chrono::steady_clock::time_point now = chrono::steady_clock::now();
+	phaseSeconds += chrono::duration< double >( now - lastTime ).count();
+	lastTime = now;
+}
 
-void Circuit::step(ID_SET< IDType > *changedWires)
+
+bool Circuit::step(ID_SET< IDType > *changedWires)
 {
-	// NOTE: Should activate the polled gates here:
-	// Basically just loop through the things in polledGates and call updateGate() on them.
-	ID_SET< IDType >::iterator gateToPoll = polledGates.begin();
-	while (gateToPoll != polledGates.end()) {
-		gateList[*gateToPoll]->updateGate(*gateToPoll, this);
-		gateToPoll++;
-	}
+	chrono::steady_clock::time_point phaseStart = chrono::steady_clock::now();
+
+	// If the last call ran out of event budget, then pick up where it left
+	// off. Otherwise, start a new timestep:
+	if (!stepInProgress) {
+		// NOTE: Should activate the polled gates here:
+		// Basically just loop through the things in polledGates and call updateGate() on them.
+		ID_SET< IDType >::iterator gateToPoll = polledGates.begin();
+		while (gateToPoll != polledGates.end()) {
+			evaluateGate(*gateToPoll);
+			gateToPoll++;
+		}
+
+		stepOnlyGates();
+		addPhaseTime(stats.gateQueueSeconds, phaseStart);
 
-	stepOnlyGates();
+		stepInProgress = true;
+		stepEventCount = 0;
+	}
 
-	int processedEvents = 0;
-	static const int MAX_EVENTS_PER_STEP = 10000;
+	// Handle all of the events for this timestep, in batches of the event budget:
+	unsigned long batchEvents = 0;
 	Event myEvent;
 	if (!eventQueue.empty()) myEvent = eventQueue.top();
-	while (!eventQueue.empty() && (myEvent.eventTime <= systemTime)
-	       && processedEvents < MAX_EVENTS_PER_STEP) {
+	while (!eventQueue.empty() && (myEvent.eventTime <= systemTime)) {
+		// Hand control back to the caller once the budget is used up:
+		if (eventBudget != 0 && batchEvents >= eventBudget) {
+			addPhaseTime(stats.eventSeconds, phaseStart);
+			return false;
+		}
+
 		// Pop the event off of the event queue:
 		eventQueue.pop();
 
-		// If the event is a junction event, handle it as a junction:
-		if (myEvent.isJunctionEvent) {
-			// Handle the junction event:
-			setJunctionState(myEvent.junctionID, myEvent.newJunctionState);
+		// Events that were superseded by a later event are skipped:
+		if (retireEvent(myEvent)) {
+			// If the event is a junction event, handle it as a junction:
+			if (myEvent.isJunctionEvent) {
+				// Handle the junction event:
+				setJunctionState(myEvent.junctionID, myEvent.newJunctionState);
+
+				// Also adds all of the wires hooked up to this junction to
+				// the "wireUpdateList" list.
+				// (Handled inside of a setJunctionState() method, to allow
+				// it to be called from outside of an event handle - for zero delay.)
+			}
+			else {
+				// Else, make the event happen to the wire:
+				WIRE_PTR myWire = wireList[myEvent.wireID];
+				myWire->setInputState(myEvent.gateID, myEvent.gateOutputID, myEvent.newState);
+
+				// Insert all attached wires into the changed wires list:
+				set< IDType > wireGroup = getJunctionGroupIDs(myEvent.wireID);
+				stepChangedWires.insert(wireGroup.begin(), wireGroup.end());
+			}
 
-			// Also adds all of the wires hooked up to this junction to
-			// the "wireUpdateList" list.
-			// (Handled inside of a setJunctionState() method, to allow
-			// it to be called from outside of an event handle - for zero delay.)
-		}
-		else {
-			// Else, make the event happen to the wire:
-			WIRE_PTR myWire = wireList[myEvent.wireID];
-			myWire->setInputState(myEvent.gateID, myEvent.gateOutputID, myEvent.newState);
-
-			// Insert all attached wires into the changed wires list:
-			set< IDType > wireGroup = getJunctionGroupIDs(myEvent.wireID);
-			changedWires->insert(wireGroup.begin(), wireGroup.end());
+			batchEvents++;
+			stepEventCount++;
+			stats.eventsProcessed++;
 		}
 
 		// Look at the next thing in the list:
 		if (!eventQueue.empty()) myEvent = eventQueue.top();
-
-		processedEvents++;
 	}
 
-	// If we hit the event limit, drain remaining events at this timestep
-	// to prevent unbounded accumulation across steps.
-	if (processedEvents >= MAX_EVENTS_PER_STEP) {
-		while (!eventQueue.empty()) {
-			Event staleEvent = eventQueue.top();
-			if (staleEvent.eventTime > systemTime) break;
-			eventQueue.pop();
-		}
+	// Keep count of the timesteps that needed more than one batch:
+	if (eventBudget != 0 && stepEventCount > eventBudget) {
+		stats.overflowSteps++;
+		stats.overflowEvents += stepEventCount - eventBudget;
 	}
 
 	// Insert the wires that have been disconnected (or were part of a junction that changed) within
 	// the last call to step() so that they will be properly updated:
-	changedWires->insert(wireUpdateList.begin(), wireUpdateList.end());
+	stepChangedWires.insert(wireUpdateList.begin(), wireUpdateList.end());
 	wireUpdateList.clear();	// Empty the wireUpdateList, since we are handling the updates.
-
+	addPhaseTime(stats.eventSeconds, phaseStart);
 
 	// Calculate the new wire states, and make a list of affected gates:
 	ID_SET< IDType > changedGates;
@@ -141,8 +174,8 @@ void Circuit::step(ID_SET< IDType > *changedWires)
 	// This keeps track of wires that share junctions that have already
 	// calculated their state:
 	ID_SET< IDType > doneWires;
-	ID_SET< IDType >::iterator chgWireIterator = changedWires->begin();
-	while (chgWireIterator != changedWires->end()) {
+	ID_SET< IDType >::iterator chgWireIterator = stepChangedWires.begin();
+	while (chgWireIterator != stepChangedWires.end()) {
 		WIRE_PTR myWire = wireList[*chgWireIterator];
 
 		// Calculate the new state of a wire:
@@ -150,15 +183,27 @@ void Circuit::step(ID_SET< IDType > *changedWires)
 		if (doneWires.find(*chgWireIterator) == doneWires.end()) {
 			set< IDType > wireGroupIDs = getJunctionGroupIDs(*chgWireIterator);
 			set< WIRE_PTR > wireGroup = getJunctionGroup(&wireGroupIDs);
+			StateType oldState = myWire->getState();
 			StateType juncState = myWire->calculateState(wireGroup);
 
-			set< WIRE_PTR >::iterator wgWire = wireGroup.begin();
-			while (wgWire != wireGroup.end()) {
-				(*wgWire)->forceState(juncState);
+			// Set the state of each wire in the group, counting the ones that toggled:
+			set< IDType >::iterator wgWire = wireGroupIDs.begin();
+			while (wgWire != wireGroupIDs.end()) {
+				WIRE_PTR groupWire = wireList[*wgWire];
+				StateType lastState = (groupWire == myWire) ? oldState : groupWire->getState();
+				if (lastState != juncState) {
+					wireToggles[*wgWire]++;
+					stats.wireToggles++;
+				}
+				groupWire->forceState(juncState);
 				wgWire++;
 			}
 
 			doneWires.insert(wireGroupIDs.begin(), wireGroupIDs.end());
+
+			stats.wireGroupsResolved++;
+			stats.wiresResolved += wireGroup.size();
+			stats.largestWireGroup = max< unsigned long long >(stats.largestWireGroup, wireGroup.size());
 		}
 
 		// Add this wire's gates to the overall gate list:
@@ -170,6 +215,7 @@ void Circuit::step(ID_SET< IDType > *changedWires)
 		// Move on to the next wire in the list:
 		chgWireIterator++;
 	}
+	addPhaseTime(stats.wireSeconds, phaseStart);
 
 	// Update the gate's states and post the events from the gates:
 	ID_SET< IDType >::iterator changedGatesIterator = changedGates.begin();
@@ -177,16 +223,90 @@ void Circuit::step(ID_SET< IDType > *changedWires)
 
 	// Update all of the gates and retrieve the events from them:
 	while (changedGatesIterator != changedGates.end()) {
-		GATE_PTR myGate = gateList[*changedGatesIterator];
-
-		myGate->updateGate(*changedGatesIterator, this);
+		evaluateGate(*changedGatesIterator);
 
 		changedGatesIterator++;
 	}
+	addPhaseTime(stats.gateSeconds, phaseStart);
+
+	// Hand the changed wires to the caller:
+	if (changedWires != NULL) {
+		changedWires->insert(stepChangedWires.begin(), stepChangedWires.end());
+	}
+	stepChangedWires.clear();
+	stepInProgress = false;
 
 	// Increment the system timer, because this timestep is complete:
 	systemTime++;
+	stats.steps++;
+
+	return true;
+}
+
+void Circuit::setEventBudget( unsigned long budget ) {
+	eventBudget = budget;
+}
+
+unsigned long Circuit::getEventBudget( void ) {
+	return eventBudget;
+}
 
+unsigned long long Circuit::getOverflowSteps( void ) {
+	return stats.overflowSteps;
+}
+
+unsigned long long Circuit::getOverflowEvents( void ) {
+	return stats.overflowEvents;
+}
+
+CircuitStats Circuit::getStats( void ) {
+	CircuitStats currentStats = stats;
+
+	// Add in the updates of the gates that are still in the circuit:
+	// (Deleted gates were added in when they were deleted.)
+	ID_MAP< IDType, unsigned long long >::iterator thisGate = gateEvaluations.begin();
+	while( thisGate != gateEvaluations.end() ) {
+		currentStats.gatesEvaluatedByType[ gateTypes[thisGate->first] ] += thisGate->second;
+		thisGate++;
+	}
+	return currentStats;
+}
+
+void Circuit::resetStats( void ) {
+	stats = CircuitStats();
+	stats.queueHighWater = eventQueue.size();
+	gateEvaluations.clear();
+	wireToggles.clear();
+}
+
+unsigned long long Circuit::getGateEvaluations( IDType gateID ) {
+	ID_MAP< IDType, unsigned long long >::iterator thisGate = gateEvaluations.find( gateID );
+	return ( thisGate == gateEvaluations.end() ) ? 0 : thisGate->second;
+}
+
+unsigned long long Circuit::getWireToggles( IDType wireID ) {
+	ID_MAP< IDType, unsigned long long >::iterator thisWire = wireToggles.find( wireID );
+	return ( thisWire == wireToggles.end() ) ? 0 : thisWire->second;
+}
+
+const ID_MAP< IDType, unsigned long long >* Circuit::getGateEvaluationCounts( void ) {
+	return &gateEvaluations;
+}
+
+const ID_MAP< IDType, unsigned long long >* Circuit::getWireToggleCounts( void ) {
+	return &wireToggles;
+}
+
+void Circuit::evaluateGate( IDType gateID ) {
+	gateEvaluations[gateID]++;
+	stats.gatesEvaluated++;
+	gateList[gateID]->updateGate( gateID, this );
+}
+
+void Circuit::queueEvent( const Event &theEvent ) {
+	eventQueue.push( theEvent );
+	stats.eventsScheduled++;
+	stats.queueHighWater = max< unsigned long long >( stats.queueHighWater, eventQueue.size() );
 }
 
 IDType Circuit::newGate(const string &type, IDType gateID ) {
@@ -256,6 +376,9 @@ IDType Circuit::newGate(const string &type, IDType gateID ) {
 		} else {
 			WARNING( "Circuit::newGate() - Invalid logic type!" );
 		}
+		if( gateList.find( thisGateID ) != gateList.end() ) {
+			gateTypes[thisGateID] = type;
+		}
 
 	} else {
 		WARNING( "Circuit::newGate() - Re-used gate ID!" );
@@ -336,6 +459,11 @@ void Circuit::deleteGate( IDType theGate ) {
 		disconnectGateOutput( theGate, myGate->getFirstConnectedOutput() );
 	}
 	
+	// Keep the gate's updates in the totals for its type:
+	stats.gatesEvaluatedByType[ gateTypes[theGate] ] += getGateEvaluations( theGate );
+	gateEvaluations.erase( theGate );
+	gateTypes.erase( theGate );
+
 	// Remove the gate from the circuit:
 	gateList.erase( theGate );
 	if ( polledGates.find( theGate ) != polledGates.end() ) polledGates.erase( theGate );
@@ -379,6 +507,7 @@ void Circuit::deleteWire( IDType theWire ) {
 
 	// Remove the wire from the circuit:
 	wireList.erase( theWire );
+	wireToggles.erase( theWire );
 }
 
 void Circuit::deleteJunction( IDType theJunc ) {
@@ -406,6 +535,8 @@ void Circuit::deleteJunction( IDType theJunc ) {
 		Event tempEvent = eventQueue.top();
 		if( !((tempEvent.isJunctionEvent) && (tempEvent.junctionID == theJunc)) ) {
 			tempEventStack.push( tempEvent );
+		} else {
+			stats.eventsDropped++;
 		}
 		eventQueue.pop();
 	}
@@ -517,22 +648,7 @@ void Circuit::disconnectGateOutput( IDType gateID, const string &gateOutputID )
 
 	// You also have to clear the event queue of any events scheduled for this
 	// gate/gateOutput combination.
-	
-	// Empty the priority queue into a temporary stack, filtering out outdated events:
-	stack< Event > tempEventStack;
-	while( !eventQueue.empty() ) {
-		Event tempEvent = eventQueue.top();
-		if( !((!tempEvent.isJunctionEvent) && (tempEvent.gateID == gateID) && (tempEvent.gateOutputID == gateOutputID)) ) {
-			tempEventStack.push( tempEvent );
-		}
-		eventQueue.pop();
-	}
-	
-	// Push the stack back into the event queue:
-	while( !tempEventStack.empty() ) {
-		eventQueue.push( tempEventStack.top() );
-		tempEventStack.pop();
-	}
+	cancelOutputEvents( gateID, gateOutputID );
 
 	return;
 }
@@ -595,8 +711,29 @@ void Circuit::createEvent( TimeType eventTime, IDType wireID, IDType gateID, con
 	oss << "Creating event for gate " << gateID << " output " << gateOutputID << " to state " << (int) newState << " at time = " << eventTime << "." << endl;
 	WARNING(oss.str());
 
-	// Push the event onto the event queue:
-	eventQueue.push(myEvent);
+	if( inertialDelays ) {
+		// Cancel everything that is still pending on this output:
+		cancelOutputEvents( gateID, gateOutputID );
+
+		// If the wire is already being driven with the new state, then the
+		// cancelled events were a pulse shorter than the delay and the new
+		// event doesn't need to happen either:
+		if( wireList.find( wireID ) != wireList.end() ) {
+			ID_SET< WireInput > &inputs = wireList[wireID]->inputList;
+			ID_SET< WireInput >::iterator theInput = inputs.find( WireInput( gateID, gateOutputID ) );
+			if( theInput != inputs.end() && theInput->inputState == newState ) {
+				stats.eventsDropped++;
+				return;
+			}
+		}
+	} else {
+		// The new event supersedes any events at or after its own time:
+		cancelOutputEvents( gateID, gateOutputID, eventTime );
+	}
+
+	// Track the event as pending on this output, and push it onto the event queue:
+	pendingOutputEvents[ make_pair( gateID, gateOutputID ) ][ myEvent.getCreationTime() ] = eventTime;
+	queueEvent(myEvent);
 }
 
 TimeType Circuit::createDelayedEvent( TimeType delay, IDType wireID, IDType gateID, const string &gateOutputID, StateType newState ) {
@@ -614,19 +751,288 @@ void Circuit::createJunctionEvent( TimeType eventTime, IDType juncID, bool newSt
 	myEvent.junctionID = juncID;
 
 	// Push the event onto the event queue:
-	eventQueue.push(myEvent);
+	queueEvent(myEvent);
 }
 
 void Circuit::destroyAllEvents( void ) {
 
+	stats.eventsDropped += eventQueue.size() - cancelledEvents.size();
 	while( !eventQueue.empty() ) {
 		eventQueue.pop();
 	}
+	pendingOutputEvents.clear();
+	cancelledEvents.clear();
 
 	gateUpdateList.clear();
 	wireUpdateList.clear();
 }
 
+void Circuit::setInertialDelays( bool inertial ) {
+	inertialDelays = inertial;
+}
+
+bool Circuit::getInertialDelays( void ) {
+	return inertialDelays;
+}
+
+void Circuit::cancelOutputEvents( IDType gateID, const string &gateOutputID, TimeType fromTime ) {
+	ID_MAP< pair< IDType, string >, ID_MAP< TimeType, TimeType > >::iterator pending = pendingOutputEvents.find( make_pair( gateID, gateOutputID ) );
+	if( pending == pendingOutputEvents.end() ) return;
+
+	// Mark the events as cancelled, so that step() will skip them:
+	ID_MAP< TimeType, TimeType >::iterator thisEvent = (pending->second).begin();
+	while( thisEvent != (pending->second).end() ) {
+		if( thisEvent->second >= fromTime ) {
+			cancelledEvents.insert( thisEvent->first );
+			(pending->second).erase( thisEvent++ );
+			stats.eventsDropped++;
+		} else {
+			thisEvent++;
+		}
+	}
+
+	if( (pending->second).empty() ) {
+		pendingOutputEvents.erase( pending );
+	}
+}
+
+bool Circuit::retireEvent( const Event &theEvent ) {
+	if( cancelledEvents.erase( theEvent.getCreationTime() ) > 0 ) {
+		return false;
+	}
+
+	// Junction events aren't tracked per output:
+	if( !theEvent.isJunctionEvent ) {
+		ID_MAP< pair< IDType, string >, ID_MAP< TimeType, TimeType > >::iterator pending = pendingOutputEvents.find( make_pair( theEvent.gateID, theEvent.gateOutputID ) );
+		if( pending != pendingOutputEvents.end() ) {
+			(pending->second).erase( theEvent.getCreationTime() );
+			if( (pending->second).empty() ) {
+				pendingOutputEvents.erase( pending );
+			}
+		}
+	}
+	return true;
+}
+
+// Snapshot format identification:
+static const string SNAPSHOT_MAGIC = "CLSS";
+static const unsigned long long SNAPSHOT_VERSION = 2;
+
+string Circuit::saveSimulationState( void ) {
+	SnapshotWriter out;
+	out.writeString( SNAPSHOT_MAGIC );
+	out.writeULong( SNAPSHOT_VERSION );
+	out.writeULong( systemTime );
+
+	// The wires, along with the states being driven on each of their inputs:
+	out.writeULong( wireList.size() );
+	ID_MAP< IDType, WIRE_PTR >::iterator thisWire = wireList.begin();
+	while( thisWire != wireList.end() ) {
+		out.writeULong( thisWire->first );
+		out.writeState( thisWire->second->wireState );
+		ID_SET< WireInput > &inputs = thisWire->second->inputList;
+		out.writeULong( inputs.size() );
+		ID_SET< WireInput >::iterator thisInput = inputs.begin();
+		while( thisInput != inputs.end() ) {
+			out.writeULong( thisInput->gateID );
+			out.writeString( thisInput->gateOutputID );
+			out.writeState( thisInput->inputState );
+			thisInput++;
+		}
+		thisWire++;
+	}
+
+	// The junction on/off states:
+	out.writeULong( juncList.size() );
+	ID_MAP< IDType, JUNC_PTR >::iterator thisJunc = juncList.begin();
+	while( thisJunc != juncList.end() ) {
+		out.writeULong( thisJunc->first );
+		out.writeBool( thisJunc->second->getEnableState() );
+		thisJunc++;
+	}
+
+	// The gates' internal states:
+	out.writeULong( gateList.size() );
+	ID_MAP< IDType, GATE_PTR >::iterator thisGate = gateList.begin();
+	while( thisGate != gateList.end() ) {
+		out.writeULong( thisGate->first );
+		thisGate->second->saveState( out );
+		thisGate++;
+	}
+
+	// The pending events, in the order that they will happen:
+	// (Walk a copy of the queue so that the real one isn't disturbed.)
+	// (Cancelled events are left out.)
+	priority_queue< Event, vector< Event >, greater< Event > > pendingEvents = eventQueue;
+	out.writeULong( pendingEvents.size() - cancelledEvents.size() );
+	while( !pendingEvents.empty() ) {
+		const Event &thisEvent = pendingEvents.top();
+		if( cancelledEvents.find( thisEvent.getCreationTime() ) != cancelledEvents.end() ) {
+			pendingEvents.pop();
+			continue;
+		}
+		out.writeBool( thisEvent.isJunctionEvent );
+		out.writeBool( thisEvent.newJunctionState );
+		out.writeULong( thisEvent.junctionID );
+		out.writeState( thisEvent.newState );
+		out.writeULong( thisEvent.eventTime );
+		out.writeULong( thisEvent.wireID );
+		out.writeULong( thisEvent.gateID );
+		out.writeString( thisEvent.gateOutputID );
+		pendingEvents.pop();
+	}
+
+	// The gates and wires that are waiting to be updated on the next step:
+	out.writeULong( gateUpdateList.size() );
+	ID_SET< IDType >::iterator updateID = gateUpdateList.begin();
+	while( updateID != gateUpdateList.end() ) {
+		out.writeULong( *updateID );
+		updateID++;
+	}
+	out.writeULong( wireUpdateList.size() );
+	updateID = wireUpdateList.begin();
+	while( updateID != wireUpdateList.end() ) {
+		out.writeULong( *updateID );
+		updateID++;
+	}
+
+	// A timestep that step() is part of the way through:
+	out.writeBool( stepInProgress );
+	out.writeULong( stepEventCount );
+	out.writeULong( stepChangedWires.size() );
+	updateID = stepChangedWires.begin();
+	while( updateID != stepChangedWires.end() ) {
+		out.writeULong( *updateID );
+		updateID++;
+	}
+
+	return out.getData();
+}
+
+bool Circuit::restoreSimulationState( const string &snapshot, ID_SET< IDType > *restoredWires ) {
+	// Keep the current state around in case the snapshot turns out not to
+	// match this circuit part of the way through:
+	string currentState = saveSimulationState();
+
+	// Parameters reported before the restore no longer apply. (This is
+	// done first, so the gates can list the parameters they restore.)
+	paramUpdateList.clear();
+	if( !applySimulationState( snapshot ) ) {
+		WARNING("Circuit::restoreSimulationState() - Snapshot doesn't match the circuit.");
+		applySimulationState( currentState );
+		return false;
+	}
+
+	if( restoredWires != NULL ) {
+		ID_MAP< IDType, WIRE_PTR >::iterator thisWire = wireList.begin();
+		while( thisWire != wireList.end() ) {
+			restoredWires->insert( thisWire->first );
+			thisWire++;
+		}
+	}
+	return true;
+}
+
+bool Circuit::applySimulationState( const string &snapshot ) {
+	SnapshotReader in( snapshot );
+	if( in.readString() != SNAPSHOT_MAGIC || in.readULong() != SNAPSHOT_VERSION ) {
+		return false;
+	}
+	TimeType newSystemTime = in.readULong();
+
+	// Everything must exist before anything is changed, so check the
+	// counts first. (Each ID is still checked as it is read.)
+	if( in.readULong() != wireList.size() ) return false;
+	for( unsigned long i = 0; i < wireList.size(); i++ ) {
+		IDType wireID = in.readULong();
+		StateType wireState = in.readState();
+		if( !in.good() || wireList.find( wireID ) == wireList.end() ) return false;
+		WIRE_PTR myWire = wireList[wireID];
+		myWire->forceState( wireState );
+
+		unsigned long long numInputs = in.readULong();
+		if( numInputs != myWire->inputList.size() ) return false;
+		for( unsigned long long j = 0; j < numInputs; j++ ) {
+			IDType gateID = in.readULong();
+			string gateOutputID = in.readString();
+			StateType inputState = in.readState();
+			WireInput theInput( gateID, gateOutputID, inputState );
+			if( !in.good() || myWire->inputList.find( theInput ) == myWire->inputList.end() ) return false;
+			myWire->inputList.erase( theInput );
+			myWire->inputList.insert( theInput );
+		}
+	}
+
+	if( in.readULong() != juncList.size() ) return false;
+	for( unsigned long i = 0; i < juncList.size(); i++ ) {
+		IDType juncID = in.readULong();
+		bool enabled = in.readBool();
+		if( !in.good() || juncList.find( juncID ) == juncList.end() ) return false;
+		juncList[juncID]->setEnableState( enabled );
+	}
+
+	if( in.readULong() != gateList.size() ) return false;
+	for( unsigned long i = 0; i < gateList.size(); i++ ) {
+		IDType gateID = in.readULong();
+		if( !in.good() || gateList.find( gateID ) == gateList.end() ) return false;
+		gateList[gateID]->restoreState( gateID, this, in );
+	}
+
+	// Replace the pending events:
+	// (They are saved in the order that they happen, so re-creating them
+	// in that order keeps events at the same time in the same order.)
+	priority_queue< Event, vector< Event >, greater< Event > > newEventQueue;
+	ID_MAP< pair< IDType, string >, ID_MAP< TimeType, TimeType > > newPendingOutputEvents;
+	unsigned long long numEvents = in.readULong();
+	for( unsigned long long i = 0; i < numEvents && in.good(); i++ ) {
+		Event myEvent;
+		myEvent.isJunctionEvent = in.readBool();
+		myEvent.newJunctionState = in.readBool();
+		myEvent.junctionID = in.readULong();
+		myEvent.newState = in.readState();
+		myEvent.eventTime = in.readULong();
+		myEvent.wireID = in.readULong();
+		myEvent.gateID = in.readULong();
+		myEvent.gateOutputID = in.readString();
+		if( !myEvent.isJunctionEvent ) {
+			newPendingOutputEvents[ make_pair( myEvent.gateID, myEvent.gateOutputID ) ][ myEvent.getCreationTime() ] = myEvent.eventTime;
+		}
+		newEventQueue.push( myEvent );
+	}
+
+	ID_SET< IDType > newGateUpdateList;
+	unsigned long long numUpdates = in.readULong();
+	for( unsigned long long i = 0; i < numUpdates && in.good(); i++ ) {
+		newGateUpdateList.insert( in.readULong() );
+	}
+	ID_SET< IDType > newWireUpdateList;
+	numUpdates = in.readULong();
+	for( unsigned long long i = 0; i < numUpdates && in.good(); i++ ) {
+		newWireUpdateList.insert( in.readULong() );
+	}
+
+	bool newStepInProgress = in.readBool();
+	unsigned long newStepEventCount = (unsigned long) in.readULong();
+	ID_SET< IDType > newStepChangedWires;
+	numUpdates = in.readULong();
+	for( unsigned long long i = 0; i < numUpdates && in.good(); i++ ) {
+		newStepChangedWires.insert( in.readULong() );
+	}
+
+	if( !in.good() || !in.atEnd() ) return false;
+
+	eventQueue = newEventQueue;
+	pendingOutputEvents = newPendingOutputEvents;
+	cancelledEvents.clear();
+	gateUpdateList = newGateUpdateList;
+	wireUpdateList = newWireUpdateList;
+	stepInProgress = newStepInProgress;
+	stepEventCount = newStepEventCount;
+	stepChangedWires = newStepChangedWires;
+	systemTime = newSystemTime;
+	return true;
+}
+
 void Circuit::setGateParameter( IDType gateID, const string &paramName, const string &value ) {
 	if( gateList.find( gateID ) != gateList.end() ) {
 		if( gateList[gateID]->setParameter( paramName, value ) ) {
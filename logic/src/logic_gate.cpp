@@ -271,6 +271,71 @@ string Gate::getParameter( string paramName ) {
 }
 
 
+// Save the gate's dynamic simulation state:
+void Gate::saveState( SnapshotWriter &out ) {
+	// The last events sent on each output, so that duplicate events are
+	// still suppressed (and resendLastEvent() still works) after a restore:
+	out.writeULong( outputList.size() );
+	ID_MAP< string, GateOutput >::iterator theOutput = outputList.begin();
+	while( theOutput != outputList.end() ) {
+		out.writeString( theOutput->first );
+		out.writeState( (theOutput->second).lastEventState );
+		out.writeULong( (theOutput->second).lastEventTime );
+		theOutput++;
+	}
+
+	// The edge history of the edge-triggered inputs:
+	out.writeULong( edgeTriggeredLastState.size() );
+	ID_MAP< string, StateType >::iterator lastState = edgeTriggeredLastState.begin();
+	while( lastState != edgeTriggeredLastState.end() ) {
+		out.writeString( lastState->first );
+		out.writeState( lastState->second );
+		lastState++;
+	}
+}
+
+
+// Restore the state saved by saveState():
+void Gate::loadState( SnapshotReader &in ) {
+	unsigned long long numOutputs = in.readULong();
+	for( unsigned long long i = 0; i < numOutputs && in.good(); i++ ) {
+		string outputID = in.readString();
+		StateType lastEventState = in.readState();
+		TimeType lastEventTime = in.readULong();
+		if( outputList.find( outputID ) != outputList.end() ) {
+			outputList[outputID].lastEventState = lastEventState;
+			outputList[outputID].lastEventTime = lastEventTime;
+		}
+	}
+
+	// (An input that has no entry hasn't been simulated yet, so the
+	// old entries must be cleared rather than merged.)
+	edgeTriggeredLastState.clear();
+	unsigned long long numEdges = in.readULong();
+	for( unsigned long long i = 0; i < numEdges && in.good(); i++ ) {
+		string inputID = in.readString();
+		edgeTriggeredLastState[inputID] = in.readState();
+	}
+}
+
+
+// Restore the state with the circuit pointer set, like updateGate():
+void Gate::restoreState( IDType myID, Circuit * theCircuit, SnapshotReader &in ) {
+	ourCircuit = theCircuit;
+	this->myID = myID;
+
+	for( vector<string>::iterator I = changedParamWaitingList.begin();
+	    	I != changedParamWaitingList.end(); ++I ){
+		listChangedParam( *I );
+	}
+	changedParamWaitingList.clear();
+
+	this->loadState( in );
+
+	ourCircuit = NULL;
+}
+
+
 // ******************** Gate Subclass Use Methods **********************************
 // These are used by the subclassed gate types to define what interface and
 // process each gate posesses.
@@ -1130,6 +1195,25 @@ bool Gate_REGISTER::hasClockEdge(bool syncSignal) {
 	return isRisingEdge("clock") && getInputState("clock_enable") != ZERO || !syncSignal;
 }
 
+// Save and restore the internal state:
+void Gate_REGISTER::saveState( SnapshotWriter &out ) {
+	Gate_PASS::saveState( out );
+	out.writeULong( currentValue );
+	out.writeBool( unknownOutputs );
+	out.writeBool( firstGateProcess );
+}
+
+void Gate_REGISTER::loadState( SnapshotReader &in ) {
+	Gate_PASS::loadState( in );
+	currentValue = (unsigned long) in.readULong();
+	unknownOutputs = in.readBool();
+	firstGateProcess = in.readBool();
+
+	// Let the GUI know about the restored value:
+	listChangedParam( "CURRENT_VALUE" );
+	listChangedParam( "UNKNOWN_OUTPUTS" );
+}
+
 // **************************** END Register GATE ***********************************
 
 
@@ -1183,6 +1267,18 @@ string Gate_CLOCK::getParameter( string paramName ) {
 }
 
 
+// Save and restore the internal state:
+void Gate_CLOCK::saveState( SnapshotWriter &out ) {
+	Gate::saveState( out );
+	out.writeState( theState );
+}
+
+void Gate_CLOCK::loadState( SnapshotReader &in ) {
+	Gate::loadState( in );
+	theState = in.readState();
+}
+
+
 // **************************** END CLOCK GATE ***********************************
 
 
@@ -1225,6 +1321,18 @@ bool Gate_PULSE::setParameter( string paramName, string value ) {
 	}
 }
 
+
+// Save and restore the internal state:
+void Gate_PULSE::saveState( SnapshotWriter &out ) {
+	Gate::saveState( out );
+	out.writeULong( pulseRemaining );
+}
+
+void Gate_PULSE::loadState( SnapshotReader &in ) {
+	Gate::loadState( in );
+	pulseRemaining = in.readULong();
+}
+
 // **************************** END Pulse GATE ***********************************
 
 
@@ -1832,6 +1940,18 @@ string Gate_JKFF::getParameter( string paramName ) {
 }
 
 
+// Save and restore the internal state:
+void Gate_JKFF::saveState( SnapshotWriter &out ) {
+	Gate::saveState( out );
+	out.writeState( currentState );
+}
+
+void Gate_JKFF::loadState( SnapshotReader &in ) {
+	Gate::loadState( in );
+	currentState = in.readState();
+}
+
+
 // **************************** END JK Flip Flop GATE ***********************************
 
 
@@ -1872,14 +1992,7 @@ void Gate_RAM::gateProcess( void ) {
 //   data.  Thus instead a flag is set and we update the gui now
     if( flushGuiMemory ){
     	flushGuiMemory = false;
-		listChangedParam( "MemoryReset" );
-		for( map< unsigned long, unsigned long >::iterator I = memory.begin();
-		     I != memory.end();  ++I ){
-		    ostringstream virtualPropertyName;
-			virtualPropertyName << "Address:";
-			virtualPropertyName << I->first; //we just list the address
-			listChangedParam( virtualPropertyName.str() );
-		}
+		listMemoryContents();
     }
 //End of Edit************************************************************
 
@@ -2039,6 +2152,50 @@ string Gate_RAM::getParameter( string paramName ) {
 	}
 }
 
+// Save and restore the memory contents:
+void Gate_RAM::saveState( SnapshotWriter &out ) {
+	Gate::saveState( out );
+	out.writeULong( memory.size() );
+	map< unsigned long, unsigned long >::iterator memLoc = memory.begin();
+	while( memLoc != memory.end() ) {
+		out.writeULong( memLoc->first );
+		out.writeULong( memLoc->second );
+		memLoc++;
+	}
+	out.writeULong( lastRead );
+}
+
+void Gate_RAM::loadState( SnapshotReader &in ) {
+	Gate::loadState( in );
+	memory.clear();
+	unsigned long long numLocations = in.readULong();
+	for( unsigned long long i = 0; i < numLocations && in.good(); i++ ) {
+		unsigned long address = (unsigned long) in.readULong();
+		memory[address] = (unsigned long) in.readULong();
+	}
+	lastRead = (unsigned long) in.readULong();
+
+	// Let the GUI reset its copy of the memory, the same as loading a file.
+	// (This is listed now, rather than waiting for the next gateProcess,
+	// since the gate may not be processed again for a while.)
+	flushGuiMemory = false;
+	listMemoryContents();
+	listChangedParam( "lastRead" );
+}
+
+// List a memory reset and every stored address as changed parameters,
+// so the GUI can rebuild its copy of the memory:
+void Gate_RAM::listMemoryContents( void ) {
+	listChangedParam( "MemoryReset" );
+	for( map< unsigned long, unsigned long >::iterator I = memory.begin();
+	     I != memory.end();  ++I ){
+	    ostringstream virtualPropertyName;
+		virtualPropertyName << "Address:";
+		virtualPropertyName << I->first; //we just list the address
+		listChangedParam( virtualPropertyName.str() );
+	}
+}
+
 // Write a file containing the memory data:
 void Gate_RAM::outputMemoryFile( string fName ) {
 	ofstream oFile( fName.c_str() );
@@ -2481,6 +2638,19 @@ void Gate_T::gateProcess( void ) {
 }
 
 
+// Save and restore the internal state:
+// (The junction's own state is saved by the Circuit.)
+void Gate_T::saveState( SnapshotWriter &out ) {
+	Gate::saveState( out );
+	out.writeBool( juncLastState );
+}
+
+void Gate_T::loadState( SnapshotReader &in ) {
+	Gate::loadState( in );
+	juncLastState = in.readBool();
+}
+
+
 // Connect a wire to the input of this gate:
 void Gate_T::connectInput( string inputID, IDType wireID ) {
 	Gate::connectInput( inputID, wireID );
@@ -0,0 +1,56 @@
+/*****************************************************************************
+   Project: CEDAR Logic Simulator
+   Copyright 2006 Cedarville University, Benjamin Sprague,
+                     Matt Lewellyn, and David Knierim
+   All rights reserved.
+   For license information see license.txt included with distribution.
+
+   logic_snapshot: Compact binary encoding for Circuit state snapshots
+*****************************************************************************/
+
+#include "logic_snapshot.h"
+
+
+void SnapshotWriter::writeULong( unsigned long long value ) {
+	// Low 7 bits first, with the high bit set on every byte but the last:
+	while( value >= 0x80 ) {
+		data.push_back( (char)((value & 0x7F) | 0x80) );
+		value >>= 7;
+	}
+	data.push_back( (char)value );
+}
+
+void SnapshotWriter::writeString( const string &value ) {
+	writeULong( value.size() );
+	data.append( value );
+}
+
+
+unsigned long long SnapshotReader::readULong() {
+	unsigned long long value = 0;
+	unsigned int shift = 0;
+	while( !failed ) {
+		if( position >= data.size() || shift >= 64 ) {
+			failed = true;
+			break;
+		}
+		unsigned char byte = (unsigned char)data[position++];
+		value |= ((unsigned long long)(byte & 0x7F)) << shift;
+		if( !(byte & 0x80) ) {
+			return value;
+		}
+		shift += 7;
+	}
+	return 0;
+}
+
+string SnapshotReader::readString() {
+	unsigned long long length = readULong();
+	if( failed || length > data.size() - position ) {
+		failed = true;
+		return "";
+	}
+	string value = data.substr( position, (size_t)length );
+	position += (size_t)length;
+	return value;
+}
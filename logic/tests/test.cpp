@@ -1,7 +1,11 @@
 #include <catch2/catch_test_macros.hpp>
 #include "XMLParser.h"
+#include "klsLibraryCache.h"
+#include "klsPrefixTrie.h"
 #include <iostream>
 #include <sstream>
+#include <algorithm>
+#include <cstdio>
 #include "logic_gate.h"
 #include "logic_circuit.h"
 #include "logic_event.h"
@@ -449,3 +453,383 @@ TEST_CASE("XMLParser reading, [XMLParser]") {
         REQUIRE(parser.readCloseTag() == "final");
     }
 }
+
+TEST_CASE("Logic circuit snapshots, [LogicCircuit]") {
+
+    // A clock toggling a JK flip flop, with a driver holding J and K high:
+    Circuit cir;
+    IDType clk = cir.newGate("CLOCK");
+    cir.setGateParameter(clk, "HALF_CYCLE", "3");
+    IDType drv = cir.newGate("DRIVER");
+    cir.setGateParameter(drv, "OUTPUT_BITS", "1");
+    cir.setGateParameter(drv, "OUTPUT_NUM", "1");
+    IDType jkff = cir.newGate("JKFF");
+
+    // Unconnected gates whose state is shown in the GUI:
+    IDType reg = cir.newGate("REGISTER");
+    IDType ram = cir.newGate("RAM");
+
+    IDType clkWire = cir.newWire();
+    IDType jkWire = cir.newWire();
+    IDType qWire = cir.newWire();
+    cir.connectGateOutput(clk, "CLK", clkWire);
+    cir.connectGateOutput(drv, "OUT_0", jkWire);
+    cir.connectGateInput(jkff, "clock", clkWire);
+    cir.connectGateInput(jkff, "J", jkWire);
+    cir.connectGateInput(jkff, "K", jkWire);
+    cir.connectGateOutput(jkff, "Q", qWire);
+
+    auto run = [&cir, qWire](int numSteps) {
+        std::vector<StateType> trace;
+        for (int i = 0; i < numSteps; i++) {
+            ID_SET<IDType> changedWires;
+            cir.step(&changedWires);
+            trace.push_back(cir.getWireState(qWire));
+        }
+        return trace;
+    };
+
+    run(10);
+    std::string snapshot = cir.saveSimulationState();
+    TimeType snapshotTime = cir.getSystemTime();
+
+    SECTION("Restoring a snapshot replays the same simulation") {
+        auto firstRun = run(25);
+        REQUIRE(cir.getSystemTime() == snapshotTime + 25);
+
+        ID_SET<IDType> restoredWires;
+        REQUIRE(cir.restoreSimulationState(snapshot, &restoredWires));
+        REQUIRE(cir.getSystemTime() == snapshotTime);
+        REQUIRE(restoredWires.size() == 3);
+
+        auto secondRun = run(25);
+        REQUIRE(firstRun == secondRun);
+        REQUIRE(std::count(firstRun.begin(), firstRun.end(), ONE) > 0);
+        REQUIRE(std::count(firstRun.begin(), firstRun.end(), ZERO) > 0);
+    }
+
+    SECTION("Restoring a snapshot lists the restored parameters for the GUI") {
+        run(5);
+        cir.clearParamUpdateList();
+        REQUIRE(cir.restoreSimulationState(snapshot));
+
+        auto listed = [&cir](IDType gateID, const std::string &paramName) {
+            for (const changedParam &param : cir.getParamUpdateList()) {
+                if (param.gateID == gateID && param.paramName == paramName) return true;
+            }
+            return false;
+        };
+        REQUIRE(listed(reg, "CURRENT_VALUE"));
+        REQUIRE(listed(reg, "UNKNOWN_OUTPUTS"));
+        REQUIRE(listed(ram, "MemoryReset"));
+        REQUIRE(listed(ram, "lastRead"));
+    }
+
+    SECTION("Snapshots that don't match the circuit are rejected") {
+        run(5);
+        std::string current = cir.saveSimulationState();
+
+        REQUIRE_FALSE(cir.restoreSimulationState("not a snapshot"));
+        REQUIRE_FALSE(cir.restoreSimulationState(snapshot.substr(0, snapshot.size() / 2)));
+        REQUIRE(cir.saveSimulationState() == current);
+
+        cir.newWire();
+        REQUIRE_FALSE(cir.restoreSimulationState(snapshot));
+        REQUIRE(cir.getSystemTime() == snapshotTime + 5);
+    }
+}
+
+TEST_CASE("Logic circuit event cancellation, [LogicCircuit]") {
+
+    // A driver feeding a slow buffer, which is given a pulse that is
+    // shorter than the buffer's delay:
+    Circuit cir;
+    IDType drv = cir.newGate("DRIVER");
+    cir.setGateParameter(drv, "OUTPUT_BITS", "1");
+    IDType buf = cir.newGate("BUFFER");
+    cir.setGateParameter(buf, "DEFAULT_DELAY", "5");
+
+    IDType inWire = cir.newWire();
+    IDType outWire = cir.newWire();
+    cir.connectGateOutput(drv, "OUT_0", inWire);
+    cir.connectGateInput(buf, "IN_0", inWire);
+    cir.connectGateOutput(buf, "OUT_0", outWire);
+
+    auto pulse = [&cir, drv, outWire]() {
+        std::vector<StateType> trace;
+        auto step = [&]() {
+            ID_SET<IDType> changedWires;
+            cir.step(&changedWires);
+            trace.push_back(cir.getWireState(outWire));
+        };
+        for (int i = 0; i < 10; i++) step();
+        cir.setGateParameter(drv, "OUTPUT_NUM", "1");
+        for (int i = 0; i < 2; i++) step();
+        cir.setGateParameter(drv, "OUTPUT_NUM", "0");
+        for (int i = 0; i < 10; i++) step();
+        return trace;
+    };
+
+    SECTION("Transport delays pass short pulses through") {
+        REQUIRE_FALSE(cir.getInertialDelays());
+        auto trace = pulse();
+        REQUIRE(std::count(trace.begin(), trace.end(), ONE) == 2);
+        REQUIRE(trace.back() == ZERO);
+    }
+
+    SECTION("Inertial delays swallow pulses shorter than the gate delay") {
+        cir.setInertialDelays(true);
+        auto trace = pulse();
+        REQUIRE(std::count(trace.begin(), trace.end(), ONE) == 0);
+        REQUIRE(trace.back() == ZERO);
+    }
+}
+
+TEST_CASE("Logic circuit event budget, [LogicCircuit]") {
+
+    // A driver with eight outputs, so that changing its value puts eight
+    // events into a single timestep:
+    Circuit cir;
+    IDType drv = cir.newGate("DRIVER");
+    cir.setGateParameter(drv, "OUTPUT_BITS", "8");
+    std::vector<IDType> wires;
+    for (int i = 0; i < 8; i++) {
+        wires.push_back(cir.newWire());
+        cir.connectGateOutput(drv, "OUT_" + std::to_string(i), wires.back());
+    }
+    for (int i = 0; i < 3; i++) {
+        ID_SET<IDType> changedWires;
+        REQUIRE(cir.step(&changedWires));
+    }
+    REQUIRE(cir.getEventBudget() == 0);
+    REQUIRE(cir.getOverflowSteps() == 0);
+
+    cir.setEventBudget(3);
+    cir.setGateParameter(drv, "OUTPUT_NUM", "255");
+    ID_SET<IDType> changedWires;
+
+    SECTION("Busy timesteps are split into batches without dropping events") {
+        TimeType time = cir.getSystemTime();
+        int batches = 1;
+        while (!cir.step(&changedWires)) {
+            REQUIRE(cir.getSystemTime() == time);
+            REQUIRE(changedWires.empty());
+            batches++;
+        }
+        REQUIRE(batches == 3);
+        REQUIRE(cir.getSystemTime() == time + 1);
+        REQUIRE(changedWires.size() == 8);
+        for (IDType wire : wires) {
+            REQUIRE(cir.getWireState(wire) == ONE);
+        }
+        REQUIRE(cir.getOverflowSteps() == 1);
+        REQUIRE(cir.getOverflowEvents() == 5);
+    }
+
+    SECTION("Snapshots keep a partly finished timestep") {
+        REQUIRE_FALSE(cir.step(&changedWires));
+        std::string snapshot = cir.saveSimulationState();
+        while (!cir.step(&changedWires)) {}
+        REQUIRE(cir.restoreSimulationState(snapshot));
+        changedWires.clear();
+        while (!cir.step(&changedWires)) {}
+        REQUIRE(changedWires.size() == 8);
+        for (IDType wire : wires) {
+            REQUIRE(cir.getWireState(wire) == ONE);
+        }
+    }
+}
+
+TEST_CASE("Logic circuit performance counters, [LogicCircuit]") {
+
+    // A driver feeding an AND gate through a junction group of two wires:
+    Circuit cir;
+    IDType drv = cir.newGate("DRIVER");
+    cir.setGateParameter(drv, "OUTPUT_BITS", "1");
+    IDType andGate = cir.newGate("AND");
+    cir.setGateParameter(andGate, "INPUT_BITS", "2");
+    IDType inWire = cir.newWire();
+    IDType juncWire = cir.newWire();
+    IDType outWire = cir.newWire();
+    IDType junc = cir.newJunction();
+    cir.connectJunction(junc, inWire);
+    cir.connectJunction(junc, juncWire);
+    cir.setJunctionState(junc, true);
+    cir.connectGateOutput(drv, "OUT_0", inWire);
+    cir.connectGateInput(andGate, "IN_0", juncWire);
+    cir.connectGateInput(andGate, "IN_1", juncWire);
+    cir.connectGateOutput(andGate, "OUT", outWire);
+
+    auto run = [&cir](int steps) {
+        for (int i = 0; i < steps; i++) {
+            ID_SET<IDType> changedWires;
+            cir.step(&changedWires);
+        }
+    };
+    run(5);
+    cir.setGateParameter(drv, "OUTPUT_NUM", "1");
+    run(5);
+
+    CircuitStats stats = cir.getStats();
+    REQUIRE(stats.steps == 10);
+    REQUIRE(stats.eventsProcessed > 0);
+    REQUIRE(stats.eventsProcessed + stats.eventsDropped <= stats.eventsScheduled);
+    REQUIRE(stats.queueHighWater > 0);
+    REQUIRE(stats.largestWireGroup == 2);
+    REQUIRE(stats.wiresResolved >= stats.wireGroupsResolved);
+    REQUIRE(stats.gatesEvaluatedByType["AND"] == cir.getGateEvaluations(andGate));
+    REQUIRE(stats.gatesEvaluatedByType["AND"] > 0);
+    REQUIRE(stats.gatesEvaluatedByType["DRIVER"] > 0);
+    REQUIRE(stats.gatesEvaluated == stats.gatesEvaluatedByType["AND"] + stats.gatesEvaluatedByType["DRIVER"]);
+    REQUIRE(stats.eventSeconds >= 0);
+
+    SECTION("Deleted gates stay in the per-type totals") {
+        unsigned long long andEvaluations = stats.gatesEvaluatedByType["AND"];
+        cir.deleteGate(andGate);
+        REQUIRE(cir.getGateEvaluations(andGate) == 0);
+        REQUIRE(cir.getStats().gatesEvaluatedByType["AND"] == andEvaluations);
+    }
+
+    SECTION("Wire toggles are counted for every wire in a junction group") {
+        unsigned long long inToggles = cir.getWireToggles(inWire);
+        unsigned long long outToggles = cir.getWireToggles(outWire);
+        for (int i = 0; i < 3; i++) {
+            cir.setGateParameter(drv, "OUTPUT_NUM", (i % 2) ? "1" : "0");
+            run(5);
+        }
+        REQUIRE(cir.getWireToggles(inWire) == inToggles + 3);
+        REQUIRE(cir.getWireToggles(juncWire) == cir.getWireToggles(inWire));
+        REQUIRE(cir.getWireToggles(outWire) == outToggles + 3);
+        REQUIRE(cir.getStats().wireToggles > stats.wireToggles);
+        REQUIRE(cir.getWireToggleCounts()->size() == 3);
+    }
+
+    SECTION("Resetting clears the counters") {
+        cir.resetStats();
+        stats = cir.getStats();
+        REQUIRE(stats.steps == 0);
+        REQUIRE(stats.eventsScheduled == 0);
+        REQUIRE(stats.gatesEvaluated == 0);
+        REQUIRE(stats.gatesEvaluatedByType.empty());
+        REQUIRE(cir.getGateEvaluations(andGate) == 0);
+        REQUIRE(cir.getWireToggles(outWire) == 0);
+    }
+}
+
+TEST_CASE("Gate library cache, [LibraryCache]") {
+    std::map<std::string, std::map<std::string, LibraryGate>> gates;
+    LibraryGate andGate;
+    andGate.gateName = "AA_AND2";
+    andGate.caption = "AND Gate";
+    andGate.logicType = "AND";
+    andGate.hotspots.push_back(lgHotspot("IN_0", true, -2.5f, 0.5f, false, "", 1));
+    andGate.hotspots.push_back(lgHotspot("OUT", false, 2.5f, 0.0f, true, "ENABLE", 4));
+    andGate.shape.push_back(lgLine(-1.5f, 1.0f, 1.5f, -1.0f, true));
+    andGate.dlgParams.push_back(lgDlgParam("Delay", "DELAY", "INT", false, 0.0f, 100.0f));
+    andGate.guiParams["angle"] = "0.0";
+    andGate.logicParams["INPUT_BITS"] = "2";
+    gates["Basic Gates"][andGate.gateName] = andGate;
+    LibraryGate label;
+    label.gateName = "AE_LABEL";
+    label.guiType = "LABEL";
+    gates["Misc"][label.gateName] = label;
+
+    const std::string cacheFile = "library_cache_test.cache";
+    unsigned long long textHash = klsLibraryCache::hashText("<library>...</library>");
+    REQUIRE(textHash != klsLibraryCache::hashText("<library>..</library>"));
+    REQUIRE(klsLibraryCache::save(cacheFile, textHash, "Misc", gates));
+
+    SECTION("Loading gives back the same gates") {
+        std::map<std::string, std::map<std::string, LibraryGate>> loaded;
+        std::string libName;
+        REQUIRE(klsLibraryCache::load(cacheFile, textHash, libName, loaded));
+        REQUIRE(libName == "Misc");
+        REQUIRE(loaded.size() == 2);
+        const LibraryGate &gate = loaded["Basic Gates"]["AA_AND2"];
+        REQUIRE(gate.caption == "AND Gate");
+        REQUIRE(gate.logicType == "AND");
+        REQUIRE(gate.hotspots.size() == 2);
+        REQUIRE(gate.hotspots[1].name == "OUT");
+        REQUIRE(!gate.hotspots[1].isInput);
+        REQUIRE(gate.hotspots[1].isInverted);
+        REQUIRE(gate.hotspots[1].logicEInput == "ENABLE");
+        REQUIRE(gate.hotspots[1].busLines == 4);
+        REQUIRE(gate.hotspots[0].x == -2.5f);
+        REQUIRE(gate.shape.size() == 1);
+        REQUIRE(gate.shape[0].y2 == -1.0f);
+        REQUIRE(gate.shape[0].isLabel);
+        REQUIRE(gate.dlgParams.size() == 1);
+        REQUIRE(gate.dlgParams[0].name == "DELAY");
+        REQUIRE(!gate.dlgParams[0].isGui);
+        REQUIRE(gate.dlgParams[0].Rmax == 100.0f);
+        REQUIRE(gate.guiParams.at("angle") == "0.0");
+        REQUIRE(gate.logicParams.at("INPUT_BITS") == "2");
+        REQUIRE(loaded["Misc"]["AE_LABEL"].guiType == "LABEL");
+    }
+
+    SECTION("A cache of different library text is ignored") {
+        std::map<std::string, std::map<std::string, LibraryGate>> loaded;
+        std::string libName;
+        REQUIRE(!klsLibraryCache::load(cacheFile, textHash + 1, libName, loaded));
+        REQUIRE(loaded.empty());
+    }
+
+    SECTION("A damaged cache is ignored") {
+        std::ifstream in(cacheFile.c_str(), std::ios::in | std::ios::binary);
+        std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        in.close();
+        std::ofstream out(cacheFile.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+        out.write(data.data(), data.size() - 3);
+        out.close();
+
+        std::map<std::string, std::map<std::string, LibraryGate>> loaded;
+        std::string libName;
+        REQUIRE(!klsLibraryCache::load(cacheFile, textHash, libName, loaded));
+        REQUIRE(loaded.empty());
+    }
+
+    std::remove(cacheFile.c_str());
+}
+
+TEST_CASE("Prefix trie, [PrefixTrie]") {
+    klsPrefixTrie trie;
+    trie.insert("AND Gate", 0);
+    trie.insert("AA_AND2", 0);
+    trie.insert("AND3", 1);
+    trie.insert("Adder", 2);
+    trie.insert("OR Gate", 3);
+
+    SECTION("Every name under the prefix is found, ignoring case") {
+        std::vector<size_t> found;
+        trie.find("and", found);
+        std::sort(found.begin(), found.end());
+        REQUIRE(found == std::vector<size_t>({0, 1}));
+    }
+
+    SECTION("A value filed under two matching names is found once") {
+        std::vector<size_t> found;
+        trie.find("A", found);
+        std::sort(found.begin(), found.end());
+        REQUIRE(found == std::vector<size_t>({0, 1, 2}));
+    }
+
+    SECTION("An empty prefix finds everything") {
+        std::vector<size_t> found;
+        trie.find("", found);
+        REQUIRE(found.size() == 4);
+    }
+
+    SECTION("A prefix nothing starts with finds nothing") {
+        std::vector<size_t> found;
+        trie.find("andx", found);
+        trie.find("xor", found);
+        REQUIRE(found.empty());
+    }
+
+    SECTION("Clearing empties the trie") {
+        std::vector<size_t> found;
+        trie.clear();
+        trie.find("", found);
+        REQUIRE(found.empty());
+    }
+}
@@ -16,6 +16,15 @@
 #include <cerrno>
 #include <cstring>
 
+// For syncing files to disk:
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 // Windows doesn't define EDQUOT (disk quota exceeded) - define it for compatibility
 #ifdef _MSC_VER
 #ifndef EDQUOT
@@ -287,6 +296,7 @@ void CircuitParse::parseGateToSend(string type, string ID, string position, vect
 			gCanvas->getCircuit()->sendMessageToCore(klsMessage::Message(klsMessage::MT_SET_GATE_PARAM, new klsMessage::Message_SET_GATE_PARAM(id, params[i].paramName, params[i].paramValue)));
 		} else newGate->setGUIParam( params[i].paramName, params[i].paramValue );
 	}
+	gCanvas->getCircuit()->refileGateName( id );
 	if( logicType.size() > 0 ) {
 		// Loop through the hotspots and pass logic core hotspot settings:
 		LibraryGate libGate;
@@ -423,12 +433,54 @@ void CircuitParse::parseWireToSend( void ) {
 	// Check to make sure the wire exists before we do things to it
 	if ((gCanvas->getCircuit()->getWires())->find(ids.front()) == (gCanvas->getCircuit()->getWires())->end()) return;
 
+	// The tree is merged when the page is first shown
 	(*(gCanvas->getCircuit()->getWires()))[ids.front()]->setIDs(ids);
-	(*(gCanvas->getCircuit()->getWires()))[ids.front()]->setSegmentMap( wireShape );
+	(*(gCanvas->getCircuit()->getWires()))[ids.front()]->setSegmentMap( wireShape, true );
+	gCanvas->markOpenShapes();
 }
 
 bool CircuitParse::saveCircuit(string filename, vector< GUICanvas* > glc, unsigned int currPage) {
-	ostringstream* ossCircuit = new ostringstream();
+	return writeCircuit(filename, serializeCircuit(glc, currPage));
+}
+
+void CircuitParse::snapshotCircuit(vector< GUICanvas* > glc, unsigned int currPage, circuitSnapshot& snap) {
+	snap.currPage = currPage;
+	snap.pages.clear();
+	snap.pages.resize(glc.size());
+	for (unsigned int i = 0; i < glc.size(); i++) {
+		pageSnapshot &page = snap.pages[i];
+		glc[i]->getViewport(page.topLeft, page.bottomRight);
+
+		unordered_map < unsigned long, guiGate* >* gateList = glc[i]->getGateList();
+		unordered_map < unsigned long, guiWire* >* wireList = glc[i]->getWireList();
+		page.gates.reserve(gateList->size());
+		page.wires.reserve(wireList->size());
+		unordered_map< unsigned long, guiGate* >::iterator thisGate = gateList->begin();
+		while (thisGate != gateList->end()) {
+			page.gates.push_back(gateSnapshot());
+			(thisGate->second)->snapshotGate(page.gates.back());
+			thisGate++;
+		}
+
+		unordered_map< unsigned long, guiWire* >::iterator thisWire = wireList->begin();
+		while (thisWire != wireList->end()) {
+			if (thisWire->second != nullptr) {
+				page.wires.push_back(wireSnapshot());
+				(thisWire->second)->snapshotWire(page.wires.back());
+			}
+			thisWire++;
+		}
+	}
+}
+
+string CircuitParse::serializeCircuit(vector< GUICanvas* > glc, unsigned int currPage) {
+	circuitSnapshot snap;
+	snapshotCircuit(glc, currPage, snap);
+	return serializeCircuit(snap);
+}
+
+string CircuitParse::serializeCircuit(const circuitSnapshot& snap) {
+	ostringstream ossCircuit;
 
 	// This is a sentinal circuit definition that is ignored by Cedar Logic 2.0 and newer.
 	// Older versions of Cedar Logic will read this instead of the actual Circuit data.
@@ -436,7 +488,7 @@ bool CircuitParse::saveCircuit(string filename, vector< GUICanvas* > glc, unsign
 	// The second label has a link to the download for the latest version of Cedar Logic.
 	// I acknowledge that this is a hack...
 	// Versions of Cedar Logic 2.0 and newer have a <version> tag.
-	*ossCircuit << R"===(
+	ossCircuit << R"===(
 <circuit>
 <CurrentPage>0</CurrentPage>
 <page 0>
@@ -460,25 +512,25 @@ bool CircuitParse::saveCircuit(string filename, vector< GUICanvas* > glc, unsign
 
 	)===";
 
-	mParse = new XMLParser(ossCircuit);
+	delete mParse;
+	mParse = new XMLParser(&ossCircuit);
 
 	mParse->openTag("version");
 	mParse->writeTag("version", VERSION_NUMBER_STRING());
 	mParse->closeTag("version");
 
 	mParse->openTag("circuit");
-	unordered_map < unsigned long, guiGate* >* gateList;
-	unordered_map < unsigned long, guiWire* >* wireList;
 
 	// Save which page was current:
 	//	NOTE: currently this tag is not implemented
 	mParse->openTag("CurrentPage");
 	ostringstream oss;
-	oss << currPage;
+	oss << snap.currPage;
 	mParse->writeTag("CurrentPage", oss.str());
 	mParse->closeTag("CurrentPage");
 
-	for (unsigned int i = 0; i < glc.size(); i++) {
+	for (unsigned int i = 0; i < snap.pages.size(); i++) {
+		const pageSnapshot &page = snap.pages[i];
 		ostringstream oss;
 		oss << "page " << i;
 		string pageNumber = oss.str();
@@ -488,26 +540,16 @@ bool CircuitParse::saveCircuit(string filename, vector< GUICanvas* > glc, unsign
 		mParse->openTag("PageViewport");
 		oss.str("");
 		oss.clear();
-		GLPoint2f topLeft, bottomRight;
-		glc[i]->getViewport(topLeft, bottomRight);
-		oss << topLeft.x << "," << topLeft.y << "," << bottomRight.x << "," << bottomRight.y;
+		oss << page.topLeft.x << "," << page.topLeft.y << "," << page.bottomRight.x << "," << page.bottomRight.y;
 		mParse->writeTag("PageViewport", oss.str());
 		mParse->closeTag("PageViewport");
 
-		gateList = glc[i]->getGateList();
-		wireList = glc[i]->getWireList();
-		unordered_map< unsigned long, guiGate* >::iterator thisGate = gateList->begin();
-		while (thisGate != gateList->end()) {
-			(thisGate->second)->saveGate(mParse);
-			thisGate++;
+		for (unsigned int g = 0; g < page.gates.size(); g++) {
+			guiGate::saveGate(mParse, page.gates[g]);
 		}
-		
-		unordered_map< unsigned long, guiWire* >::iterator thisWire = wireList->begin();
-		while (thisWire != wireList->end()) {
-			if (thisWire->second != nullptr) {
-				(thisWire->second)->saveWire(mParse);
-			}
-			thisWire++;
+
+		for (unsigned int w = 0; w < page.wires.size(); w++) {
+			guiWire::saveWire(mParse, page.wires[w]);
 		}
 		
 		mParse->closeTag(pageNumber);
@@ -515,6 +557,32 @@ bool CircuitParse::saveCircuit(string filename, vector< GUICanvas* > glc, unsign
 	
 	mParse->closeTag("circuit");
 
+	// The parser points at our stream, so don't keep it around:
+	delete mParse;
+	mParse = nullptr;
+
+	return ossCircuit.str();
+}
+
+// Ask the OS to put a file's contents on the disk, so that it survives a
+// crash or power loss:
+static void syncFile(const string& filename) {
+#ifdef _WIN32
+	int fd = _open(filename.c_str(), _O_RDWR);
+	if (fd >= 0) {
+		_commit(fd);
+		_close(fd);
+	}
+#else
+	int fd = open(filename.c_str(), O_RDONLY);
+	if (fd >= 0) {
+		fsync(fd);
+		close(fd);
+	}
+#endif
+}
+
+bool CircuitParse::writeCircuit(string filename, const string& circuitXML, bool syncToDisk) {
 	// Clear any previous error
 	lastError = "";
 
@@ -541,7 +609,7 @@ bool CircuitParse::saveCircuit(string filename, vector< GUICanvas* > glc, unsign
 
 	// Write the circuit data
 	errno = 0;
-	outfile << ossCircuit->str();
+	outfile << circuitXML;
 	if (outfile.fail()) {
 		int errnum = errno;
 		outfile.close();
@@ -576,6 +644,8 @@ bool CircuitParse::saveCircuit(string filename, vector< GUICanvas* > glc, unsign
 		return false;
 	}
 
+	if (syncToDisk) syncFile(filename);
+
 	return true;
 }
 
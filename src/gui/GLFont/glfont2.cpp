@@ -209,6 +209,47 @@ void GLFont::Begin (void)
 	glBindTexture(GL_TEXTURE_2D, header.tex);
 }
 //*******************************************************************
+void GLFont::GetStringQuads (const std::string &text, float x, float y,
+	std::vector<float> *vertices, std::vector<float> *tex_coords)
+{
+	unsigned int i;
+	int c;
+	GLFontChar *glfont_char;
+	float width, height;
+
+	vertices->clear();
+	tex_coords->clear();
+
+	//Loop through characters
+	for (i = 0; i < text.size(); i++)
+	{
+		//Make sure character is in range
+		c = text[i];
+		if (c < header.start_char || c > header.end_char)
+			continue;
+
+		//Get pointer to glFont character
+		glfont_char = &header.chars[c - header.start_char];
+
+		//Get width and height
+		width = glfont_char->dx * header.tex_width;
+		height = glfont_char->dy * header.tex_height;
+
+		//Same corners as DrawString
+		float quad[8] = { x, y, x, y - height,
+			x + width, y - height, x + width, y };
+		float quad_tex[8] = { glfont_char->tx1, glfont_char->ty1,
+			glfont_char->tx1, glfont_char->ty2,
+			glfont_char->tx2, glfont_char->ty2,
+			glfont_char->tx2, glfont_char->ty1 };
+		vertices->insert(vertices->end(), quad, quad + 8);
+		tex_coords->insert(tex_coords->end(), quad_tex, quad_tex + 8);
+
+		//Move to next character
+		x += width;
+	}
+}
+//*******************************************************************
 
 //End of file
 
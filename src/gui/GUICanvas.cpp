@@ -13,7 +13,9 @@
 #include "paramDialog.h"
 #include "QuickAddDialog.h"
 #include "klsClipboard.h"
+#include "klsCommandProcessor.h"
 #include "guiWire.h"
+#include "guiText.h"
 
 #include <wx/dnd.h>
 
@@ -62,6 +64,7 @@ GUICanvas::GUICanvas(wxWindow *parent, GUICircuit* gCircuit, wxWindowID id,
 	hotspotHighlight = "";
 	
 	drawWireHover = false;
+	openShapesPending = false;
 	
 	setHorizGrid(0.5);
 	setVertGrid(0.5);
@@ -107,6 +110,8 @@ void GUICanvas::clearCircuit() {
 	collisionChecker.clear();
 	gateList.clear();
 	wireList.clear();
+	wireBatch.invalidate();
+	openShapesPending = false;
 
 	// Add mouse object to collision checker
 	collisionChecker.addObject( mouse );
@@ -142,6 +147,7 @@ void GUICanvas::insertWire(guiWire* wire) {
 	}
 
 	wireList[wire->getID()] = wire;
+	wireBatch.invalidate();
 
 	// Add the wire to the collision checker:
 	collisionChecker.addObject( wire );
@@ -178,10 +184,48 @@ void GUICanvas::removeWire(unsigned long wireId) {
 			wireList.erase(thisWire);
 		}
 	}
+	wireBatch.invalidate();
+}
+
+// Merge the wire trees that were read from a file, now that the page is
+// being shown. Pages that are never opened never pay for their wires:
+void GUICanvas::finishOpenShapes() {
+	if (!openShapesPending) return;
+	openShapesPending = false;
+
+	unordered_map< unsigned long, guiWire* >::iterator thisWire = wireList.begin();
+	while (thisWire != wireList.end()) {
+		if (thisWire->second != nullptr) (thisWire->second)->finishOpenShape();
+		thisWire++;
+	}
+	wireBatch.invalidate();
+}
+
+// Get the area of the page that is on screen (or in the image tile being
+// rendered), padded so that wide bus lines and connection dots just outside
+// of it still count as in view:
+klsBBox GUICanvas::getViewBox() {
+	GLPoint2f viewTopLeft, viewBottomRight;
+	getRenderArea( viewTopLeft, viewBottomRight );
+	klsBBox viewBox;
+	viewBox.addPoint( viewTopLeft );
+	viewBox.addPoint( viewBottomRight );
+	GLfloat viewPad = wxGetApp().appSettings.wireConnRadius + 4 * getZoom();
+	viewBox.extendLeft( viewPad );
+	viewBox.extendRight( viewPad );
+	viewBox.extendTop( viewPad );
+	viewBox.extendBottom( viewPad );
+	return viewBox;
+}
+
+void GUICanvas::refreshRegion( klsBBox region ) {
+	if( region.empty() || !getViewBox().overlaps( region ) ) return;
+	Refresh();
 }
 
 // Render the page
 void GUICanvas::OnRender( bool noColor ) {
+	finishOpenShapes();
 	glColor4f( 0.0, 0.0, 0.0, 1.0 );
 	
 	// Draw the wires:
@@ -190,25 +234,82 @@ void GUICanvas::OnRender( bool noColor ) {
 wxStopWatch renderTimer;
 	glColor4f( 0.0, 0.0, 0.0, 1.0 );
 	
+	// Find the gates and wires in view, so that the cost of drawing
+	// depends on what's on the screen rather than the size of the page:
+	CollisionGroup inView = collisionChecker.getObjectsInBox( getViewBox() );
+
+	// Pick the level of detail from the zoom:
+	// (Images are always exported in full detail.)
+	bool drawGateBoxes = !wxGetApp().doingBitmapExport && getZoom() > LOD_BOX_ZOOM;
+	bool drawWireDetail = wxGetApp().doingBitmapExport || getZoom() <= LOD_OVERVIEW_ZOOM;
+
 	// Draw the gates:
-	unordered_map< unsigned long, guiGate* >::iterator thisGate = gateList.begin();
-	while( thisGate != gateList.end() ) {
-		(thisGate->second)->draw(!noColor);
-		thisGate++;
+	// (When zoomed far out, the gates' bboxes are collected into one array
+	// of boxes instead.)
+	vector< guiWire* > visibleWires;
+	vector< GLfloat > boxPoints;
+	vector< GLfloat > boxColors;
+	CollisionGroup::iterator viewObj = inView.begin();
+	while( viewObj != inView.end() ) {
+		// (Only draw things that are really on the page, not gates that
+		// are still being dragged in.)
+		if( (*viewObj)->getType() == COLL_GATE ) {
+			guiGate* gate = static_cast< guiGate* >( *viewObj );
+			unordered_map< unsigned long, guiGate* >::iterator thisGate = gateList.find( gate->getID() );
+			if( thisGate != gateList.end() && thisGate->second == gate ) {
+				if( drawGateBoxes ) {
+					klsBBox gateBox = gate->getBBox();
+					GLfloat corners[8] = { gateBox.getLeft(), gateBox.getBottom(), gateBox.getRight(), gateBox.getBottom(),
+						gateBox.getRight(), gateBox.getTop(), gateBox.getLeft(), gateBox.getTop() };
+					GLfloat boxColor[4] = { LOD_BOX_INTENSITY, LOD_BOX_INTENSITY, LOD_BOX_INTENSITY, 1.0 };
+					if( gate->isSelected() && !noColor ) {
+						boxColor[0] = 1.0;
+						boxColor[1] = boxColor[2] = LOD_BOX_INTENSITY / 2;
+					}
+					boxPoints.insert( boxPoints.end(), corners, corners + 8 );
+					for( int i = 0; i < 4; i++ ) boxColors.insert( boxColors.end(), boxColor, boxColor + 4 );
+				} else {
+					gate->draw(!noColor);
+				}
+			}
+		} else if( (*viewObj)->getType() == COLL_WIRE ) {
+			guiWire* wire = static_cast< guiWire* >( *viewObj );
+			unordered_map< unsigned long, guiWire* >::iterator thisWire = wireList.find( wire->getID() );
+			if( thisWire != wireList.end() && thisWire->second == wire ) {
+				visibleWires.push_back( wire );
+			}
+		}
+		viewObj++;
 	}
 
 	glLoadIdentity();
+
+	if( !boxPoints.empty() ) {
+		glEnableClientState( GL_VERTEX_ARRAY );
+		glEnableClientState( GL_COLOR_ARRAY );
+		glVertexPointer( 2, GL_FLOAT, 0, &boxPoints[0] );
+		glColorPointer( 4, GL_FLOAT, 0, &boxColors[0] );
+		glDrawArrays( GL_QUADS, 0, (GLsizei)(boxPoints.size() / 2) );
+		glDisableClientState( GL_COLOR_ARRAY );
+		glDisableClientState( GL_VERTEX_ARRAY );
+		glColor4f( 0.0, 0.0, 0.0, 1.0 );
+	}
 	
 	// Draw the wires:
-	unordered_map< unsigned long, guiWire* >::iterator thisWire = wireList.begin();
-	while( thisWire != wireList.end() ) {
-		if (thisWire->second != nullptr) {
-			(thisWire->second)->draw(!noColor);
+	// (The batch leaves out selected wires when drawing in color, so they
+	// are drawn one at a time afterwards with their dotted lines.)
+	wireBatch.draw( visibleWires, !noColor, drawWireDetail );
+	if( !noColor ) {
+		for( unsigned int i = 0; i < visibleWires.size(); i++ ) {
+			if( visibleWires[i]->isSelected() ) visibleWires[i]->draw(true);
 		}
-		thisWire++;
 	}
 renderTime += renderTimer.Time();
 renderNum++;
+
+	if( !noColor && wxGetApp().activityVisible ) {
+		drawActivityOverlay( inView );
+	}
 	
 	
 	// Draw the basic view objects:
@@ -349,6 +450,119 @@ renderNum++;
 	glColor4f( 0.0, 0.0, 0.0, 1.0 );
 }
 
+// Set the heat map color for an activity level from 0 (quiet) to 1 (the busiest):
+static void setActivityColor( float level, float alpha ) {
+	// Blue through yellow to red:
+	if( level < 0.5f ) {
+		glColor4f( level * 2, level * 2, 1.0f - level * 2, alpha );
+	} else {
+		glColor4f( 1.0f, 2.0f - level * 2, 0.0f, alpha );
+	}
+}
+
+// Place a rate on a log scale between 0 and the highest rate:
+static float activityLevel( float rate, float maxRate ) {
+	if( maxRate <= 0 ) return 0;
+	return log( 1.0f + rate ) / log( 1.0f + maxRate );
+}
+
+void GUICanvas::drawActivityOverlay( const CollisionGroup& inView ) {
+	wxMutexLocker lock(wxGetApp().activityMutex);
+	unordered_map<IDType, float>& gateActivity = wxGetApp().gateActivity;
+	unordered_map<IDType, float>& wireActivity = wxGetApp().wireActivity;
+
+	float maxGateRate = 0;
+	unordered_map<IDType, float>::iterator rate = gateActivity.begin();
+	while( rate != gateActivity.end() ) {
+		maxGateRate = max( maxGateRate, rate->second );
+		rate++;
+	}
+	float maxWireRate = 0;
+	rate = wireActivity.begin();
+	while( rate != wireActivity.end() ) {
+		maxWireRate = max( maxWireRate, rate->second );
+		rate++;
+	}
+
+	glMatrixMode (GL_MODELVIEW);
+	glLoadIdentity ();
+
+	// Shade the busy gates and trace the busy wires with a wide line, for
+	// just the objects in view:
+	// (A bus is as busy as its busiest line.)
+	glLineWidth( 6 );
+	CollisionGroup::const_iterator viewObj = inView.begin();
+	while( viewObj != inView.end() ) {
+		if( (*viewObj)->getType() == COLL_GATE ) {
+			guiGate* gate = static_cast< guiGate* >( *viewObj );
+			unordered_map< unsigned long, guiGate* >::iterator thisGate = gateList.find( gate->getID() );
+			rate = gateActivity.find( gate->getID() );
+			if( thisGate != gateList.end() && thisGate->second == gate && rate != gateActivity.end() ) {
+				setActivityColor( activityLevel( rate->second, maxGateRate ), 0.45f );
+				klsBBox box = gate->getBBox();
+				glRectf( box.getLeft(), box.getBottom(), box.getRight(), box.getTop() );
+			}
+		} else if( (*viewObj)->getType() == COLL_WIRE ) {
+			guiWire* wire = static_cast< guiWire* >( *viewObj );
+			unordered_map< unsigned long, guiWire* >::iterator thisWire = wireList.find( wire->getID() );
+			if( thisWire == wireList.end() || thisWire->second != wire ) { viewObj++; continue; }
+			float wireRate = 0;
+			const vector< IDType > &ids = wire->getIDs();
+			for( unsigned int i = 0; i < ids.size(); i++ ) {
+				rate = wireActivity.find( ids[i] );
+				if( rate != wireActivity.end() ) wireRate = max( wireRate, rate->second );
+			}
+			if( wireRate > 0 ) {
+				setActivityColor( activityLevel( wireRate, maxWireRate ), 0.45f );
+				const vector< GLLine2f > &lineSegments = wire->getLineSegments();
+				glBegin(GL_LINES);
+				for( unsigned int i = 0; i < lineSegments.size(); i++ ) {
+					glVertex2f( lineSegments[i].begin.x, lineSegments[i].begin.y );
+					glVertex2f( lineSegments[i].end.x, lineSegments[i].end.y );
+				}
+				glEnd();
+			}
+		}
+		viewObj++;
+	}
+	glLineWidth( 1 );
+
+	// Draw the legend in the bottom left corner of the view, sized in pixels:
+	GLPoint2f topLeft, bottomRight;
+	getViewport( topLeft, bottomRight );
+	float px = getZoom();
+	float left = topLeft.x + 10 * px;
+	float bottom = bottomRight.y + 10 * px;
+	float barWidth = 160 * px;
+	float barHeight = 10 * px;
+	float textHeight = 12 * px;
+
+	glColor4f( 1.0, 1.0, 1.0, 0.8f );
+	glRectf( left - 4 * px, bottom - 4 * px, left + barWidth + 4 * px, bottom + barHeight + 2 * textHeight + 8 * px );
+
+	const int barSteps = 32;
+	for( int i = 0; i < barSteps; i++ ) {
+		setActivityColor( (float) i / (barSteps - 1), 1.0 );
+		glRectf( left + barWidth * i / barSteps, bottom, left + barWidth * (i + 1) / barSteps, bottom + barHeight );
+	}
+
+	ostringstream gateLabel, wireLabel;
+	gateLabel << "Gates: up to " << (long) maxGateRate << " updates/s";
+	wireLabel << "Wires: up to " << (long) maxWireRate << " toggles/s";
+	guiText legendText;
+	legendText.setColor( 0.0, 0.0, 0.0, 1.0 );
+	legendText.setSize( textHeight );
+	legendText.setText( wireLabel.str() );
+	legendText.setPosition( left, bottom + barHeight + textHeight + 2 * px );
+	legendText.draw();
+	legendText.setText( gateLabel.str() );
+	legendText.setPosition( left, bottom + barHeight + 2 * textHeight + 4 * px );
+	legendText.draw();
+
+	// Reset the color back to black:
+	glColor4f( 0.0, 0.0, 0.0, 1.0 );
+}
+
 void GUICanvas::mouseLeftDown(wxMouseEvent& event) {
 	GLPoint2f m = getMouseCoords();
 	bool handled = false;
@@ -822,7 +1036,7 @@ void GUICanvas::OnMouseUp(wxMouseEvent& event) {
 		int newGID = gCircuit->getNextAvailableGateID();
 		float nx, ny;
 		newDragGate->getGLcoords(nx, ny);
-		gCircuit->getGates()->erase(newDragGate->getID());
+		gCircuit->detachGate(newDragGate->getID());
 		creategatecommand = new cmdCreateGate( this, gCircuit, newGID, newDragGate->getLibraryGateName(), nx, ny );
 		gCircuit->GetCommandProcessor()->Submit( (wxCommand*)creategatecommand );
 		collisionChecker.removeObject( newDragGate );
@@ -914,6 +1128,7 @@ void GUICanvas::OnMouseUp(wxMouseEvent& event) {
 
 	if ((currentDragState == DRAG_NEWGATE || currentDragState == DRAG_SELECTION) && (potentialConnectionHotspots.size() > 0)) {
 		// Check potential hotspot connections (on gate/gate collisions)
+		bool connectionsAdded = false;
 		CollisionGroup ovrList = collisionChecker.overlaps[COLL_GATE];
 		CollisionGroup::iterator obj = ovrList.begin();
 		while( obj != ovrList.end() ) {
@@ -947,8 +1162,12 @@ void GUICanvas::OnMouseUp(wxMouseEvent& event) {
 										if (!isWithinPaste) gCircuit->GetCommandProcessor()->Submit((wxCommand*)movecommand);
 									}
 									movecommand->getConnections()->push_back(createwire);
+									connectionsAdded = true;
+								}
+								else if (currentDragState == DRAG_NEWGATE) {
+									creategatecommand->getConnections()->push_back(createwire);
+									connectionsAdded = true;
 								}
-								else if (currentDragState == DRAG_NEWGATE) creategatecommand->getConnections()->push_back(createwire);
 								else delete createwire;
 							}
 						}
@@ -960,6 +1179,11 @@ void GUICanvas::OnMouseUp(wxMouseEvent& event) {
 			}
 			obj++;
 		}
+
+		// The command that got the connections was sized for the undo
+		// history before they were added to it:
+		klsCommandProcessor* commandProcessor = dynamic_cast< klsCommandProcessor* >(gCircuit->GetCommandProcessor());
+		if (connectionsAdded && !isWithinPaste && commandProcessor != nullptr) commandProcessor->remeasureCurrentCommand();
 	}
 
 	// Drop a paste block with the proper move coords
@@ -1032,7 +1256,7 @@ void GUICanvas::OnKeyDown(wxKeyEvent& event) {
 		unselectAllGates();
 		unselectAllWires();
 		if (currentDragState == DRAG_NEWGATE) {
-			gCircuit->getGates()->erase(newDragGate->getID());
+			gCircuit->detachGate(newDragGate->getID());
 			collisionChecker.removeObject( newDragGate );
 			delete newDragGate;
 			collisionChecker.update();
@@ -1268,6 +1492,7 @@ void GUICanvas::pasteBlockFromClipboard () {
 // Zoom the canvas to fit all items within it:
 void GUICanvas::setZoomAll( void ) {
 // TODO: BUG this function sometimes hangs the program.
+	finishOpenShapes();
 	klsBBox zoomBox;
 
 	// Add all the gates into the zoom all box:
@@ -13,6 +13,7 @@
 #include "GUICanvas.h"
 #include "OscopeFrame.h"
 #include "guiWire.h"
+#include "MainFrame.h"
 
 DECLARE_APP(MainApp)
 IMPLEMENT_DYNAMIC_CLASS(GUICircuit, wxDocument)
@@ -50,6 +51,9 @@ void GUICircuit::reInitializeLogicCircuit() {
 	} 
 	gateList.clear();
 	wireList.clear();
+	gatesByType.clear();
+	gatesByName.clear();
+	gateNames.clear();
 	nextGateID = nextWireID = 0;
 	waitToSendMessage = false;
 	simulate = true;
@@ -111,6 +115,9 @@ guiGate* GUICircuit::createGate(string gateName, long id, bool noOscope) {
 	newGate->calcBBox();
 	gateList[id] = newGate;
 	gateList[id]->setID(id);
+	gatesByType[ggt].insert(id);
+	gateNames[id] = getGateName(newGate);
+	gatesByName[ggt][gateNames[id]].insert(id);
 	
 	// Update the OScope with the new info:
 	if(ggt == "TO" && !noOscope) {
@@ -128,12 +135,14 @@ void GUICircuit::deleteGate(unsigned long gid, bool waitToUpdate) {
 	if (gateList.find(gid) == gateList.end()) return;
 
 	//Update Oscope
-	if(!waitToUpdate && gateList[gid]->getGUIType() == "TO") {
+	string guiType = gateList[gid]->getGUIType();
+	if(!waitToUpdate && guiType == "TO") {
 		updateMenu = true;
 	}
-	
-	delete gateList[gid];
-	gateList.erase(gid);
+
+	guiGate* gate = gateList[gid];
+	detachGate(gid);
+	delete gate;
 
 	//Call Update Oscope
 	if(updateMenu)
@@ -142,6 +151,65 @@ void GUICircuit::deleteGate(unsigned long gid, bool waitToUpdate) {
 	}		
 }
 
+void GUICircuit::detachGate(unsigned long gid) {
+	unordered_map< unsigned long, guiGate* >::iterator gate = gateList.find(gid);
+	if (gate == gateList.end()) return;
+
+	string guiType = gate->second->getGUIType();
+	gatesByType[guiType].erase(gid);
+	map< string, set< unsigned long > >::iterator named = gatesByName[guiType].find(gateNames[gid]);
+	if (named != gatesByName[guiType].end()) named->second.erase(gid);
+	gateNames.erase(gid);
+
+	gateList.erase(gate);
+}
+
+const set< unsigned long >& GUICircuit::getGatesOfType(const string& guiType) {
+	static const set< unsigned long > none;
+	map< string, set< unsigned long > >::iterator ofType = gatesByType.find(guiType);
+	if (ofType == gatesByType.end()) return none;
+	return ofType->second;
+}
+
+vector< guiGate* > GUICircuit::findGatesByName(const string& guiType, const string& name) {
+	vector< guiGate* > found;
+	map< string, map< string, set< unsigned long > > >::iterator ofType = gatesByName.find(guiType);
+	if (ofType == gatesByName.end()) return found;
+	map< string, set< unsigned long > >::iterator named = ofType->second.find(name);
+	if (named == ofType->second.end()) return found;
+
+	set< unsigned long >::iterator gid = named->second.begin();
+	while (gid != named->second.end()) {
+		unordered_map< unsigned long, guiGate* >::iterator gate = gateList.find(*gid);
+		if (gate != gateList.end()) found.push_back(gate->second);
+		gid++;
+	}
+	return found;
+}
+
+void GUICircuit::refileGateName(unsigned long gid) {
+	unordered_map< unsigned long, guiGate* >::iterator gate = gateList.find(gid);
+	if (gate == gateList.end()) return;
+
+	string name = getGateName(gate->second);
+	string& filedName = gateNames[gid];
+	if (name == filedName) return;
+
+	map< string, set< unsigned long > >& names = gatesByName[gate->second->getGUIType()];
+	map< string, set< unsigned long > >::iterator named = names.find(filedName);
+	if (named != names.end()) {
+		named->second.erase(gid);
+		if (named->second.empty()) names.erase(named);
+	}
+	names[name].insert(gid);
+	filedName = name;
+}
+
+string GUICircuit::getGateName(guiGate* gate) {
+	if (gate->getGUIType() == "LABEL") return gate->getGUIParam("LABEL_TEXT");
+	return gate->getLogicParam("JUNCTION_ID");
+}
+
 guiWire* GUICircuit::createWire(const std::vector<IDType> &wireIds) {
 	if (wireList.find(wireIds[0]) == wireList.end()) { // wire does not exist yet
 
@@ -188,13 +256,33 @@ void GUICircuit::Render() {
 	return;
 }
 
-void GUICircuit::syncWireStates() {
-	wxMutexLocker lock(wxGetApp().wireStateMutex);
-	for (auto& entry : wxGetApp().wireStateBuffer) {
-		if (buslineToWire.find(entry.first) != buslineToWire.end()) {
-			buslineToWire[entry.first]->setSubState(entry.first, entry.second);
+klsBBox GUICircuit::syncWireStates() {
+	// Take the changes out of the buffer, so that each sync only looks at
+	// the wires that changed since the last one:
+	unordered_map<IDType, StateType> changedStates;
+	{
+		wxMutexLocker lock(wxGetApp().wireStateMutex);
+		changedStates.swap(wxGetApp().wireStateBuffer);
+	}
+
+	klsBBox changedRegion;
+	for (auto& entry : changedStates) {
+		auto wire = buslineToWire.find(entry.first);
+		if (wire == buslineToWire.end()) continue;
+
+		unsigned long oldRevision = wire->second->getStateRevision();
+		wire->second->setSubState(entry.first, entry.second);
+		if (wire->second->getStateRevision() == oldRevision) continue;
+
+		// The wire and the gates that show its state (LEDs, etc.) need
+		// to be redrawn:
+		klsBBox wireBox = wire->second->getBBox();
+		if (!wireBox.empty()) changedRegion.addBBox(wireBox);
+		for (const wireConnection &conn : wire->second->getConnections()) {
+			if (conn.cGate != nullptr) changedRegion.addBBox(conn.cGate->getBBox());
 		}
 	}
+	return changedRegion;
 }
 
 void GUICircuit::parseMessage(klsMessage::Message message) {
@@ -203,7 +291,11 @@ void GUICircuit::parseMessage(klsMessage::Message message) {
 		case klsMessage::MT_SET_GATE_PARAM: {
 			// SET GATE id PARAMETER name val
 			klsMessage::Message_SET_GATE_PARAM* msgSetGateParam = (klsMessage::Message_SET_GATE_PARAM*)(message.mStruct);
-			if (gateList.find(msgSetGateParam->gateId) != gateList.end()) gateList[msgSetGateParam->gateId]->setLogicParam(msgSetGateParam->paramName, msgSetGateParam->paramValue);
+			if (gateList.find(msgSetGateParam->gateId) != gateList.end()) {
+				gateList[msgSetGateParam->gateId]->setLogicParam(msgSetGateParam->paramName, msgSetGateParam->paramValue);
+				if (msgSetGateParam->paramName == "JUNCTION_ID") refileGateName(msgSetGateParam->gateId);
+				dirtyRegion.addBBox(gateList[msgSetGateParam->gateId]->getBBox());
+			}
 			if( msgSetGateParam->paramName == "PAUSE_SIM" ){
 				pausing = true;
 				panic = true;
@@ -214,19 +306,30 @@ void GUICircuit::parseMessage(klsMessage::Message message) {
 		case klsMessage::MT_DONESTEP: { // DONESTEP
 			simulate = true;
 			int logicTime = ((klsMessage::Message_DONESTEP*)(message.mStruct))->logicTime;
+			CircuitStats* stats = ((klsMessage::Message_DONESTEP*)(message.mStruct))->stats;
+			if (stats != NULL) {
+				logicStats = *stats;
+				if (wxGetApp().mainframe != NULL) wxGetApp().mainframe->showLogicStats(logicStats);
+			}
 			// Panic if core isn't keeping up, keep a 3ms buffer...
 			panic = (logicTime > lastTime+3) || panic;
 			// Now we can send the waiting messages
 			for (unsigned int i = 0; i < messageQueue.size(); i++) sendMessageToCore(messageQueue[i]);
 			messageQueue.clear();
-			// Sync wire states and always refresh
-			syncWireStates();
-			gCanvas->Refresh();
+			// Sync wire states, and only refresh if something in view
+			// changed (or the activity map, which changes every step, is
+			// shown):
+			klsBBox changedRegion = syncWireStates();
+			if (!changedRegion.empty()) dirtyRegion.addBBox(changedRegion);
+			if (wxGetApp().activityVisible) gCanvas->Refresh();
+			else gCanvas->refreshRegion(dirtyRegion);
+			dirtyRegion.reset();
 			delete ((klsMessage::Message_DONESTEP*)(message.mStruct));
 			break;
 		}
 		case klsMessage::MT_COMPLETE_INTERIM_STEP: {// COMPLETE INTERIM STEP - UPDATE OSCOPE
-			syncWireStates();
+			klsBBox changedRegion = syncWireStates();
+			if (!changedRegion.empty()) dirtyRegion.addBBox(changedRegion);
 			myOscope->UpdateData();
 			break;
 		}
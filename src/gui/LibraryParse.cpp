@@ -9,7 +9,10 @@
 *****************************************************************************/
 
 #include "LibraryParse.h"
+#include "klsLibraryCache.h"
 #include "wx/msgdlg.h"
+#include "wx/stdpaths.h"
+#include "wx/filename.h"
 #include "MainApp.h"
 
 // Included for sin and cos in <circle> tags:
@@ -27,10 +30,22 @@ LibraryParse::LibraryParse(string fileName) {
 
 		return;
 	}
-	mParse = new XMLParser(&x, false);
 	this->fileName = fileName;
-	parseFile();
-	delete mParse;
+
+	// If this exact library was parsed before, load the cached gates instead:
+	ostringstream libText;
+	libText << x.rdbuf();
+	unsigned long long textHash = klsLibraryCache::hashText(libText.str());
+	string cacheFile = getCacheFile();
+	if (cacheFile.empty() || !klsLibraryCache::load(cacheFile, textHash, libName, gates)) {
+		x.clear();
+		x.seekg(0);
+		mParse = new XMLParser(&x, false);
+		parseFile();
+		delete mParse;
+		if (!cacheFile.empty()) klsLibraryCache::save(cacheFile, textHash, libName, gates);
+	}
+	registerGates();
 }
 
 LibraryParse::LibraryParse() {
@@ -199,14 +214,9 @@ void LibraryParse::parseFile() {
 					mParse->readCloseTag();
 				} else if (temp == "caption") {
 					newGate.caption = mParse->readTagValue("caption");
-					if (newGate.caption == "Inverter" && (time(0) % 1001 == 0)) { // Easter egg, rename inverters once in a while :)
-						newGate.caption = "Santa Hat (Inverter)";
-					}
 					mParse->readCloseTag();
 				}
 			} while (!mParse->isCloseTag(mParse->getCurrentIndex())); // end gate
-			wxGetApp().gateNameToLibrary[newGate.gateName] = libName;
-			wxGetApp().libraries[libName][newGate.gateName] = newGate;
 			gates[libName][newGate.gateName] = newGate;
 			mParse->readCloseTag(); //gate
 		} while (!mParse->isCloseTag(mParse->getCurrentIndex())); // end library
@@ -214,6 +224,31 @@ void LibraryParse::parseFile() {
 	} while (true); // end file
 }
 
+// Hand the parsed (or cached) gates to the app:
+void LibraryParse::registerGates() {
+	map < string, map < string, LibraryGate > >::iterator libWalk = gates.begin();
+	while (libWalk != gates.end()) {
+		map < string, LibraryGate >::iterator gateWalk = (libWalk->second).begin();
+		while (gateWalk != (libWalk->second).end()) {
+			LibraryGate &newGate = gateWalk->second;
+			if (newGate.caption == "Inverter" && (time(0) % 1001 == 0)) { // Easter egg, rename inverters once in a while :)
+				newGate.caption = "Santa Hat (Inverter)";
+			}
+			wxGetApp().gateNameToLibrary[newGate.gateName] = libWalk->first;
+			wxGetApp().libraries[libWalk->first][newGate.gateName] = newGate;
+			gateWalk++;
+		}
+		libWalk++;
+	}
+}
+
+// The cache goes in the user's local (non-roaming) data folder:
+string LibraryParse::getCacheFile() {
+	wxFileName cacheFile(wxStandardPaths::Get().GetUserLocalDataDir(), "gatedefs.cache");
+	if (!cacheFile.DirExists() && !cacheFile.Mkdir(wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL)) return "";
+	return cacheFile.GetFullPath().ToStdString();
+}
+
 // Parse the shape object from the mParse file, adding an offset if needed:
 bool LibraryParse::parseShapeObject( string type, LibraryGate* newGate, double offX, double offY, bool isLabel ) {
 	float x1, y1, x2, y2;
@@ -36,6 +36,7 @@ MainApp::MainApp()
     showDragImage = false;
     mainframe = NULL;
     doingBitmapExport = false;
+    activityVisible = false;
 	glContext = NULL;
 #ifdef __WXGTK__
 	// On Linux with wayland, wxGTK doesn't position glCanvas frames correctly.
@@ -174,6 +175,7 @@ void MainApp::loadSettings() {
 	conf->Read("WireConnVisible", &appSettings.wireConnVisible, true);
 	conf->Read("GridlineVisible", &appSettings.gridlineVisible, true);
 	conf->Read("RightClickRotate", &appSettings.rightClickRotate, true);
+	conf->Read("UndoMemoryLimit", &appSettings.undoMemoryLimit, 256); // MB
 
 	// check screen coords
 	wxScreenDC sdc;
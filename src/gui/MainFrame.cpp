@@ -13,6 +13,7 @@
 #include "wx/filedlg.h"
 #include "wx/timer.h"
 #include "wx/wfstream.h"
+#include "wx/filefn.h"
 #include "wx/image.h"
 #include "wx/thread.h"
 #include "wx/toolbar.h"
@@ -63,6 +64,7 @@ BEGIN_EVENT_TABLE(MainFrame, wxFrame)
 	EVT_MENU(wxID_PASTE, MainFrame::OnPaste)
 	
     EVT_MENU(View_Oscope, MainFrame::OnOscope)
+    EVT_MENU(View_Activity, MainFrame::OnViewActivity)
     EVT_MENU(View_Gridline, MainFrame::OnViewGridline)
     EVT_MENU(View_WireConn, MainFrame::OnViewWireConn)
     EVT_MENU(View_RightClickRotate, MainFrame::OnViewRightClickRotate)
@@ -127,6 +129,7 @@ MainFrame::MainFrame(const wxString& title, string cmdFilename)
 
     wxMenu *viewMenu = new wxMenu; // VIEW MENU
     viewMenu->Append(View_Oscope, "&Oscope\tCtrl+G", "Show the Oscope");
+    viewMenu->AppendCheckItem(View_Activity, "Activity &Heat Map", "Tint gates and wires by how often they change");
     wxMenu *settingsMenu = new wxMenu;
     settingsMenu->AppendCheckItem(View_Gridline, "Display Gridlines", "Toggle gridline display");
     settingsMenu->AppendCheckItem(View_WireConn, "Display Wire Connection Points", "Toggle wire connection points");
@@ -189,6 +192,8 @@ MainFrame::MainFrame(const wxString& title, string cmdFilename)
 #endif
 	LibraryParse newLib(libPath);
 	wxGetApp().libParser = newLib;
+	// Any palette pictures were drawn from the old library:
+	wxGetApp().gateThumbnails.clear();
 	
 	//////////////////////////////////////////////////////////////////////////
     // create a toolbar
@@ -308,7 +313,7 @@ MainFrame::MainFrame(const wxString& title, string cmdFilename)
 	
 	// set up the panel and make canvases
 	gCircuit = new GUICircuit();
-	commandProcessor = new wxCommandProcessor();
+	commandProcessor = new klsCommandProcessor();
 	gCircuit->SetCommandProcessor(commandProcessor);
 	gCircuit->GetCommandProcessor()->SetEditMenu(editMenu);
 	gCircuit->GetCommandProcessor()->Initialize();
@@ -737,6 +742,16 @@ void MainFrame::OnOscope(wxCommandEvent& WXUNUSED(event)) {
 	}
 }
 
+void MainFrame::OnViewActivity(wxCommandEvent& event) {
+	wxGetApp().activityVisible = event.IsChecked();
+	if (!event.IsChecked()) {
+		wxMutexLocker lock(wxGetApp().activityMutex);
+		wxGetApp().gateActivity.clear();
+		wxGetApp().wireActivity.clear();
+	}
+	if (currentCanvas != NULL) currentCanvas->Update();
+}
+
 void MainFrame::OnViewGridline(wxCommandEvent& event) {
 	wxGetApp().appSettings.gridlineVisible = event.IsChecked();
 	if (currentCanvas != NULL) currentCanvas->Update();
@@ -758,6 +773,8 @@ void MainFrame::OnPreferences(wxCommandEvent& event) {
 		wxGetApp().appSettings.wireConnRadius = (float)dlg.getWireConnRadius();
 		wxGetApp().appSettings.gridlineVisible = dlg.getGridlineVisible();
 		wxGetApp().appSettings.refreshRate = dlg.getRefreshRate();
+		wxGetApp().appSettings.undoMemoryLimit = dlg.getUndoMemoryLimit();
+		commandProcessor->trimHistory();
 
 		// Sync menu checkmarks
 		GetMenuBar()->Check(View_Gridline, wxGetApp().appSettings.gridlineVisible);
@@ -1001,12 +1018,10 @@ void MainFrame::OnExportBitmap(wxCommandEvent& event) {
 	bool useNoColor = bwRadio->GetValue();
 	int multiplier = screen2x->GetValue() ? 2 : (print4x->GetValue() ? 4 : 6);
 
-	// Generate bitmap
-	wxBitmap bitmap = getBitmap(showGrid, useNoColor, multiplier);
-
 	// Handle action
 	if (result == wxID_APPLY) {
 		// Copy to clipboard
+		wxBitmap bitmap = getBitmap(showGrid, useNoColor, multiplier);
 		if (wxTheClipboard->Open()) {
 			wxTheClipboard->SetData(new wxBitmapDataObject(bitmap));
 			wxTheClipboard->Flush();
@@ -1039,7 +1054,19 @@ void MainFrame::OnExportBitmap(wxCommandEvent& event) {
 				else if (ext == "png") fileType = wxBITMAP_TYPE_PNG;
 				else fileType = wxBITMAP_TYPE_JPEG;
 
-				bitmap.SaveFile(path, fileType);
+				// PNG and BMP are written as they are rendered; JPEG still
+				// needs the whole image first
+				klsImageWriter* out = klsImageWriter::create(path, fileType);
+				bool success;
+				if (out != NULL) {
+					success = exportImageFile(path, *out, showGrid, useNoColor, multiplier);
+					delete out;
+				} else {
+					success = getBitmap(showGrid, useNoColor, multiplier).SaveFile(path, fileType);
+				}
+				if (!success) {
+					wxMessageBox("Failed to export image file.", "Export Error", wxOK | wxICON_ERROR);
+				}
 			}
 		}
 	}
@@ -1111,6 +1138,23 @@ wxBitmap MainFrame::getBitmap(bool withGrid, bool noColor, int multiplier) {
 	return circuitBitmap;
 }
 
+bool MainFrame::exportImageFile(const wxString& path, klsImageWriter& out, bool withGrid, bool noColor, int multiplier) {
+	bool gridlineVisible = wxGetApp().appSettings.gridlineVisible;
+	wxGetApp().appSettings.gridlineVisible = withGrid;
+	wxGetApp().doingBitmapExport = true;
+
+	wxSize imageSize = currentCanvas->GetClientSize();
+	bool success = currentCanvas->renderTiled(out, imageSize.GetWidth() * multiplier, imageSize.GetHeight() * multiplier, noColor);
+
+	// restore grid display setting
+	wxGetApp().appSettings.gridlineVisible = gridlineVisible;
+	wxGetApp().doingBitmapExport = false;
+
+	// Don't leave a partial image behind
+	if (!success) wxRemoveFile(path);
+	return success;
+}
+
 void MainFrame::OnPause(wxCommandEvent& event) {
 	PauseSim();
 }
@@ -1194,6 +1238,7 @@ void MainFrame::saveSettings() {
 	conf->Write("WireConnVisible", settings.wireConnVisible);
 	conf->Write("GridlineVisible", settings.gridlineVisible);
 	conf->Write("RightClickRotate", settings.rightClickRotate);
+	conf->Write("UndoMemoryLimit", settings.undoMemoryLimit);
 }
 
 void MainFrame::ResumeExecution() {
@@ -1258,8 +1303,14 @@ void MainFrame::resumeTimers(int at) {
 //Julian: All of the following functions were added to support autosave functionality.
 
 void MainFrame::autosave() {
-	// Attempt to autosave - if it fails, the user can still manually save
-	save(CRASH_FILENAME);
+	// Things may have changed since the autosave thread asked for this:
+	if (!fileIsDirty() || handlingEvent) return;
+
+	// Only copy the circuit's values here; the autosave thread formats and
+	// writes them, so neither editing nor the simulation waits on either:
+	circuitSnapshot snapshot;
+	CircuitParse::snapshotCircuit(canvases, 0, snapshot);
+	wxGetApp().saveThread->queueSnapshot(CRASH_FILENAME, snapshot);
 }
 
 bool MainFrame::save(string filename) {
@@ -1295,7 +1346,16 @@ bool MainFrame::fileIsDirty() {
 	return commandProcessor->IsDirty();
 }
 
+void MainFrame::showLogicStats(const CircuitStats& stats) {
+	ostringstream oss;
+	oss << "Steps: " << stats.steps << "  Events: " << stats.eventsProcessed
+		<< "  Gate updates: " << stats.gatesEvaluated << "  Queue peak: " << stats.queueHighWater;
+	SetStatusText(oss.str(), 1);
+}
+
 void MainFrame::removeTempFile() {
+	// Don't let a queued autosave put the file back afterward:
+	wxGetApp().saveThread->cancelSnapshot();
 	remove(CRASH_FILENAME.c_str());
 }
 
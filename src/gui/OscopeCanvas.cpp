@@ -35,6 +35,8 @@ OscopeCanvas::OscopeCanvas(wxWindow *parent, GUICircuit* gCircuit, wxWindowID id
 	this->gCircuit = gCircuit;
 	m_init = false;
 	parentFrame = (OscopeFrame*) parent;
+	sampleTime = 0;
+	bindingsValid = false;
 }
 
 OscopeCanvas::~OscopeCanvas(){ 
@@ -109,12 +111,8 @@ void OscopeCanvas::OnRender(double scaleOverride){
 	glEnd();
 
 	for (unsigned int i = 0; i < numberOfWires; i++) {
-		map< string, deque< StateType > >::iterator thisWire = stateValues.find(parentFrame->getFeedName(i).c_str());
-		if (thisWire == stateValues.end()) { wireNum++; continue; }
-		deque< StateType >::reverse_iterator wireVal = (thisWire->second).rbegin();
-		GLdouble horizLoc = OSCOPE_HORIZONTAL;
-		GLdouble y = 0.0, lastY = 0.0;
-		StateType theState;
+		map< string, OscopeTrace >::iterator thisWire = traces.find(parentFrame->getFeedName(i).c_str());
+		if (thisWire == traces.end()) { wireNum++; continue; }
 		
 		float intensity = (GLfloat) GRID_INTENSITY;
 		glColor4f( 0.0, 0.0, intensity, intensity );
@@ -125,64 +123,73 @@ void OscopeCanvas::OnRender(double scaleOverride){
 			glVertex2f( OSCOPE_HORIZONTAL, (wireNum * 1.5) + 1);
 		glEnd();
 	
-		bool firstTime = true;
-		bool solid = false;
-	
-		while(wireVal != ((thisWire->second).rend())) {
-			theState = *wireVal;
-	
-			solid = false;
-			switch( theState ) {
-			case ZERO:
-				glColor4f( 0.0, 0.0, 0.0, 1.0 );
-				y = 1.0 + wireNum * 1.5;
-				break;
-			case ONE:
-				glColor4f( 1.0, 0.0, 0.0, 1.0 );
-				y = 0.0 + wireNum * 1.5;
-				break;
-			case HI_Z:
-				glColor4f( 0.0, 0.78f, 0.0, 1.0 );
-				y = 0.5 + wireNum * 1.5;
-				break;
-			case UNKNOWN:
-				glColor4f( 0.3f, 0.3f, 1.0, 1.0 );
-				y = 0.75 + wireNum * 1.5;
-				solid = true;
-				break;
-			case CONFLICT:
-				glColor4f( 0.0, 1.0, 1.0, 1.0 );
-				y = 0.75 + wireNum * 1.5;
-				solid = true;
-				break;
-			}
-			
-			if( solid ) {
-				glRectd( horizLoc, y, horizLoc - 1.0, 0 + wireNum * 1.5) ;
-			} else {
-				glBegin(GL_LINES);
-				if(!firstTime && (lastY != y) ) {
-					// Rise:
-					glVertex2f( horizLoc, lastY );
-					glVertex2f( horizLoc, y );
-				}
-				firstTime = false;
-	
-				// Run:
-				glVertex2f( horizLoc, y );
-				glVertex2f( horizLoc - 1.0, y );
-				glEnd();
-			}
-			
-			// Move on to the next data point:
-			horizLoc -= 1.0;
-			lastY = y;
-			wireVal++;
-		}
+		drawTrace( thisWire->second, wireNum );
 		wireNum++;
 	} // for
 }
 
+void OscopeCanvas::drawTrace( const OscopeTrace& trace, unsigned int wireNum ) {
+	// Walk the runs from the newest (at the right edge) to the oldest,
+	// stopping once they go off the left edge:
+	GLdouble runEnd = OSCOPE_HORIZONTAL;
+	GLdouble y = 0.0, lastY = 0.0;
+	bool firstTime = true;
+	bool solid = false;
+
+	for (int r = (int)trace.numRuns() - 1; r >= 0 && runEnd > 0; r--) {
+		const OscopeTrace::run& thisRun = trace.getRun(r);
+		GLdouble runStart = OSCOPE_HORIZONTAL - (GLdouble)(sampleTime - thisRun.startTime);
+		if (runStart < 0) runStart = 0;
+
+		solid = false;
+		switch( thisRun.state ) {
+		case ZERO:
+			glColor4f( 0.0, 0.0, 0.0, 1.0 );
+			y = 1.0 + wireNum * 1.5;
+			break;
+		case ONE:
+			glColor4f( 1.0, 0.0, 0.0, 1.0 );
+			y = 0.0 + wireNum * 1.5;
+			break;
+		case HI_Z:
+			glColor4f( 0.0, 0.78f, 0.0, 1.0 );
+			y = 0.5 + wireNum * 1.5;
+			break;
+		case UNKNOWN:
+			glColor4f( 0.3f, 0.3f, 1.0, 1.0 );
+			y = 0.75 + wireNum * 1.5;
+			solid = true;
+			break;
+		case CONFLICT:
+			glColor4f( 0.0, 1.0, 1.0, 1.0 );
+			y = 0.75 + wireNum * 1.5;
+			solid = true;
+			break;
+		}
+		
+		if( solid ) {
+			glRectd( runEnd, y, runStart, 0 + wireNum * 1.5) ;
+		} else {
+			glBegin(GL_LINES);
+			if(!firstTime && (lastY != y) ) {
+				// Rise:
+				glVertex2f( runEnd, lastY );
+				glVertex2f( runEnd, y );
+			}
+			firstTime = false;
+
+			// Run:
+			glVertex2f( runEnd, y );
+			glVertex2f( runStart, y );
+			glEnd();
+		}
+		
+		// Move on to the next (older) run:
+		runEnd = runStart;
+		lastY = y;
+	}
+}
+
 void OscopeCanvas::OnPaint(wxPaintEvent& event){ 
 	wxPaintDC dc(this);
 	wxGetApp().SetCurrentCanvas(this);
@@ -211,104 +218,94 @@ void OscopeCanvas::OnPaint(wxPaintEvent& event){
 }
 
 void OscopeCanvas::UpdateData(void){
-	//Declaration of variables
-	deque<StateType> temp;
+	// Only look for the TO gates again if the feeds or gates have changed:
+	bool feedsChanged = !bindingsValid || boundFeeds.size() != parentFrame->numberOfFeeds();
+	for (unsigned int i = 0; i < boundFeeds.size() && !feedsChanged; i++) {
+		feedsChanged = (boundFeeds[i] != parentFrame->getFeedName(i));
+	}
+	if (feedsChanged) bindFeeds();
 
-	// Log the values of all of the gates:
+	// Log the values of the traced wires:
 	unordered_map< unsigned long, guiGate* >* gateList = gCircuit->getGates();
-	unordered_map< unsigned long, guiGate* >::iterator theGate;
-	
-	set< string > liveTOs;
-	vector < guiGate* > toGates;
-	if (parentFrame->numberOfFeeds() > 0) {
-		// Set up a list of TO gates so I only search the whole gate list once.
-		theGate = gateList->begin();
-		while (theGate != gateList->end()) {
-			if ((theGate->second)->getGUIType() == "TO") toGates.push_back(theGate->second);
-			theGate++;
+	for (unsigned int i = 0; i < bindings.size(); i++) {
+		unordered_map< unsigned long, guiGate* >::iterator theGate = gateList->find(bindings[i].gateID);
+		if (theGate == gateList->end()) {
+			// The TO is gone, so look again next time:
+			bindingsValid = false;
+			continue;
+		}
+
+		// Get the wire connected to the TO's input:
+		if( (theGate->second)->isConnected(bindings[i].input) ) {
+			guiWire* myWire = (theGate->second)->getConnection( bindings[i].input );
+			bindings[i].trace->addSample(sampleTime, myWire->getState()[0]);
+		} else {
+			// The TO is not connected, so the state is UNKNOWN:
+			bindings[i].trace->addSample(sampleTime, UNKNOWN);
 		}
 	}
+	sampleTime++;
+	
+	Refresh();
+	//Render();
+}
 
-	//Check to see if wire has already been added to OSCOPE
-	map< string, bool > hasBeenAdded;
+void OscopeCanvas::bindFeeds(void){
+	bindings.clear();
 
-	for (unsigned int i = 0; i < parentFrame->numberOfFeeds(); i++) {
+	set< string > liveTOs;
+
+	unsigned int i = 0;
+	while (i < parentFrame->numberOfFeeds()) {
 		string junctionName = parentFrame->getFeedName(i).c_str();
-		if (junctionName == NONE_STR || junctionName == "") continue;
-			
-		if(hasBeenAdded.find(junctionName) == hasBeenAdded.end()) {
-			hasBeenAdded[junctionName] = true;
-			// Keep track of all junction names that are still valid.
-			// If a gate disappears or changes junction names, then
-			// we want to remove it from our data structure.
-			liveTOs.insert(junctionName);
-
-			// Create a new storage space for its data if we need it:
-			if( stateValues.find(junctionName) == stateValues.end() ) {
-				stateValues[junctionName] = temp;
-			}
-			
-			// Get the first input in the TO's library description:
-			// (It only has one input, and that's its only connection.)
-			// Return the map of hotspot names to their coordinates:
-/*			theGate = gateList->begin();
-			while (theGate != gateList->end()) {
-				if ((theGate->second)->getGUIType() == "TO" && (theGate->second)->getLogicParam("JUNCTION_ID") == junctionName) break;
-				theGate++;
-			} */
-			// Search through our prebuilt TO gate list for this gate.
-			//	From UpdateMenu, the gate should exist.
-			guiGate* currentGate = NULL;
-			for (unsigned int j = 0; j < toGates.size(); j++) {
-				if (toGates[j]->getLogicParam("JUNCTION_ID") == junctionName) {
-					currentGate = toGates[j];
-					break;
-				}
-			}
-			if (currentGate == NULL) { // Just in case of error
-				stateValues.erase(junctionName);
-				parentFrame->cancelFeed(i);
-				//parentFrame->comboBoxVector[i]->SetValue("[None]");
-				continue;
-			}
-			
-			map<string, GLPoint2f> hsList = currentGate->getHotspotList();
-			if( hsList.size() != 0 ) {
-				string firstInput = (hsList.begin())->first;
-
-				// Get the wire connected to the TO's input:
-				if( currentGate->isConnected(firstInput) ) {
-					guiWire* myWire = currentGate->getConnection( firstInput );
-					
-					// Push the current state onto this TO's data queue:
-					stateValues[junctionName].push_back(myWire->getState()[0]);
-				} else {
-					// The TO is not connected, so the state is UNKNOWN:
-					stateValues[junctionName].push_back(UNKNOWN); 
-				}
-			}
-			
-			// If the data queue is too big, then pop data off the other
-			// end of the queue to make it the right size:
-			if(stateValues[junctionName].size() > OSCOPE_HORIZONTAL) stateValues[junctionName].pop_front();
+		if (junctionName == NONE_STR || junctionName == "" || liveTOs.find(junctionName) != liveTOs.end()) {
+			i++;
+			continue;
 		}
-	} // for ( not end of list )
-	
+
+		// Look up the TO gate by its junction name.
+		//	From UpdateMenu, the gate should exist.
+		vector< guiGate* > toGates = gCircuit->findGatesByName("TO", junctionName);
+		guiGate* currentGate = toGates.empty() ? NULL : toGates[0];
+		if (currentGate == NULL) { // Just in case of error
+			// (This removes the feed, so the next one moves up to i.)
+			parentFrame->cancelFeed(i);
+			continue;
+		}
+
+		// Keep track of all junction names that are still valid.
+		// If a gate disappears or changes junction names, then
+		// we want to remove it from our data structure.
+		liveTOs.insert(junctionName);
+
+		// Get the first input in the TO's library description:
+		// (It only has one input, and that's its only connection.)
+		map<string, GLPoint2f> hsList = currentGate->getHotspotList();
+		if( hsList.size() != 0 ) {
+			feedBinding binding;
+			binding.gateID = currentGate->getID();
+			binding.input = (hsList.begin())->first;
+			// (Creates a new storage space for its data if we need it.)
+			binding.trace = &(traces[junctionName]);
+			bindings.push_back(binding);
+		}
+		i++;
+	}
 	
-	// Clear out data queues for TOs that don't exist anymore:
-	map< string, deque< StateType > >::iterator checkData = stateValues.begin();
-	while( checkData != stateValues.end() ) {
+	// Clear out data for TOs that don't exist anymore:
+	map< string, OscopeTrace >::iterator checkData = traces.begin();
+	while( checkData != traces.end() ) {
 		if( liveTOs.find( checkData->first ) == liveTOs.end() ) {
-			stateValues.erase( checkData );
-			checkData = stateValues.begin();
+			checkData = traces.erase( checkData );
 		}
 		else {
 			checkData++;
 		}
 	}
-	
-	Refresh();
-	//Render();
+
+	boundFeeds.clear();
+	for (i = 0; i < parentFrame->numberOfFeeds(); i++) boundFeeds.push_back(parentFrame->getFeedName(i));
+	bindingsValid = true;
 }
 
 
@@ -320,6 +317,9 @@ void OscopeCanvas::OnEraseBackground(wxEraseEvent& WXUNUSED(event))
 
 void OscopeCanvas::UpdateMenu()
 {
+	// The TO gates may have changed, so find the feeds' gates again:
+	bindingsValid = false;
+
 	//*******************************
 	//Edit by Joshua Lansford 3/11/07
 	//This edit is to retrofit this
@@ -336,26 +336,25 @@ void OscopeCanvas::UpdateMenu()
 	
 	vector< string > namesOfPossableFeeds;
 	
-	map< string, bool > alreadyAdded;
+	set< string > alreadyAdded;
 	
-	//iterate over all gates
-	for( unordered_map< unsigned long, guiGate* >::iterator 
-	       gateIterator = gateList->begin(); 
-	       gateIterator != gateList->end(); 
+	//iterate over just the TO gates
+	const set< unsigned long >& toGates = gCircuit->getGatesOfType( "TO" );
+	for( set< unsigned long >::const_iterator 
+	       gateIterator = toGates.begin(); 
+	       gateIterator != toGates.end(); 
 	       gateIterator++ ){
-	   guiGate* aGate = gateIterator->second;
-	   //select out the gates which are TOs
-	   if( aGate->getGUIType() == "TO" ){
-	   		string feedName;        
-	   		feedName = aGate->getLogicParam("JUNCTION_ID");
-	   		
-	   		//check if it has already been added
-	   		if( alreadyAdded.find( feedName ) == alreadyAdded.end() ){
-	   			
-	   			//add name to list
-	   			namesOfPossableFeeds.push_back( feedName );
-	   			alreadyAdded[ feedName ] = true;
-	   		}
+	   unordered_map< unsigned long, guiGate* >::iterator aGate = gateList->find( *gateIterator );
+	   if( aGate == gateList->end() ) continue;
+
+	   string feedName;        
+	   feedName = aGate->second->getLogicParam("JUNCTION_ID");
+	   
+	   //check if it has already been added
+	   if( alreadyAdded.insert( feedName ).second ){
+	   	
+	   	//add name to list
+	   	namesOfPossableFeeds.push_back( feedName );
 	   }
 	}
 	
@@ -272,15 +272,9 @@ void OscopeFrame::updatePossableFeeds( vector< string >* newPossabilities ){
 	availableFeeds = *newPossabilities;
 
 	// Remove any active feeds that are no longer valid
+	set< string > available( availableFeeds.begin(), availableFeeds.end() );
 	for (int i = (int)feedNames.size() - 1; i >= 0; --i) {
-		bool found = false;
-		for (unsigned int j = 0; j < availableFeeds.size(); ++j) {
-			if (availableFeeds[j] == feedNames[i]) {
-				found = true;
-				break;
-			}
-		}
-		if (!found) {
+		if (available.find(feedNames[i]) == available.end()) {
 			removeFeed(i);
 		}
 	}
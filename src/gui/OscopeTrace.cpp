@@ -0,0 +1,41 @@
+/*****************************************************************************
+   Project: CEDAR Logic Simulator
+   Copyright 2006 Cedarville University, Benjamin Sprague,
+                     Matt Lewellyn, and David Knierim
+   All rights reserved.
+   For license information see license.txt included with distribution.
+
+   OscopeTrace: Run-length encoded history of one oscope signal
+*****************************************************************************/
+
+#include "OscopeTrace.h"
+
+OscopeTrace::OscopeTrace() : runs( OSCOPE_TRACE_RUNS ) {
+	first = 0;
+	count = 0;
+}
+
+void OscopeTrace::addSample( unsigned long time, StateType state ) {
+	if( count > 0 && getRun( count - 1 ).state == state ) return;
+
+	unsigned int next;
+	if( count < runs.size() ) {
+		next = (first + count) % runs.size();
+		count++;
+	} else {
+		// Full, so write over the oldest run:
+		next = first;
+		first = (first + 1) % runs.size();
+	}
+	runs[next].startTime = time;
+	runs[next].state = state;
+}
+
+void OscopeTrace::clear( void ) {
+	first = 0;
+	count = 0;
+}
+
+const OscopeTrace::run& OscopeTrace::getRun( unsigned int i ) const {
+	return runs[(first + i) % runs.size()];
+}
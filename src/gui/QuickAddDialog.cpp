@@ -27,6 +27,10 @@ QuickAddDialog::QuickAddDialog(wxWindow* parent)
 			entry.gateName = gatePair.first;
 			entry.caption = gatePair.second.caption;
 			entry.libraryName = libPair.first;
+			entry.lowerName = klsPrefixTrie::fold(entry.gateName);
+			entry.lowerCaption = klsPrefixTrie::fold(entry.caption);
+			gateTrie.insert(entry.gateName, allGates.size());
+			gateTrie.insert(entry.caption, allGates.size());
 			allGates.push_back(entry);
 		}
 	}
@@ -138,12 +142,9 @@ void QuickAddDialog::updatePreview() {
 	}
 }
 
-int QuickAddDialog::fuzzyScore(const string& query, const string& target) {
-	if (query.empty()) return 0;
-
-	string lowerQuery, lowerTarget;
-	for (char c : query) lowerQuery += tolower(c);
-	for (char c : target) lowerTarget += tolower(c);
+// (Both strings must already be lowercase.)
+int QuickAddDialog::fuzzyScore(const string& lowerQuery, const string& lowerTarget) {
+	if (lowerQuery.empty()) return 0;
 
 	// Exact substring match gets highest score
 	if (lowerTarget.find(lowerQuery) != string::npos) {
@@ -184,29 +185,60 @@ void QuickAddDialog::updateList(const string& query) {
 	};
 	vector<ScoredEntry> scored;
 
-	for (auto& entry : allGates) {
+	string lowerQuery = klsPrefixTrie::fold(query);
+
+	// Narrow down the gates to score: a longer version of the last query
+	// only needs to look at the last matches
+	vector<size_t> candidates;
+	if (!lastQuery.empty() && lowerQuery.compare(0, lastQuery.size(), lastQuery) == 0) {
+		candidates = lastMatches;
+	} else {
+		for (size_t i = 0; i < allGates.size(); i++) candidates.push_back(i);
+	}
+
+	// Names and captions that start with the query are the best matches,
+	// and come straight from the trie without scoring
+	vector<bool> isPrefixMatch(allGates.size(), false);
+	if (!lowerQuery.empty()) {
+		vector<size_t> prefixMatches;
+		gateTrie.find(lowerQuery, prefixMatches);
+		for (size_t i : prefixMatches) isPrefixMatch[i] = true;
+	}
+
+	vector<size_t> matches;
+	for (size_t i : candidates) {
+		GateEntry& entry = allGates[i];
+
 		// Score against both caption and gate name
-		int captionScore = fuzzyScore(query, entry.caption);
-		int nameScore = fuzzyScore(query, entry.gateName);
-		int bestScore = max(captionScore, nameScore);
+		int bestScore = 100;
+		if (!isPrefixMatch[i]) {
+			int captionScore = fuzzyScore(lowerQuery, entry.lowerCaption);
+			int nameScore = fuzzyScore(lowerQuery, entry.lowerName);
+			bestScore = max(captionScore, nameScore);
+		}
 
-		if (query.empty() || bestScore > 0) {
+		if (lowerQuery.empty() || bestScore > 0) {
 			string display = entry.caption;
 			if (entry.caption != entry.gateName) {
 				display += "  [" + entry.gateName + "]";
 			}
 			scored.push_back({bestScore, display, entry.gateName});
+			matches.push_back(i);
 		}
 	}
+	lastQuery = lowerQuery;
+	lastMatches = matches;
 
 	// Sort by score descending
-	sort(scored.begin(), scored.end(), [](const ScoredEntry& a, const ScoredEntry& b) {
+	stable_sort(scored.begin(), scored.end(), [](const ScoredEntry& a, const ScoredEntry& b) {
 		return a.score > b.score;
 	});
 
+	resultList->Freeze();
 	for (auto& s : scored) {
 		resultList->Append(s.displayText, new wxStringClientData(s.gateName));
 	}
+	resultList->Thaw();
 
 	if (resultList->GetCount() > 0) {
 		resultList->SetSelection(0);
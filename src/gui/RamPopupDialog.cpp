@@ -8,6 +8,8 @@
 #include <ostream>
 #include <sstream>
 #include <iomanip>
+#include <cmath>
+#include <algorithm>
 #include <wx/sizer.h>
 #include "RamPopupDialog.h"
 #include "guiGate.h"
@@ -16,6 +18,14 @@
 //#define LIST_ID (wxID_HIGHEST + 1)
 #define ID_CHECKBOX (wxID_HIGHEST + 1)
 #define ID_MEMCONTENTS (wxID_HIGHEST + 2)
+#define ID_REFRESH_TIMER (wxID_HIGHEST + 3)
+
+//Past this many changed addresses in one refresh tick,
+//it is cheaper to redraw the whole grid than cell by cell
+#define RAM_REFRESH_MAX_CELLS 256
+
+//Space (in pixels) around the widest value in a column
+#define RAM_CELL_PADDING 6
 //#define ID_EDIT (wxID_HIGHEST + 4)
 
 
@@ -32,6 +42,8 @@ RamPopupDialog::RamPopupDialog( guiGateRAM* newM_guiGateRAM,
 {
 	m_guiGateRAM = newM_guiGateRAM;
 	gUICircuit = newGUICircuit;
+	allChanged = false;
+	refreshTimer.SetOwner( this, ID_REFRESH_TIMER );
 	
 	
 	int bitsInData;
@@ -66,11 +78,18 @@ RamPopupDialog::RamPopupDialog( guiGateRAM* newM_guiGateRAM,
 	
 	topSizer->Add( buttonSizer,wxSizerFlags(0).Align(0).Border(wxALL, 5 ));
 	
+	//Size the columns to fit the widest value, in hex or
+	//decimal, rather than auto sizing them, which reads
+	//every cell in the memory
+	int decimalDigits = (int)ceil( bitsInData * log10( 2.0 ) );
+	int widestValue = max( dataSize, decimalDigits );
+	wxFont cellFont = memContents->GetDefaultCellFont();
+	int textWidth, textHeight;
+	memContents->GetTextExtent( wxString( '0', widestValue ), &textWidth, &textHeight, NULL, NULL, &cellFont );
+	memContents->SetDefaultColSize( textWidth + 2 * RAM_CELL_PADDING, true );
+
 	SetSizer( topSizer );
 	topSizer->SetSizeHints( this );
-
-	notifyAllChanged();
-	memContents->AutoSizeColumns(true);
 }
 
 void RamPopupDialog::OnBtnClose( wxCommandEvent& event ){
@@ -118,11 +137,18 @@ BEGIN_EVENT_TABLE(RamPopupDialog, wxDialog)
 	EVT_BUTTON(wxID_OPEN, RamPopupDialog::OnBtnLoad)
 	EVT_BUTTON(wxID_SAVE, RamPopupDialog::OnBtnSave)
 	EVT_CHECKBOX(ID_CHECKBOX, RamPopupDialog::OnChkBox)
+	EVT_TIMER(ID_REFRESH_TIMER, RamPopupDialog::OnRefreshTimer)
 END_EVENT_TABLE()
 
-//This is called by the guiGateRAM when an item changes
-void RamPopupDialog::updateGridDisplay(){
-	memContents->Refresh();
+//This is called by the guiGateRAM when the value or
+//highlight of an address changes.  The RAM can change
+//many times between frames, so we only note the address
+//here and redraw the cells on the next refresh tick
+void RamPopupDialog::updateGridDisplay( long address ){
+	if( address >= 0 )
+		changedAddresses.insert( address );
+	if( !refreshTimer.IsRunning() )
+		refreshTimer.StartOnce( RAM_REFRESH_INTERVAL );
 }
 
 //This gets called by the guiGate when the logicGate
@@ -134,7 +160,28 @@ void RamPopupDialog::notifyAllChanged(){
 	//we switch to and from decimal.
 	//Also, in decimal, it is full of zeros, so if they put any
 	//number in besides a single digit, it will not fit :-P
-	memContents->Refresh();
+	allChanged = true;
+	if( !refreshTimer.IsRunning() )
+		refreshTimer.StartOnce( RAM_REFRESH_INTERVAL );
+}
+
+void RamPopupDialog::OnRefreshTimer( wxTimerEvent& event ){
+	//A hidden grid is redrawn in full when it is shown
+	//again, since the values are read as cells are drawn
+	if( IsShown() ){
+		if( allChanged || changedAddresses.size() > RAM_REFRESH_MAX_CELLS ){
+			memContents->ForceRefresh();
+		}else{
+			for( set< long >::iterator address = changedAddresses.begin();
+			     address != changedAddresses.end(); ++address ){
+				int row = *address / 16;
+				int col = *address % 16;
+				memContents->RefreshBlock( row, col, row, col );
+			}
+		}
+	}
+	changedAddresses.clear();
+	allChanged = false;
 }
 
 
@@ -149,11 +196,21 @@ virtualGrid::virtualGrid (int addrSize, int dSize, guiGateRAM* newM_ramGuiGate,
 	addressSize = addrSize;
 	dataSize = dSize;
 	gUICircuit = newGUICircuit;
+
+	readAttr = new wxGridCellAttr();
+	readAttr->SetBackgroundColour( *wxGREEN );
+	writtenAttr = new wxGridCellAttr();
+	writtenAttr->SetBackgroundColour( *wxRED );
+}
+
+virtualGrid::~virtualGrid () {
+	readAttr->DecRef();
+	writtenAttr->DecRef();
 }
 
 
 int virtualGrid::GetNumberRows () {
-	return (int)pow((float)2,(int)addressSize*4)/16;
+	return (int)((1ULL << (addressSize*4)) / 16);
 }
 
 int virtualGrid::GetNumberCols () {
@@ -165,15 +222,14 @@ bool virtualGrid::IsEmptyCell (int row, int col) {
 }
 
 wxString virtualGrid::GetValue (int row, int col) {
-	ostringstream stream;
-		
+	//Only the cells on screen are asked for, so the
+	//value is looked up right when it is drawn
 	unsigned long data = m_guiGateRAM->getValueAt( row*16 + col );
 	if (hexOrDecCB->IsChecked()) {
-		stream << dec << data;
+		return wxString::Format( "%lu", data );
 	} else {
-		stream << hex << uppercase << setw ( dataSize ) << setfill ( '0' ) << data;
+		return wxString::Format( "%0*lX", dataSize, data );
 	}
-	return stream.str();
 }
 
 void virtualGrid::SetValue (int row, int col, const wxString& value) {
@@ -213,16 +269,19 @@ wxGridCellAttr* virtualGrid::GetAttr(int row, int col, wxGridCellAttr::wxAttrKin
 	int writtenRow = writtenAddress / 16;
 	
 	
-	wxGridCellAttr* returnValue = new wxGridCellAttr();
+	//The grid releases the attr it is given, so hand out
+	//another reference to the shared one.  Other cells
+	//get the grid's default (white) attr
+	wxGridCellAttr* returnValue = NULL;
 	
 	if( row == readRow && col == readCol ){
-		returnValue->SetBackgroundColour( *wxGREEN ); 
+		returnValue = readAttr;
 	}else if( row == writtenRow && col == writtenCol ){
-		returnValue->SetBackgroundColour( *wxRED );
-	}else{
-		returnValue->SetBackgroundColour( *wxWHITE );	
+		returnValue = writtenAttr;
 	}
 	
+	if( returnValue != NULL )
+		returnValue->IncRef();
 	return returnValue;
 }
 
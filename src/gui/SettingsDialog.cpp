@@ -10,7 +10,7 @@ SettingsDialog::SettingsDialog(wxWindow* parent)
 
 	auto& settings = wxGetApp().appSettings;
 
-	wxFlexGridSizer* grid = new wxFlexGridSizer(4, 2, 8, 12);
+	wxFlexGridSizer* grid = new wxFlexGridSizer(5, 2, 8, 12);
 	grid->AddGrowableCol(1, 1);
 
 	grid->Add(new wxStaticText(this, wxID_ANY, "Wire Connection Points"), 0, wxALIGN_CENTER_VERTICAL);
@@ -32,6 +32,10 @@ SettingsDialog::SettingsDialog(wxWindow* parent)
 	refreshRateCtrl = new wxSpinCtrl(this, wxID_ANY, "", wxDefaultPosition, wxDefaultSize, wxSP_ARROW_KEYS, 10, 1000, currentFps);
 	grid->Add(refreshRateCtrl, 0, wxEXPAND);
 
+	grid->Add(new wxStaticText(this, wxID_ANY, "Undo History Limit (MB, 0 = none)"), 0, wxALIGN_CENTER_VERTICAL);
+	undoMemoryLimitCtrl = new wxSpinCtrl(this, wxID_ANY, "", wxDefaultPosition, wxDefaultSize, wxSP_ARROW_KEYS, 0, 65536, settings.undoMemoryLimit);
+	grid->Add(undoMemoryLimitCtrl, 0, wxEXPAND);
+
 	wxBoxSizer* topSizer = new wxBoxSizer(wxVERTICAL);
 	topSizer->Add(grid, 1, wxALL | wxEXPAND, 16);
 	topSizer->Add(CreateStdDialogButtonSizer(wxOK | wxCANCEL), 0, wxALL | wxEXPAND, 8);
@@ -46,3 +50,4 @@ int SettingsDialog::getRefreshRate() const {
 	int fps = refreshRateCtrl->GetValue();
 	return (fps > 0) ? 1000 / fps : 16;
 }
+int SettingsDialog::getUndoMemoryLimit() const { return undoMemoryLimitCtrl->GetValue(); }
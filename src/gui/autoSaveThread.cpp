@@ -6,12 +6,14 @@
 #include <string>
 #include "MainFrame.h"
 #include "MainApp.h"
+#include "CircuitParse.h"
 
 DECLARE_APP(MainApp)
 
 autoSaveThread::autoSaveThread() : wxThread()
 {
-
+	hasSnapshot = false;
+	cancelCount = 0;
 }
 
 void *autoSaveThread::Entry()
@@ -34,10 +36,13 @@ void *autoSaveThread::Entry()
 		{
 			if (frame != NULL && frame->fileIsDirty() && !frame->isHandlingEvent())
 			{
-				frame->autosave();
+				// The circuit can only be read on the GUI thread, so it
+				// takes the snapshot and queues it back to us:
+				frame->CallAfter(&MainFrame::autosave);
 			}
 			time(&timeout);
 		}
+		writeSnapshot();
 		Sleep(10);
 	}
 	frame = NULL;
@@ -47,4 +52,45 @@ void *autoSaveThread::Entry()
 void autoSaveThread::OnExit()
 {
 
+}
+
+void autoSaveThread::queueSnapshot(const string& filename, const circuitSnapshot& snapshot)
+{
+	wxMutexLocker lock(snapshotMutex);
+	snapshotFile = filename;
+	this->snapshot = snapshot;
+	hasSnapshot = true;
+}
+
+void autoSaveThread::cancelSnapshot()
+{
+	wxMutexLocker lock(snapshotMutex);
+	hasSnapshot = false;
+	snapshot.pages.clear();
+	cancelCount++;
+}
+
+void autoSaveThread::writeSnapshot()
+{
+	string filename;
+	circuitSnapshot circuit;
+	unsigned long takenAt;
+	{
+		wxMutexLocker lock(snapshotMutex);
+		if (!hasSnapshot) return;
+		hasSnapshot = false;
+		filename = snapshotFile;
+		circuit.currPage = snapshot.currPage;
+		circuit.pages.swap(snapshot.pages);
+		takenAt = cancelCount;
+	}
+
+	// The formatting only reads our copy, so the GUI can keep going:
+	CircuitParse cirp((GUICanvas*)NULL);
+	string circuitXML = cirp.serializeCircuit(circuit);
+
+	wxMutexLocker lock(snapshotMutex);
+	if (takenAt != cancelCount) return;
+	// If this fails, the user can still save manually:
+	cirp.writeCircuit(filename, circuitXML, true);
 }
\ No newline at end of file
@@ -8,14 +8,14 @@
 
 DECLARE_APP(MainApp)
 
-cmdCreateGate::cmdCreateGate(GUICanvas* gCanvas, GUICircuit* gCircuit, unsigned long gid, string gateType, float x, float y) : klsCommand(true, "Create Gate") {
+cmdCreateGate::cmdCreateGate(GUICanvas* gCanvas, GUICircuit* gCircuit, unsigned long gid, string gateType, float x, float y, bool fromString) : klsCommand(true, "Create Gate") {
 	this->gCanvas = gCanvas;
 	this->gCircuit = gCircuit;
 	this->gid = gid;
 	this->gateType = gateType;
 	this->x = x;
 	this->y = y;
-	this->fromString = false;
+	this->fromString = fromString;
 }
 
 cmdCreateGate::cmdCreateGate(string def) : klsCommand(true, "Create Gate") {
@@ -25,6 +25,10 @@ cmdCreateGate::cmdCreateGate(string def) : klsCommand(true, "Create Gate") {
 	this->fromString = true;
 }
 
+cmdCreateGate::~cmdCreateGate() {
+	for (unsigned int i = 0; i < proxconnects.size(); i++) delete proxconnects[i];
+}
+
 bool cmdCreateGate::Do() {
 	if (wxGetApp().libraries.size() == 0) return false; // No library loaded, so can't create gate
 
@@ -112,6 +116,10 @@ void cmdCreateGate::setPointers(GUICircuit* gCircuit, GUICanvas* gCanvas,
 	this->gCanvas = gCanvas;
 }
 
+size_t cmdCreateGate::getMemorySize() const {
+	return sizeof(*this) + gateType.capacity() + sumMemorySize(proxconnects);
+}
+
 std::vector<klsCommand *> * cmdCreateGate::getConnections() {
 	return &proxconnects;
 }
\ No newline at end of file
@@ -109,6 +109,11 @@ std::string cmdCreateWire::toString() const {
 	return oss.str();
 }
 
+size_t cmdCreateWire::getMemorySize() const {
+	return sizeof(*this) + wireIds.capacity() * sizeof(IDType) +
+		conn1->getMemorySize() + conn2->getMemorySize();
+}
+
 void cmdCreateWire::setPointers(GUICircuit* gCircuit, GUICanvas* gCanvas,
 	TranslationMap &gateids, TranslationMap &wireids) {
 
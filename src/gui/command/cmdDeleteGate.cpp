@@ -129,7 +129,12 @@ bool cmdDeleteGate::Undo() {
 
 	while (!(cmdList.empty())) {
 		cmdList.top()->Undo();
+		delete cmdList.top();
 		cmdList.pop();
 	}
 	return true;
-}
\ No newline at end of file
+}
+
+size_t cmdDeleteGate::getMemorySize() const {
+	return sizeof(*this) + gateType.capacity() + sumMemorySize(cmdList);
+}
@@ -48,4 +48,8 @@ bool cmdDeleteSelection::Undo() {
 	}
 	if (gCircuit->getOscope() != NULL) gCircuit->getOscope()->UpdateMenu();
 	return true;
-}
\ No newline at end of file
+}
+
+size_t cmdDeleteSelection::getMemorySize() const {
+	return sizeof(*this) + (gates.capacity() + wires.capacity()) * sizeof(unsigned long) + sumMemorySize(cmdList);
+}
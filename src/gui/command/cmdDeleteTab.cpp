@@ -83,7 +83,12 @@ bool cmdDeleteTab::Undo() {
 	}
 	while (!(cmdList.empty())) {
 		cmdList.top()->Undo();
+		delete cmdList.top();
 		cmdList.pop();
 	}
 	return true;
-}
\ No newline at end of file
+}
+
+size_t cmdDeleteTab::getMemorySize() const {
+	return sizeof(*this) + (gates.capacity() + wires.capacity()) * sizeof(unsigned long) + sumMemorySize(cmdList);
+}
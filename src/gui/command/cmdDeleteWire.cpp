@@ -70,4 +70,8 @@ bool cmdDeleteWire::Undo() {
 	gCanvas->insertWire(gWire);
 
 	return true;
-}
\ No newline at end of file
+}
+
+size_t cmdDeleteWire::getMemorySize() const {
+	return sizeof(*this) + wireIds.capacity() * sizeof(IDType) + sumMemorySize(cmdList);
+}
@@ -15,7 +15,7 @@ cmdMoveSelection::cmdMoveSelection(GUICircuit* gCircuit,
 		wireList.push_back(preMoveWire[i].id);
 		if ((gCircuit->getWires())->find(preMoveWire[i].id) == (gCircuit->getWires())->end()) continue; // error, wire not found
 		oldSegMaps[preMoveWire[i].id] = preMoveWire[i].oldWireTree;
-		newSegMaps[preMoveWire[i].id] = (*(gCircuit->getWires()))[preMoveWire[i].id]->getSegmentMap();
+		newSegDeltas[preMoveWire[i].id] = klsSegmentDelta(preMoveWire[i].oldWireTree, (*(gCircuit->getWires()))[preMoveWire[i].id]->getSegmentMap());
 	}
 
 	this->gCircuit = gCircuit;
@@ -26,6 +26,10 @@ cmdMoveSelection::cmdMoveSelection(GUICircuit* gCircuit,
 	wireMove = 1;
 }
 
+cmdMoveSelection::~cmdMoveSelection() {
+	for (unsigned int i = 0; i < proxconnects.size(); i++) delete proxconnects[i];
+}
+
 bool cmdMoveSelection::Do() {
 
 	for (unsigned int i = 0; i < gateList.size(); i++) {
@@ -35,7 +39,7 @@ bool cmdMoveSelection::Do() {
 	}
 	for (unsigned int i = 0; i < wireList.size(); i++) {
 		if ((gCircuit->getWires())->find(wireList[i]) == (gCircuit->getWires())->end()) continue; // error, wire not found
-		(*(gCircuit->getWires()))[wireList[i]]->setSegmentMap(newSegMaps[wireList[i]]);
+		(*(gCircuit->getWires()))[wireList[i]]->setSegmentMap(newSegDeltas[wireList[i]].apply(oldSegMaps[wireList[i]]));
 	}
 	for (unsigned int i = 0; i < proxconnects.size(); i++) {
 		proxconnects[i]->Do();
@@ -60,6 +64,21 @@ bool cmdMoveSelection::Undo() {
 	return true;
 }
 
+size_t cmdMoveSelection::getMemorySize() const {
+	size_t size = sizeof(*this) + (gateList.capacity() + wireList.capacity()) * sizeof(unsigned long);
+	map<unsigned long, SegmentMap>::const_iterator oldWalk = oldSegMaps.begin();
+	while (oldWalk != oldSegMaps.end()) {
+		size += klsSegmentDelta::getMemorySize(oldWalk->second);
+		oldWalk++;
+	}
+	map<unsigned long, klsSegmentDelta>::const_iterator deltaWalk = newSegDeltas.begin();
+	while (deltaWalk != newSegDeltas.end()) {
+		size += (deltaWalk->second).getMemorySize();
+		deltaWalk++;
+	}
+	return size + sumMemorySize(proxconnects);
+}
+
 vector<klsCommand *> * cmdMoveSelection::getConnections() {
 	return &proxconnects;
 }
\ No newline at end of file
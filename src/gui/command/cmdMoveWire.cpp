@@ -3,6 +3,7 @@
 #include <sstream>
 #include "../GUICircuit.h"
 #include "../guiWire.h"
+#include "../klsSegmentDelta.h"
 
 cmdMoveWire::cmdMoveWire(GUICircuit* gCircuit, unsigned long wid,
 		const SegmentMap &oldList, const SegmentMap &newList) :
@@ -119,7 +120,8 @@ bool cmdMoveWire::Undo() {
 
 string cmdMoveWire::toString() const {
 
-	if ((gCircuit->getWires())->find(wid) == (gCircuit->getWires())->end()) return ""; // error, wire not found
+	// (Clipboard copies aren't tied to a circuit, so they skip the check.)
+	if (gCircuit != NULL && (gCircuit->getWires())->find(wid) == (gCircuit->getWires())->end()) return ""; // error, wire not found
 
 	ostringstream oss;
 	oss << "movewire " << wid << " ";
@@ -153,6 +155,10 @@ string cmdMoveWire::toString() const {
 	return oss.str();
 }
 
+size_t cmdMoveWire::getMemorySize() const {
+	return sizeof(*this) + klsSegmentDelta::getMemorySize(oldSegList) + klsSegmentDelta::getMemorySize(newSegList);
+}
+
 void cmdMoveWire::setPointers(GUICircuit* gCircuit, GUICanvas* gCanvas,
 		TranslationMap &gateids, TranslationMap &wireids) {
 
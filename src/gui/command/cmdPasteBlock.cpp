@@ -9,6 +9,11 @@ cmdPasteBlock::cmdPasteBlock(std::vector<klsCommand *> &cmdList) :
 	m_init = false;
 }
 
+cmdPasteBlock::~cmdPasteBlock() {
+
+	for (unsigned int i = 0; i < cmdList.size(); i++) delete cmdList[i];
+}
+
 bool cmdPasteBlock::Do() {
 
 	if (!m_init) {
@@ -16,7 +21,9 @@ bool cmdPasteBlock::Do() {
 		return true;
 	}
 
-	for (unsigned int i = 0; i < cmdList.size(); i++) cmdList[i]->Do();
+	for (unsigned int i = 0; i < cmdList.size(); i++) {
+		if (cmdList[i] != nullptr) cmdList[i]->Do();
+	}
 
 	return true;
 }
@@ -24,8 +31,12 @@ bool cmdPasteBlock::Do() {
 bool cmdPasteBlock::Undo() {
 
 	for (int i = cmdList.size() - 1; i >= 0; i--) {
-		cmdList[i]->Undo();
+		if (cmdList[i] != nullptr) cmdList[i]->Undo();
 	}
 
 	return true;
+}
+
+size_t cmdPasteBlock::getMemorySize() const {
+	return sizeof(*this) + sumMemorySize(cmdList);
 }
\ No newline at end of file
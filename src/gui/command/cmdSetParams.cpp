@@ -71,6 +71,15 @@ cmdSetParams::cmdSetParams(string def) : klsCommand(true, "Set Parameter") {
 	}
 }
 
+cmdSetParams::cmdSetParams(unsigned long gid, const ParameterMap &gParams,
+		const ParameterMap &lParams) : klsCommand(true, "Set Parameter") {
+
+	this->fromString = true;
+	this->gid = gid;
+	newGUIParamList = oldGUIParamList = gParams;
+	newLogicParamList = oldLogicParamList = lParams;
+}
+
 bool cmdSetParams::Do() {
 
 	if ((gCircuit->getGates())->find(gid) == (gCircuit->getGates())->end()) return false; // error: gate not found
@@ -95,6 +104,7 @@ bool cmdSetParams::Do() {
 		(*(gCircuit->getGates()))[gid]->setGUIParam(paramWalk->first, paramWalk->second);
 		paramWalk++;
 	}
+	gCircuit->refileGateName(gid);
 	if (!fromString && (*(gCircuit->getGates()))[gid]->getGUIType() == "TO" && gCircuit->getOscope() != NULL) gCircuit->getOscope()->UpdateMenu();
 	return true;
 }
@@ -123,6 +133,7 @@ bool cmdSetParams::Undo() {
 		(*(gCircuit->getGates()))[gid]->setGUIParam(paramWalk->first, paramWalk->second);
 		paramWalk++;
 	}
+	gCircuit->refileGateName(gid);
 	if (!fromString && (*(gCircuit->getGates()))[gid]->getGUIType() == "TO") gCircuit->getOscope()->UpdateMenu();
 	return true;
 }
@@ -144,6 +155,22 @@ string cmdSetParams::toString() const {
 	return oss.str();
 }
 
+// About how many bytes a parameter map takes up:
+static size_t paramMapSize(const ParameterMap &params) {
+	size_t size = 0;
+	ParameterMap::const_iterator paramWalk = params.begin();
+	while (paramWalk != params.end()) {
+		size += sizeof(*paramWalk) + paramWalk->first.capacity() + paramWalk->second.capacity();
+		paramWalk++;
+	}
+	return size;
+}
+
+size_t cmdSetParams::getMemorySize() const {
+	return sizeof(*this) + paramMapSize(oldGUIParamList) + paramMapSize(newGUIParamList) +
+		paramMapSize(oldLogicParamList) + paramMapSize(newLogicParamList);
+}
+
 void cmdSetParams::setPointers(GUICircuit* gCircuit, GUICanvas* gCanvas,
 		TranslationMap &gateids, TranslationMap &wireids) {
 
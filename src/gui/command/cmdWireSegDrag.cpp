@@ -14,14 +14,14 @@ cmdWireSegDrag::cmdWireSegDrag(GUICircuit* gCircuit, GUICanvas* gCanvas,
 	if ((gCircuit->getWires())->find(wireID) == (gCircuit->getWires())->end()) return; // error: wire not found
 
 	oldSegMap = (*(gCircuit->getWires()))[wireID]->getOldSegmentMap();
-	newSegMap = (*(gCircuit->getWires()))[wireID]->getSegmentMap();
+	newSegDelta = klsSegmentDelta(oldSegMap, (*(gCircuit->getWires()))[wireID]->getSegmentMap());
 }
 
 bool cmdWireSegDrag::Do() {
 
 	if ((gCircuit->getWires())->find(wireID) == (gCircuit->getWires())->end()) return false; // error: wire not found
 
-	(*(gCircuit->getWires()))[wireID]->setSegmentMap(newSegMap);
+	(*(gCircuit->getWires()))[wireID]->setSegmentMap(newSegDelta.apply(oldSegMap));
 
 	return true;
 }
@@ -33,4 +33,8 @@ bool cmdWireSegDrag::Undo() {
 	(*(gCircuit->getWires()))[wireID]->setSegmentMap(oldSegMap);
 
 	return true;
-}
\ No newline at end of file
+}
+
+size_t cmdWireSegDrag::getMemorySize() const {
+	return sizeof(*this) + klsSegmentDelta::getMemorySize(oldSegMap) + newSegDelta.getMemorySize();
+}
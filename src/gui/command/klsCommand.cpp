@@ -12,6 +12,35 @@ std::string klsCommand::toString() const {
 	return "";
 }
 
+size_t klsCommand::getMemorySize() const {
+	return sizeof(*this);
+}
+
+size_t klsCommand::sumMemorySize(const std::vector<klsCommand *> &cmdList) {
+	size_t size = cmdList.capacity() * sizeof(klsCommand *);
+	for (unsigned int i = 0; i < cmdList.size(); i++) {
+		if (cmdList[i] != nullptr) size += cmdList[i]->getMemorySize();
+	}
+	return size;
+}
+
+size_t klsCommand::sumMemorySize(const std::stack<klsCommand *> &cmdList) {
+	// A stack can't be walked, but a class derived from it can reach the
+	// container underneath (so the stack doesn't have to be copied):
+	struct stackContents : std::stack<klsCommand *> {
+		static const container_type &of(const std::stack<klsCommand *> &s) {
+			return s.*&stackContents::c;
+		}
+	};
+	const std::stack<klsCommand *>::container_type &contents = stackContents::of(cmdList);
+
+	size_t size = contents.size() * sizeof(klsCommand *);
+	for (unsigned int i = 0; i < contents.size(); i++) {
+		size += contents[i]->getMemorySize();
+	}
+	return size;
+}
+
 void klsCommand::setPointers(GUICircuit* gCircuit, GUICanvas* gCanvas,
 		TranslationMap &gateids, TranslationMap &wireids) {
 
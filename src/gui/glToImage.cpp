@@ -8,6 +8,7 @@
 #include "paramDialog.h"
 
 #include <cstring>
+#include <cstdlib>
 
 glImageCtx::glImageCtx(int a_width, int a_height, wxWindow *parent) {
 	width = a_width;
@@ -85,11 +86,29 @@ wxImage glImageCtx::getImage() {
 	// convert the DIB Section into a wxImage to return to the caller
 	return theBM.ConvertToImage();
 #elif defined(__linux__) || defined(__APPLE__)
-	uint8_t* pixels = new uint8_t[3 * width * height];
-	uint8_t* flipped = new uint8_t[3 * width * height];
+	uint8_t* flipped = (uint8_t*) malloc(3 * width * height);
+	readPixels(width, height, flipped);
+
+	wxImage mapImage(width, height, true);
+	mapImage.SetData(flipped);
+	return mapImage;
+#endif
+};
+
+void glImageCtx::readPixels(int w, int h, unsigned char *rgb) {
+	int row_size = w*3; // The width of a row in bytes; one for each color
+#ifdef _WINDOWS
+	// The DIB Section is already top row first, so the bottom-left
+	// corner starts (height - h) rows down:
+	wxImage whole = theBM.ConvertToImage();
+	for (int y=0; y < h; y++) {
+		memcpy(&rgb[y*row_size], whole.GetData() + ((height-h+y)*width*3), row_size);
+	}
+#elif defined(__linux__) || defined(__APPLE__)
+	uint8_t* pixels = new uint8_t[3 * w * h];
 
 	glPixelStorei(GL_PACK_ALIGNMENT, 1);
-	glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, pixels);
+	glReadPixels(0, 0, w, h, GL_RGB, GL_UNSIGNED_BYTE, pixels);
 
 	// Reverse the orders of rows in the image we read.
 	// glReadPixels gives us the bottom row first, but we need the top first.
@@ -98,24 +117,13 @@ wxImage glImageCtx::getImage() {
 	//    the row number we want.
 	//  * by adding the offset to the pointer to the start of the pixel buffer
 	//    we can get a pointer to the start of a row
-	int row_size = width*3; // The width of a row in bytes; one for each color
-	for (int y=0; y < height; y++) {
-		memcpy(&flipped[y*row_size], &pixels[(height-1-y)*row_size], row_size);
+	for (int y=0; y < h; y++) {
+		memcpy(&rgb[y*row_size], &pixels[(h-1-y)*row_size], row_size);
 	}
 
-/* 	for (int y=0; y < height; y++) { */
-/* 		for (int x=0; x < (width*3); x++) { */
-/* 			flipped[(y*width*3) + x] = pixels[((height-y)*width*3) + x]; */
-/* 		} */
-/* 	} */
-
-	wxImage mapImage(width, height, true);
-	mapImage.SetData(flipped);
-
 	delete[] pixels;
-	return mapImage;
 #endif
-};
+}
 
 glImageCtx::~glImageCtx() {
 #ifdef _WINDOWS
@@ -19,11 +19,13 @@
 
 DECLARE_APP(MainApp)
 
-guiGate::guiGate() : klsCollisionObject(COLL_GATE) {
+guiGate::guiGate() : klsCollisionObject(COLL_GATE), hotspotIndex(GATE_HOTSPOT_GRID_CELL_SIZE) {
 	myX = 1.0;
 	myY = 1.0;
 	selected = false;
+	shapeRevision = 0;
 	gparams["angle"] = "0.0";
+	renderInfo_angle = 0;
 }
 
 guiGate::~guiGate(){
@@ -62,6 +64,8 @@ string guiGate::getGUIType() {
 // This is called once whenever the gate's position
 // or angle changes.
 void guiGate::updateBBoxes( bool noUpdateWires ) {
+	shapeRevision++;
+
 	// Get the translation vars:
 	float x, y;
 	this->getGLcoords( x, y );
@@ -87,11 +91,27 @@ void guiGate::updateBBoxes( bool noUpdateWires ) {
 	glGetDoublev( GL_MODELVIEW_MATRIX, mModel );
 	glLoadIdentity();
 
+	// Counter-rotate the label lines if the angle or the lines changed:
+	if( angle != renderInfo_angle || renderInfo_labelVertices.size() != labelVertices.size() ) {
+		renderInfo_angle = angle;
+		float rad = angle * DEG2RAD;
+		float cosA = cos(rad);
+		float sinA = sin(rad);
+		renderInfo_labelVertices.resize( labelVertices.size() );
+		for (unsigned int i = 0; i < labelVertices.size(); i++) {
+			float lx = labelVertices[i].x;
+			float ly = labelVertices[i].y;
+			renderInfo_labelVertices[i].x = lx * cosA + ly * sinA;
+			renderInfo_labelVertices[i].y = -lx * sinA + ly * cosA;
+		}
+	}
+
 	// Update all of the hotspots' world coordinates:
 	map< string, gateHotspot* >::iterator hs = hotspots.begin();
 	while( hs != hotspots.end() ) {
 		(hs->second)->worldLocation = modelToWorld( (hs->second)->modelLocation );
 		(hs->second)->calcBBox();
+		hotspotIndex.update( hs->second );
 		hs++;
 	}
 
@@ -142,19 +162,13 @@ bool guiGate::isConnected(string c) {
 
 void guiGate::draw(bool color) {
 
-	GLint oldStipple = 0; // The old line stipple pattern, if needed.
-	GLint oldRepeat = 0;  // The old line stipple repeat pattern, if needed.
-	GLboolean lineStipple = false; // The old line stipple enable flag, if needed.
-
 	// Position the gate at its x and y coordinates:
 	glLoadMatrixd(mModel);
 
 
 	if( selected && color ) {
-		// Store the old line stipple pattern:
-		lineStipple = glIsEnabled( GL_LINE_STIPPLE );
-		glGetIntegerv( GL_LINE_STIPPLE_PATTERN, &oldStipple );
-		glGetIntegerv( GL_LINE_STIPPLE_REPEAT, &oldRepeat );
+		// Keep the old line stipple settings to put back afterwards:
+		glPushAttrib( GL_LINE_BIT );
 	
 		// Draw the gate with dotted lines:
 		glEnable( GL_LINE_STIPPLE );
@@ -162,47 +176,23 @@ void guiGate::draw(bool color) {
 	}
 
 	// Draw the gate:
-	glBegin(GL_LINES);
-	for( unsigned int i = 0; i < vertices.size(); i++ ) {
-		glVertex2f( vertices[i].x, vertices[i].y );
+	// (The lines are kept in a vertex array, so they go to GL in one call.)
+	glEnableClientState( GL_VERTEX_ARRAY );
+	if( !vertices.empty() ) {
+		glVertexPointer( 2, GL_FLOAT, sizeof(GLPoint2f), &vertices[0] );
+		glDrawArrays( GL_LINES, 0, (GLsizei)vertices.size() );
 	}
-	glEnd();
 
 	// Draw label lines with counter-rotation so they stay upright:
-	if (!labelVertices.empty()) {
-		istringstream iss(gparams["angle"]);
-		GLfloat angle = 0;
-		iss >> angle;
-
-		if (angle != 0) {
-			float rad = angle * DEG2RAD;
-			float cosA = cos(rad);
-			float sinA = sin(rad);
-			glBegin(GL_LINES);
-			for (unsigned int i = 0; i < labelVertices.size(); i++) {
-				float x = labelVertices[i].x;
-				float y = labelVertices[i].y;
-				float rx = x * cosA + y * sinA;
-				float ry = -x * sinA + y * cosA;
-				glVertex2f(rx, ry);
-			}
-			glEnd();
-		} else {
-			glBegin(GL_LINES);
-			for (unsigned int i = 0; i < labelVertices.size(); i++) {
-				glVertex2f(labelVertices[i].x, labelVertices[i].y);
-			}
-			glEnd();
-		}
+	if (!renderInfo_labelVertices.empty()) {
+		glVertexPointer( 2, GL_FLOAT, sizeof(GLPoint2f), &renderInfo_labelVertices[0] );
+		glDrawArrays( GL_LINES, 0, (GLsizei)renderInfo_labelVertices.size() );
 	}
+	glDisableClientState( GL_VERTEX_ARRAY );
 
 	// Reset the stipple parameters:
 	if( selected && color ) {
-		// Reset the line pattern:
-		if( !lineStipple ) {
-			glDisable( GL_LINE_STIPPLE );
-		}
-		glLineStipple( oldRepeat, oldStipple );
+		glPopAttrib();
 	}
 }
 
@@ -294,31 +284,34 @@ void guiGate::insertHotspot( float x1, float y1, string connection, int busLines
 
 // Check if any of the hotspots of this gate are within the delta
 // of the world coordinates sX and sY. delta is in gl coords.
+// (If more than one is, the closest one to the point is returned.)
 string guiGate::checkHotspots( GLfloat x, GLfloat y, GLfloat delta ) {
-	// Set up the mouse as a collision object:
-	klsCollisionObject mouse( COLL_MOUSEBOX );
 	klsBBox mBox;
 	mBox.addPoint( GLPoint2f( x, y ) );
 	mBox.extendTop( delta );
 	mBox.extendBottom( delta );
 	mBox.extendLeft( delta );
 	mBox.extendRight( delta );
-	mouse.setBBox( mBox );
 
-	// Check if any hotspots hit the mouse:
-	CollisionGroup results = this->checkSubsToObj( &mouse );
+	// Only look at the hotspots filed near the point:
+	CollisionGroup results;
+	hotspotIndex.query( mBox, results );
+
+	string closestName = "";
+	GLfloat closestDist = FLT_MAX;
 	CollisionGroup::iterator rs = results.begin();
 	while( rs != results.end() ) {
-		// If there were any hotspots that hit, then return
-		// the first one to the caller:
-		if( (*rs)->getType() == COLL_GATE_HOTSPOT ) {
-			return ((gateHotspot*) *rs)->name;
+		gateHotspot* hs = (gateHotspot*) *rs;
+		GLPoint2f loc = hs->getLocation();
+		GLfloat dist = (loc.x - x) * (loc.x - x) + (loc.y - y) * (loc.y - y);
+		if( dist < closestDist || (dist == closestDist && hs->name < closestName) ) {
+			closestName = hs->name;
+			closestDist = dist;
 		}
-
 		rs++;
 	}
 
-	return "";
+	return closestName;
 }
 
 
@@ -358,83 +351,114 @@ bool guiGate::isVerticalHotspot( string hsName ) {
 	return ( min( getBBox().getTop()-y, y-getBBox().getBottom() ) < min( getBBox().getRight()-x, x-getBBox().getLeft() ) );
 }
 
-void guiGate::saveGate(XMLParser* xparse) {
-	float x, y;
-	this->getGLcoords( x, y );
+void guiGate::snapshotGate( gateSnapshot& snap ) {
+	snap.id = gateID;
+	snap.type = libGateName;
+	this->getGLcoords( snap.x, snap.y );
+
+	snap.connections.clear();
+	map< string, guiWire* >::iterator pC = connections.begin();
+	while (pC != connections.end()) {
+		hotspotSnapshot hs;
+		hs.name = pC->first;
+		hs.isInput = isInput[pC->first];
+		hs.wireIds = pC->second->getIDs();
+		snap.connections.push_back(hs);
+		pC++;
+	}
+
+	snap.guiParams.assign( gparams.begin(), gparams.end() );
+
+	// File parameters aren't saved:
+	snap.logicParams.clear();
+	map< string, string >::iterator pParams = lparams.begin();
+	LibraryGate &lg = wxGetApp().libraries[getLibraryName()][getLibraryGateName()];
+	while (pParams != lparams.end()) {
+		bool found = false;
+		for (unsigned int i = 0; i < lg.dlgParams.size() && !found; i++) {
+			if (lg.dlgParams[i].isGui) continue;
+			if ((lg.dlgParams[i].type == "FILE_IN" || lg.dlgParams[i].type == "FILE_OUT") &&
+				lg.dlgParams[i].name == pParams->first) found = true;
+		}
+		if (!found) snap.logicParams.push_back(*pParams);
+		pParams++;
+	}
+	
+	//*********************************
+	//Edit by Joshua Lansford 6/06/2007
+	//I want the ram files to save their contents to file
+	//with the circuit.  However, I don't want to send
+	//an entire page of data up to the gui each time
+	//an entry changes.
+	//This way the ram gate can intelegently save what
+	//it wants to into the file.
+	//Also any other gate that wishes too, can also
+	//save specific stuff.
+	this->getTypeSpecificParams( snap.logicParams );
+	//End of edit***********************
+}
 
+void guiGate::saveGate( XMLParser* xparse, const gateSnapshot& snap ) {
 	xparse->openTag("gate");
 	xparse->openTag("ID");
 	ostringstream oss;
-	oss << gateID;
+	oss << snap.id;
 	xparse->writeTag("ID", oss.str());
 	xparse->closeTag("ID");
 	xparse->openTag("type");
-	xparse->writeTag("type", libGateName);
+	xparse->writeTag("type", snap.type);
 	xparse->closeTag("type");
 	oss.str("");
 	xparse->openTag("position");
-	oss << x << "," << y;
+	oss << snap.x << "," << snap.y;
 	xparse->writeTag("position", oss.str());
 	xparse->closeTag("position");
-	map< string, guiWire* >::iterator pC = connections.begin();
-	while (pC != connections.end()) {
-		xparse->openTag((isInput[pC->first] ? "input" : "output"));
+	for (unsigned int i = 0; i < snap.connections.size(); i++) {
+		const hotspotSnapshot &hs = snap.connections[i];
+		xparse->openTag((hs.isInput ? "input" : "output"));
 		xparse->openTag("ID");
-		xparse->writeTag("ID", pC->first);
+		xparse->writeTag("ID", hs.name);
 		xparse->closeTag("ID");
 		oss.str("");
 
-		for (IDType thisId : pC->second->getIDs()) {
+		for (IDType thisId : hs.wireIds) {
 			oss << thisId << " ";
 		}
 		
-		xparse->writeTag((isInput[pC->first] ? "input" : "output"), oss.str());
-		xparse->closeTag((isInput[pC->first] ? "input" : "output"));
-		pC++;
+		xparse->writeTag((hs.isInput ? "input" : "output"), oss.str());
+		xparse->closeTag((hs.isInput ? "input" : "output"));
 	}
-	map< string, string >::iterator pParams = gparams.begin();
-	while (pParams != gparams.end()) {
+	for (unsigned int i = 0; i < snap.guiParams.size(); i++) {
 		xparse->openTag("gparam");
 		oss.str("");
-		oss << pParams->first << " " << pParams->second;
+		oss << snap.guiParams[i].first << " " << snap.guiParams[i].second;
 		xparse->writeTag("gparam", oss.str());
 		xparse->closeTag("gparam");
-		pParams++;
 	}
-	pParams = lparams.begin();
-	LibraryGate lg = wxGetApp().libraries[getLibraryName()][getLibraryGateName()];
-	while (pParams != lparams.end()) {
-		bool found = false;
-		for (unsigned int i = 0; i < lg.dlgParams.size() && !found; i++) {
-			if (lg.dlgParams[i].isGui) continue;
-			if ((lg.dlgParams[i].type == "FILE_IN" || lg.dlgParams[i].type == "FILE_OUT") &&
-				lg.dlgParams[i].name == pParams->first) found = true;
-		}
-		if (found) { pParams++; continue; }
+	for (unsigned int i = 0; i < snap.logicParams.size(); i++) {
 		xparse->openTag("lparam");
 		oss.str("");
-		oss << pParams->first << " " << pParams->second;
+		oss << snap.logicParams[i].first << " " << snap.logicParams[i].second;
 		xparse->writeTag("lparam", oss.str());
 		xparse->closeTag("lparam");
-		pParams++;
 	}
-	
-	//*********************************
-	//Edit by Joshua Lansford 6/06/2007
-	//I want the ram files to save their contents to file
-	//with the circuit.  However, I don't want to send
-	//an entire page of data up to the gui each time
-	//an entry changes.
-	//This way the ram gate can intelegently save what
-	//it wants to into the file.
-	//Also any other gate that wishes too, can also
-	//save specific stuff.
-	this->saveGateTypeSpecifics( xparse );
-	//End of edit***********************
 
 	xparse->closeTag("gate");
 }
 
+// Write the extra logic params of this type of gate:
+void guiGate::saveGateTypeSpecifics( XMLParser* xparse ) {
+	vector< pair< string, string > > params;
+	this->getTypeSpecificParams( params );
+	for (unsigned int i = 0; i < params.size(); i++) {
+		xparse->openTag("lparam");
+		ostringstream oss;
+		oss << params[i].first << " " << params[i].second;
+		xparse->writeTag("lparam", oss.str());
+		xparse->closeTag("lparam");
+	}
+}
+
 // Save in v1.x compatible format (single wire IDs)
 void guiGate::saveGateLegacy(XMLParser* xparse) {
 	float x, y;
@@ -477,7 +501,7 @@ void guiGate::saveGateLegacy(XMLParser* xparse) {
 		pParams++;
 	}
 	pParams = lparams.begin();
-	LibraryGate lg = wxGetApp().libraries[getLibraryName()][getLibraryGateName()];
+	LibraryGate &lg = wxGetApp().libraries[getLibraryName()][getLibraryGateName()];
 	while (pParams != lparams.end()) {
 		bool found = false;
 		for (unsigned int i = 0; i < lg.dlgParams.size() && !found; i++) {
@@ -744,8 +768,7 @@ void guiGateREGISTER::draw( bool color ) {
 		if (renderInfo_drawBlue) glColor4f( 0.3f, 0.3f, 1.0, 1.0 );
 		else glColor4f( 1.0, 0.0, 0.0, 1.0 );
 
-		GLfloat lineWidthOld;
-		glGetFloatv(GL_LINE_WIDTH, &lineWidthOld);
+		glPushAttrib(GL_LINE_BIT);
 		glLineWidth(2.0);
         
 		// THESE ARE ALL SEVEN SEGMENTS WITH DIFFERENTIAL COORDS.  USE THEM FOR EACH DIGIT VALUE FOR EACH DIGIT
@@ -776,7 +799,7 @@ void guiGateREGISTER::draw( bool color ) {
 				glVertex2f(renderInfo_valueBox.begin.x+(diffx*currentDigit)+(diffx*0.8125),renderInfo_valueBox.begin.y+(diffy*0.5)); }
 		}
 		glEnd();
-		glLineWidth(lineWidthOld);
+		glPopAttrib();
 		glColor4f( 0.0, 0.0, 0.0, 1.0 );
 	}
 }
@@ -1037,6 +1060,7 @@ guiTO_FROM::guiTO_FROM() {
 	
 	// Initialize the text object:
 	theText.setSize( TO_FROM_TEXT_HEIGHT );
+	renderInfo_textDirection = 0;
 }
 
 void guiTO_FROM::draw( bool color ) {
@@ -1060,19 +1084,12 @@ void guiTO_FROM::draw( bool color ) {
 	//isn't that exciting.
 	//This will rotate the text around
 	//before it is printed
-	if( this->getGUIParam( "angle" ) == "180" ||
-	    this->getGUIParam( "angle" ) ==  "90" ){
+	if( renderInfo_angle == 180 || renderInfo_angle == 90 ){
 		
 		//scoot the label over
 		GLbox textBBox = theText.getBoundingBox();
 		GLdouble textWidth = textBBox.right - textBBox.left;
-		int direction = 0;
-		if( getGUIType() == "TO" ) {
-			direction = +1;
-		} else if (getGUIType() == "FROM") {
-			direction = -1;
-		}
-		glTranslatef( direction * (textWidth + FLIPPED_OFFSET), 0, 0 );
+		glTranslatef( renderInfo_textDirection * (textWidth + FLIPPED_OFFSET), 0, 0 );
 		
 		//and spin it around
 		glRotatef( 180, 0.0, 0.0, 1.0);
@@ -1111,12 +1128,16 @@ void guiTO_FROM::calcBBox( void ) {
 
 	// Adjust the bounding box based on the text's bbox:
 	GLdouble textWidth = textBBox.right - textBBox.left;
-	if( getGUIType() == "TO" ) {
+	string guiType = getGUIType();
+	renderInfo_textDirection = 0;
+	if( guiType == "TO" ) {
+		renderInfo_textDirection = +1;
 		GLPoint2f bR = modelBBox.getBottomRight();
 		bR.x += textWidth;
 		modelBBox.addPoint( bR );
 		theText.setPosition( TO_BUFFER, TO_FROM_TEXT_HEIGHT/2+0.30 );
-	} else if (getGUIType() == "FROM") {
+	} else if (guiType == "FROM") {
+		renderInfo_textDirection = -1;
 		GLPoint2f tL = modelBBox.getTopLeft();
 		tL.x -= (textWidth + FROM_BUFFER);
 		modelBBox.addPoint( tL );
@@ -1136,6 +1157,8 @@ void guiTO_FROM::calcBBox( void ) {
 guiGateRAM::guiGateRAM(){
 	guiGate();
 	ramPopupDialog = NULL;
+	lastRead = -1;
+	lastWritten = -1;
 }
 
 guiGateRAM::~guiGateRAM(){	
@@ -1150,22 +1173,20 @@ guiGateRAM::~guiGateRAM(){
 void guiGateRAM::doParamsDialog( void* gc, wxCommandProcessor* wxcmd ){
 	if( ramPopupDialog == NULL ){
 		ramPopupDialog = new RamPopupDialog( this, addressBits, (GUICircuit*)gc );
-		ramPopupDialog->updateGridDisplay();
 	}
 	ramPopupDialog->Show( true );
 }
 
 //Saves the ram contents to the circuit file
 //when the circuit saves
-void guiGateRAM::saveGateTypeSpecifics( XMLParser* xparse ){
+void guiGateRAM::getTypeSpecificParams( vector< pair< string, string > >& params ){
 	for( map< unsigned long, unsigned long >::iterator I = memory.begin();
 	     	I != memory.end();  ++I ){
 	     if( I->second != 0 ){
-			xparse->openTag("lparam");
-		    ostringstream memoryValue;
-			memoryValue << "Address:" << I->first << " " << I->second; 
-			xparse->writeTag("lparam", memoryValue.str());
-			xparse->closeTag("lparam");
+		    ostringstream address, memoryValue;
+			address << "Address:" << I->first;
+			memoryValue << I->second;
+			params.push_back( make_pair( address.str(), memoryValue.str() ) );
 	     }
 	}
 }
@@ -1182,9 +1203,12 @@ void guiGateRAM::setLogicParam( string paramName, string value ){
 		istringstream addressiss( value );
 		unsigned long address = 0;
 		addressiss >> address;
+		//both the old and the new cell change color
+		if( ramPopupDialog != NULL ){
+			ramPopupDialog->updateGridDisplay( lastRead );
+			ramPopupDialog->updateGridDisplay( address );
+		}
 		lastRead = address;
-		if( ramPopupDialog != NULL )
-			ramPopupDialog->updateGridDisplay();
 	}else if( paramName.substr( 0, 8 ) == "Address:" ){
 		istringstream addressiss( paramName.substr( 8 ) );
 		unsigned long address = 0;
@@ -1193,8 +1217,10 @@ void guiGateRAM::setLogicParam( string paramName, string value ){
 		unsigned long data = 0;
 		dataiss >> data;
 		memory[ address ] = data;
-		if( ramPopupDialog != NULL )
-			ramPopupDialog->updateGridDisplay();
+		if( ramPopupDialog != NULL ){
+			ramPopupDialog->updateGridDisplay( lastWritten );
+			ramPopupDialog->updateGridDisplay( address );
+		}
 		lastWritten = address;
 	}else if( paramName == "MemoryReset" ){
 		memory.clear();
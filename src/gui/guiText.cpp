@@ -23,6 +23,9 @@ DECLARE_APP(MainApp)
 
 static glfont::GLFont fontFace;
 
+unsigned long guiText::fontRevision = 0;
+string guiText::fontFile;
+
 guiText::guiText() {
 	
 	// The text color (Default = black):
@@ -41,6 +44,10 @@ guiText::guiText() {
 
 	// The text string to be displayed:	
 	textString = "Text";
+
+	// Nothing is built until the text is first drawn or measured:
+	renderInfo_width = renderInfo_height = 0;
+	renderInfo_fontRevision = 0;
 }
 
 guiText::~guiText() {
@@ -65,11 +72,21 @@ void guiText::draw( void ) {
 		glTranslatef( translate[0], translate[1], 0.0 );
 		glScalef(scale[0], scale[1], 1);
 
-		// Draw the text:
-		glEnable(GL_TEXTURE_2D);
-		fontFace.Begin();
-		fontFace.DrawString(textString, 0., 0.);
-		glDisable(GL_TEXTURE_2D);
+		// Draw the text, from quads that are only rebuilt when the text
+		// changes:
+		updateRenderInfo();
+		if( !renderInfo_vertices.empty() ) {
+			glEnable(GL_TEXTURE_2D);
+			fontFace.Begin();
+			glEnableClientState( GL_VERTEX_ARRAY );
+			glEnableClientState( GL_TEXTURE_COORD_ARRAY );
+			glVertexPointer( 2, GL_FLOAT, 0, &renderInfo_vertices[0] );
+			glTexCoordPointer( 2, GL_FLOAT, 0, &renderInfo_texCoords[0] );
+			glDrawArrays( GL_QUADS, 0, (GLsizei)(renderInfo_vertices.size() / 2) );
+			glDisableClientState( GL_TEXTURE_COORD_ARRAY );
+			glDisableClientState( GL_VERTEX_ARRAY );
+			glDisable(GL_TEXTURE_2D);
+		}
 	glPopMatrix();
 
 	// Set the color back to the old color:
@@ -81,15 +98,27 @@ void guiText::draw( void ) {
 GLbox guiText::getBoundingBox( void ) {
 	GLbox tempBox;
 
-	std::pair<int, int> size;
-	fontFace.GetStringSize( textString, &size );
+	updateRenderInfo();
 	tempBox.left = 0;
-	tempBox.right = size.first*scale[0];
-	tempBox.top = -size.second*0.1667*scale[1];
-	tempBox.bottom = -size.second*0.8333*scale[1];
+	tempBox.right = renderInfo_width*scale[0];
+	tempBox.top = -renderInfo_height*0.1667*scale[1];
+	tempBox.bottom = -renderInfo_height*0.8333*scale[1];
 	return tempBox;
 }
 
+void guiText::updateRenderInfo( void ) {
+	if( renderInfo_fontRevision == fontRevision && renderInfo_text == textString ) return;
+
+	fontFace.GetStringQuads( textString, 0., 0., &renderInfo_vertices, &renderInfo_texCoords );
+	std::pair<int, int> size;
+	fontFace.GetStringSize( textString, &size );
+	renderInfo_width = size.first;
+	renderInfo_height = size.second;
+
+	renderInfo_text = textString;
+	renderInfo_fontRevision = fontRevision;
+}
+
 // *************** Mutator methods ****************************
 	
 // Set the scale factor by setting a text height and aspect ratio (w / h).
@@ -107,4 +136,11 @@ void guiText::setSize( GLdouble textHeight, GLdouble aspect ) {
 // loadFont - call this for each context after initialization
 void guiText::loadFont(string fontpath) {
 	fontFace.Create(fontpath.c_str(), FONT_TEXTURE_ID);	
+
+	// Reloading the same file gives the same glyphs, so only a new file
+	// makes the text objects rebuild their quads:
+	if( fontpath != fontFile ) {
+		fontFile = fontpath;
+		fontRevision++;
+	}
 }
@@ -48,6 +48,9 @@ float distanceToLine(GLPoint2f p, GLPoint2f l1, GLPoint2f l2) {
 guiWire::guiWire() : klsCollisionObject(COLL_WIRE) {
 	selected = false;
 	setVerticalBar = true;
+	shapePending = false;
+	shapeRevision = 0;
+	stateRevision = 0;
 	// Start segs at 1, since 0 is reserved for the base vertical segment
 	nextSegID = 1;
 	segMap[0].verticalSeg = true;
@@ -175,19 +178,61 @@ vector < wireConnection > guiWire::getConnections() {
 	return connectPoints;
 }
 
+void guiWire::getColor(GLfloat rgba[4], bool color) const {
+	rgba[0] = rgba[1] = rgba[2] = 0.0;
+	rgba[3] = 1.0;
+	if (!color) return;
+
+	bool conflict = false;
+	bool unknown = false;
+	bool hiz = false;
+	float redness = 0;
+	float bitWeight = 1; // 2^i, kept as a running product
+
+	// Find color as a gradient base on decimal value.
+	// If there's a conflict, unknown, or hi_z, show that instead.
+	for (int i = 0; i < (int)state.size(); i++, bitWeight *= 2) {
+		switch (state[i]) {
+		case ZERO:
+			break;
+		case ONE:
+			redness += bitWeight;
+			break;
+		case HI_Z:
+			hiz = true;
+			break;
+		case UNKNOWN:
+			unknown = true;
+			break;
+		case CONFLICT:
+			conflict = true;
+			break;
+		}
+	}
+	redness /= bitWeight - 1;
+
+	if (conflict) {
+		rgba[1] = 1.0; rgba[2] = 1.0;
+	}
+	else if (unknown) {
+		rgba[0] = 0.3f; rgba[1] = 0.3f; rgba[2] = 1.0;
+	}
+	else if (hiz) {
+		rgba[1] = 0.78f;
+	}
+	else {
+		rgba[0] = redness;
+	}
+}
+
 void guiWire::draw(bool color) {
 	if (connectPoints.size() < 2) return;
 
-	GLint oldStipple = 0; // The old line stipple pattern, if needed.
-	GLint oldRepeat = 0;  // The old line stipple repeat pattern, if needed.
-	GLboolean lineStipple = false; // The old line stipple enable flag, if needed.
 	float degInRad;
 
 	if (this->selected && color) {
-		// Store the old line stipple pattern:
-		lineStipple = glIsEnabled(GL_LINE_STIPPLE);
-		glGetIntegerv(GL_LINE_STIPPLE_PATTERN, &oldStipple);
-		glGetIntegerv(GL_LINE_STIPPLE_REPEAT, &oldRepeat);
+		// Keep the old line stipple settings to put back afterwards:
+		glPushAttrib(GL_LINE_BIT);
 
 		// Draw the gate with dotted lines:
 		glEnable(GL_LINE_STIPPLE);
@@ -195,50 +240,9 @@ void guiWire::draw(bool color) {
 	}
 
 	// Calculate color
-	if (color) {
-		bool conflict = false;
-		bool unknown = false;
-		bool hiz = false;
-		float redness = 0;
-
-		// Find color as a gradient base on decimal value.
-		// If there's a conflict, unknown, or hi_z, show that instead.
-		for (int i = 0; i < (int)state.size(); i++) {
-			switch (state[i]) {
-			case ZERO:
-				break;
-			case ONE:
-				redness += pow(2, i);
-				break;
-			case HI_Z:
-				hiz = true;
-				break;
-			case UNKNOWN:
-				unknown = true;
-				break;
-			case CONFLICT:
-				conflict = true;
-				break;
-			}
-		}
-		redness /= pow(2, state.size()) - 1;
-
-		if (conflict) {
-			glColor4f(0.0, 1.0, 1.0, 1.0);
-		}
-		else if (unknown) {
-			glColor4f(0.3f, 0.3f, 1.0, 1.0);
-		}
-		else if (hiz) {
-			glColor4f(0.0, 0.78f, 0.0, 1.0);
-		}
-		else {
-			glColor4f(redness, 0.0, 0.0, 1.0);
-		}
-	}
-	else {
-		glColor4f(0.0, 0.0, 0.0, 1.0);
-	}
+	GLfloat rgba[4];
+	getColor(rgba, color);
+	glColor4fv(rgba);
 
 
 	// Draw the wire from the previously-saved render info
@@ -306,37 +310,24 @@ void guiWire::draw(bool color) {
 	}
 
 	// Reset the stipple parameters:
-	if (selected) {
-		// Reset the line pattern:
-		if (!lineStipple) {
-			glDisable(GL_LINE_STIPPLE);
-		}
-		glLineStipple(oldRepeat, oldStipple);
+	if (selected && color) {
+		glPopAttrib();
 	}
 
 }
 
 bool guiWire::hover(float cx, float cy, float delta) {
 
-	// Set up the mouse as a collision object:
-	klsCollisionObject mouse(COLL_MOUSEBOX);
-	klsBBox mBox = mouse.getBBox();
+	// Make a box around the mouse:
+	klsBBox mBox;
 	mBox.addPoint(GLPoint2f(cx, cy));
 	mBox.extendTop(delta);
 	mBox.extendBottom(delta);
 	mBox.extendLeft(delta);
 	mBox.extendRight(delta);
-	mouse.setBBox(mBox);
 
 	// Check if any segments collide with the mouse:
-	if (this->overlaps(&mouse)) {
-		CollisionGroup cg = this->checkSubsToObj(&mouse);
-		if (!cg.empty()) {
-			return true;
-		}
-	}
-
-	return false;
+	return this->getBBox().overlaps(mBox) && this->subsOverlap(mBox);
 }
 
 // Return the begin point of the initial vertical bar seg segMap[headSegment].  All other segs
@@ -415,12 +406,19 @@ bool guiWire::isSelected(void) {
 	return selected;
 };
 
-void guiWire::select(void) { selected = true; };
+void guiWire::select(void) {
+	if (!selected) shapeRevision++;
+	selected = true;
+};
 
-void guiWire::unselect(void) { selected = false; };
+void guiWire::unselect(void) {
+	if (selected) shapeRevision++;
+	selected = false;
+};
 
 void guiWire::setID(IDType nid) {
 	ids[0] = nid;
+	shapeRevision++;
 }
 
 IDType guiWire::getID() const {
@@ -430,6 +428,7 @@ IDType guiWire::getID() const {
 void guiWire::setIDs(const std::vector<IDType> &ids) {
 	this->ids = ids;
 	this->state.resize(ids.size(), HI_Z);
+	shapeRevision++;
 }
 
 const std::vector<IDType> & guiWire::getIDs() const {
@@ -438,12 +437,14 @@ const std::vector<IDType> & guiWire::getIDs() const {
 
 void guiWire::setState(vector<StateType> state) {
 	this->state = state;
+	stateRevision++;
 };
 
 void guiWire::setSubState(IDType buslineId, StateType state) {
 	for (int i = 0; i < (int)this->state.size(); i++) {
-		if (ids[i] == buslineId) {
+		if (ids[i] == buslineId && this->state[i] != state) {
 			this->state[i] = state;
+			stateRevision++;
 		}
 	}
 }
@@ -452,54 +453,75 @@ const vector<StateType> & guiWire::getState() const {
 	return state;
 };
 
+// Copy the segment tree and wire info
+void guiWire::snapshotWire(wireSnapshot& snap) {
+	snap.ids = ids;
+	snap.segments.clear();
+	snap.segments.reserve(segMap.size());
+	map < long, wireSegment >::iterator segWalk = segMap.begin();
+	while (segWalk != segMap.end()) {
+		segmentSnapshot seg;
+		seg.id = (segWalk->second).id;
+		seg.isVertical = (segWalk->second).isVertical();
+		seg.begin = (segWalk->second).begin;
+		seg.end = (segWalk->second).end;
+		for (unsigned int i = 0; i < (segWalk->second).connections.size(); i++) {
+			seg.connections.push_back(make_pair((segWalk->second).connections[i].gid, (segWalk->second).connections[i].connection));
+		}
+		seg.intersects = (segWalk->second).intersects;
+		snap.segments.push_back(seg);
+		segWalk++;
+	}
+}
+
 // Save segment tree and wire info
-void guiWire::saveWire(XMLParser* xparse) {
+void guiWire::saveWire(XMLParser* xparse, const wireSnapshot& snap) {
 	xparse->openTag("wire");
 	// Save the IDs for the wire (of course)
 	xparse->openTag("ID");
 	ostringstream oss;
-	for (IDType id : ids) {
+	for (IDType id : snap.ids) {
 		oss << id << ' ';
 	}
 	xparse->writeTag("ID", oss.str());
 	xparse->closeTag("ID");
 	// Save the tree
 	xparse->openTag("shape");
-	// Step through the map, save each seg's info
-	map < long, wireSegment >::iterator segWalk = segMap.begin();
-	while (segWalk != segMap.end()) {
-		if ((segWalk->second).isVertical()) xparse->openTag("vsegment");
+	// Step through the segments, save each seg's info
+	for (unsigned int s = 0; s < snap.segments.size(); s++) {
+		const segmentSnapshot &seg = snap.segments[s];
+		if (seg.isVertical) xparse->openTag("vsegment");
 		else xparse->openTag("hsegment");
 		// ID
 		oss.str(""); oss.clear();
-		oss << (segWalk->second).id;
+		oss << seg.id;
 		xparse->openTag("ID");
 		xparse->writeTag("ID", oss.str());
 		xparse->closeTag("ID");
 		// position - begin/end points
 		oss.str(""); oss.clear();
-		oss << (segWalk->second).begin.x << "," << (segWalk->second).begin.y << "," << (segWalk->second).end.x << "," << (segWalk->second).end.y;
+		oss << seg.begin.x << "," << seg.begin.y << "," << seg.end.x << "," << seg.end.y;
 		xparse->openTag("points");
 		xparse->writeTag("points", oss.str());
 		xparse->closeTag("points");
 		// connections - gid and connection string
-		for (unsigned int i = 0; i < (segWalk->second).connections.size(); i++) {
+		for (unsigned int i = 0; i < seg.connections.size(); i++) {
 			xparse->openTag("connection");
 			oss.str(""); oss.clear();
-			oss << (segWalk->second).connections[i].gid;
+			oss << seg.connections[i].first;
 			xparse->openTag("GID");
 			xparse->writeTag("GID", oss.str());
 			xparse->closeTag("GID");
 			oss.str(""); oss.clear();
-			oss << (segWalk->second).connections[i].connection;
+			oss << seg.connections[i].second;
 			xparse->openTag("name");
 			xparse->writeTag("name", oss.str());
 			xparse->closeTag("name");
 			xparse->closeTag("connection");
 		}
 		// intersections - must store the intersection map
-		map < GLfloat, vector < long > >::iterator isectWalk = (segWalk->second).intersects.begin();
-		while (isectWalk != (segWalk->second).intersects.end()) {
+		map < GLfloat, vector < long > >::const_iterator isectWalk = seg.intersects.begin();
+		while (isectWalk != seg.intersects.end()) {
 			for (unsigned int j = 0; j < (isectWalk->second).size(); j++) {
 				xparse->openTag("intersection");
 				oss.str(""); oss.clear();
@@ -509,9 +531,8 @@ void guiWire::saveWire(XMLParser* xparse) {
 			}
 			isectWalk++;
 		}
-		if ((segWalk->second).isVertical()) xparse->closeTag("vsegment");
+		if (seg.isVertical) xparse->closeTag("vsegment");
 		else xparse->closeTag("hsegment");
-		segWalk++;
 	}
 	xparse->closeTag("shape");
 
@@ -582,15 +603,25 @@ void guiWire::saveWireLegacy(XMLParser* xparse) {
 
 map < long, wireSegment > guiWire::getSegmentMap(void) { return segMap; };
 
-void guiWire::setSegmentMap(map < long, wireSegment > newSegMap) {
+void guiWire::setSegmentMap(map < long, wireSegment > newSegMap, bool openMode) {
 	this->deleteSubObjects(); // prevent coll checker pointers from invalidating
 	segMap = newSegMap;
-	calcBBox();
 	headSegment = ((segMap.begin())->first);
 	nextSegID = ((segMap.rbegin())->first) + 1;
+	// On open, the page may never be shown, so wait to merge the tree
+	shapePending = openMode;
+	if (openMode) return;
+	calcBBox();
 	endSegDrag();
 };
 
+void guiWire::finishOpenShape() {
+	if (!shapePending) return;
+	shapePending = false;
+	calcBBox();
+	endSegDrag();
+}
+
 map < long, wireSegment > guiWire::getOldSegmentMap(void) { return oldSegMap; };
 
 // Calculates a default three-segment shape for the wire, from source to destination, squared halfway
@@ -1199,6 +1230,7 @@ void guiWire::generateRenderInfo() {
 
 	// clear out the old information.  this function is only called when
 	//	the wire shape has changed.
+	shapeRevision++;
 	renderInfo.vertexPoints.clear();
 	renderInfo.intersectPoints.clear();
 	renderInfo.lineSegments.clear();
@@ -12,6 +12,8 @@
 #include "OscopeFrame.h"
 #include <fstream>
 #include <map>
+#include <set>
+#include <cstring>
 #include <unordered_map>   // removed .h  KAS
 
 #include "MainApp.h"
@@ -22,9 +24,51 @@
 #include "guiWire.h"
 #include "wx/clipbrd.h"
 #include "wx/dataobj.h"
+#include "wx/utils.h"
 
 DECLARE_APP(MainApp)
 
+shared_ptr< const clipboardBlock > klsClipboard::copiedBlock;
+unsigned long klsClipboard::copySerial = 0;
+
+// What goes on the clipboard in the block format:
+struct clipboardToken {
+	unsigned long processID;
+	unsigned long serial;
+};
+
+// (Made on first use, since formats can't be registered before wx starts.)
+static const wxDataFormat& blockFormat() {
+	static wxDataFormat format( "CedarLogic.Block" );
+	return format;
+}
+
+// The text form of a block, built from the block the first time that the
+// clipboard asks for it (so copies and pastes that are never read as text
+// don't pay for it):
+class blockTextDataObject : public wxTextDataObject {
+public:
+	blockTextDataObject( shared_ptr< const clipboardBlock > block ) : block( block ) {};
+
+	virtual size_t GetTextLength() const { render(); return wxTextDataObject::GetTextLength(); };
+	virtual wxString GetText() const { render(); return wxTextDataObject::GetText(); };
+
+	virtual size_t GetDataSize() const { render(); return wxTextDataObject::GetDataSize(); };
+	virtual size_t GetDataSize( const wxDataFormat& format ) const { render(); return wxTextDataObject::GetDataSize( format ); };
+	virtual bool GetDataHere( void* buf ) const { render(); return wxTextDataObject::GetDataHere( buf ); };
+	virtual bool GetDataHere( const wxDataFormat& format, void* buf ) const { render(); return wxTextDataObject::GetDataHere( format, buf ); };
+
+private:
+	void render() const {
+		if ( !block ) return;
+		const_cast< blockTextDataObject* >( this )->SetText( klsClipboard::blockToText( *block ) );
+		block.reset();
+	};
+
+	// Released once the text is rendered:
+	mutable shared_ptr< const clipboardBlock > block;
+};
+
 class clipboardCtx {
 public:
 	bool valid;
@@ -40,23 +84,39 @@ public:
 
 cmdPasteBlock* klsClipboard::pasteBlock( GUICircuit* gCircuit, GUICanvas* gCanvas ) {
 	clipboardCtx clipboard;
-	if ( !clipboard.valid || !wxTheClipboard->IsSupported(wxDF_UNICODETEXT) ) {
-		return NULL;
-	}
+	if ( !clipboard.valid ) return NULL;
+
+	vector < klsCommand* > cmdList;
+	TranslationMap gateids;
+	TranslationMap wireids;
+	if ( holdsCopiedBlock() ) {
+		// If we are copying more than one thing, don't increment them -- that would be annoying
+		// Hold Shift during paste to bypass the auto-increment
+		if ( copiedBlock->gates.size() == 1 && !wxGetKeyState(WXK_SHIFT) ) {
+			clipboardBlock incremented = *copiedBlock;
+			if ( incrementJunction( incremented.gates[0] ) ) {
+				copiedBlock = make_shared< const clipboardBlock >( incremented );
+				putOnClipboard(); // Update clipboard data so subsequent pastes carry
+			}
+		}
+		cmdList = makeCommands( *copiedBlock );
+		for (unsigned int i = 0; i < cmdList.size(); i++) {
+			cmdList[i]->setPointers( gCircuit, gCanvas, gateids, wireids );
+			cmdList[i]->Do();
+		}
+	} else {
+		if ( !wxTheClipboard->IsSupported(wxDF_UNICODETEXT) ) return NULL;
+
+		wxTextDataObject text;
+		if ( !wxTheClipboard->GetData(text) ) return NULL;
+		string pasteText = text.GetText().ToStdString();
+		if (pasteText.find('\n',0) == string::npos) return NULL;
+		istringstream iss(pasteText);
+		string temp;
 
-    wxTextDataObject text;
-    vector < klsCommand* > cmdList;
-    if ( wxTheClipboard->GetData(text) ) {
-    	string pasteText = text.GetText().ToStdString();
-    	if (pasteText.find('\n',0) == string::npos) return NULL;
-    	istringstream iss(pasteText);
-    	string temp;
-		
-		TranslationMap gateids;
-		TranslationMap wireids;
-    	while (getline( iss, temp, '\n' )) {
-    		klsCommand* cg = NULL;
-    		if (temp.substr(0,10) == "creategate") cg = new cmdCreateGate(temp);
+		while (getline( iss, temp, '\n' )) {
+			klsCommand* cg = NULL;
+			if (temp.substr(0,10) == "creategate") cg = new cmdCreateGate(temp);
 			else if (temp.substr(0, 9) == "setparams") {
 
 				/* EDIT by Colin Broberg, 10/6/16
@@ -102,31 +162,32 @@ cmdPasteBlock* klsClipboard::pasteBlock( GUICircuit* gCircuit, GUICanvas* gCanva
 				}
 				cg = new cmdSetParams(temp);
 			}
-    		else if (temp.substr(0,10) == "createwire") cg = new cmdCreateWire(temp);
-    		else if (temp.substr(0,11) == "connectwire") cg = new cmdConnectWire(temp);
-    		else if (temp.substr(0,8) == "movewire") cg = new cmdMoveWire(temp);
-    		else break;
-    		cmdList.push_back( cg );
-    		cg->setPointers( gCircuit, gCanvas, gateids, wireids );
-    		cg->Do();
-    	}
-		gCanvas->unselectAllGates();
-		gCanvas->unselectAllWires();
-		TranslationMap::iterator gateWalk = gateids.begin();
-		while (gateWalk != gateids.end()) {
-			(*(gCircuit->getGates()))[gateWalk->second]->select();
-			gateWalk++;
+			else if (temp.substr(0,10) == "createwire") cg = new cmdCreateWire(temp);
+			else if (temp.substr(0,11) == "connectwire") cg = new cmdConnectWire(temp);
+			else if (temp.substr(0,8) == "movewire") cg = new cmdMoveWire(temp);
+			else break;
+			cmdList.push_back( cg );
+			cg->setPointers( gCircuit, gCanvas, gateids, wireids );
+			cg->Do();
 		}
-		TranslationMap::iterator wireWalk = wireids.begin();
-		while (wireWalk != wireids.end()) {
-			guiWire *wire = (*(gCircuit->getWires()))[wireWalk->second];
-			if (wire != nullptr) {
-				wire->select();
-			}
-			wireWalk++;
+	}
+
+	gCanvas->unselectAllGates();
+	gCanvas->unselectAllWires();
+	TranslationMap::iterator gateWalk = gateids.begin();
+	while (gateWalk != gateids.end()) {
+		(*(gCircuit->getGates()))[gateWalk->second]->select();
+		gateWalk++;
+	}
+	TranslationMap::iterator wireWalk = wireids.begin();
+	while (wireWalk != wireids.end()) {
+		guiWire *wire = (*(gCircuit->getWires()))[wireWalk->second];
+		if (wire != nullptr) {
+			wire->select();
 		}
-		gCircuit->getOscope()->UpdateMenu();
-    }
+		wireWalk++;
+	}
+	gCircuit->getOscope()->UpdateMenu();
 
 	if (cmdList.size() > 0) return new cmdPasteBlock ( cmdList );
 	return NULL;
@@ -134,76 +195,132 @@ cmdPasteBlock* klsClipboard::pasteBlock( GUICircuit* gCircuit, GUICanvas* gCanva
 
 void klsClipboard::copyBlock( GUICircuit* gCircuit, GUICanvas* gCanvas, vector < unsigned long > gates, vector < unsigned long > wires ) {
 	if (gates.size() == 0) return;
-	ostringstream oss;
-	klsCommand* cmdTemp;
+	clipboardBlock block;
+	set < unsigned long > copiedGates( gates.begin(), gates.end() );
 	map < unsigned long, unsigned long > connectWireList;
-	// Write strings to copy gates
 	for (unsigned int i = 0; i < gates.size(); i++) {
+		guiGate* gGate = (*(gCircuit->getGates()))[gates[i]];
 		// generate list of wire connections
-		map < string, GLPoint2f > hotspotmap = (*(gCircuit->getGates()))[gates[i]]->getHotspotList();
+		map < string, GLPoint2f > hotspotmap = gGate->getHotspotList();
 		map < string, GLPoint2f >::iterator hsmapWalk = hotspotmap.begin();
 		while (hsmapWalk != hotspotmap.end()) {
-			if ( (*(gCircuit->getGates()))[gates[i]]->isConnected(hsmapWalk->first) )connectWireList[(*(gCircuit->getGates()))[gates[i]]->getConnection(hsmapWalk->first)->getID()]++;
+			if ( gGate->isConnected(hsmapWalk->first) ) connectWireList[gGate->getConnection(hsmapWalk->first)->getID()]++;
 			hsmapWalk++;
 		}
 		// Creation of a gate takes care of type, position, id; all other items are in params
-		float x, y;
-		(*(gCircuit->getGates()))[gates[i]]->getGLcoords(x,y);
-		cmdTemp = new cmdCreateGate( gCanvas, gCircuit, gates[i], (*(gCircuit->getGates()))[gates[i]]->getLibraryGateName(), x, y);
-		oss << cmdTemp->toString() << endl;
-		delete cmdTemp;
-		guiGate* gGate = (*(gCircuit->getGates()))[gates[i]];
-		cmdTemp = new cmdSetParams( gCircuit, gates[i], paramSet(gGate->getAllGUIParams(), gGate->getAllLogicParams()) );
-		oss << cmdTemp->toString() << endl;
-		delete cmdTemp;
+		clipboardGate copyGate;
+		copyGate.id = gates[i];
+		copyGate.type = gGate->getLibraryGateName();
+		gGate->getGLcoords( copyGate.x, copyGate.y );
+		copyGate.gParams = *(gGate->getAllGUIParams());
+		copyGate.lParams = *(gGate->getAllLogicParams());
+		block.gates.push_back( copyGate );
 	}
 	// For wires, only copy if more than one active connection, and trim shape
-	vector < guiWire* > copyWires;
 	map < unsigned long, unsigned long >::iterator wireWalk = connectWireList.begin();
 	while (wireWalk != connectWireList.end()) {
 		if ( wireWalk->second < 2 ) { wireWalk++; continue; }
-		guiWire* wire = new guiWire();
+		guiWire* original = (*(gCircuit->getWires()))[wireWalk->first];
+		guiWire wire;
 		// Set the IDs
-		wire->setIDs( (*gCircuit->getWires())[wireWalk->first]->getIDs() );
+		wire.setIDs( original->getIDs() );
 		// Shove all the connections
-		vector < wireConnection > wireConns = (*(gCircuit->getWires()))[wireWalk->first]->getConnections();
-		for (unsigned int i = 0; i < wireConns.size(); i++) wire->addConnection( wireConns[i].cGate, wireConns[i].connection, true );
+		vector < wireConnection > wireConns = original->getConnections();
+		for (unsigned int i = 0; i < wireConns.size(); i++) wire.addConnection( wireConns[i].cGate, wireConns[i].connection, true );
 		// Now get the segment map copy
-		wire->setSegmentMap( (*(gCircuit->getWires()))[wireWalk->first]->getSegmentMap() );
+		wire.setSegmentMap( original->getSegmentMap() );
 		// Now that we have a good copy of the wire object, we can trim the connections that we don't want to carry over
 		for (unsigned int i = 0; i < wireConns.size(); i++) {
-			bool found = false;
-			for (unsigned int j = 0; j < gates.size() && !found; j++) if (gates[j] == wireConns[i].gid) found = true;
-			if (found) continue; // we found this connection; don't trim it
+			if (copiedGates.find(wireConns[i].gid) != copiedGates.end()) continue; // we found this connection; don't trim it
 			// get rid of it
-			wire->removeConnection( wireConns[i].cGate, wireConns[i].connection );
+			wire.removeConnection( wireConns[i].cGate, wireConns[i].connection );
 		}
-		// Wire should now have a completely valid shape to copy, shove it on the vector
-		copyWires.push_back(wire);
+		// Wire should now have a completely valid shape to copy
+		clipboardWire copyWire;
+		copyWire.ids = wire.getIDs();
+		vector < wireConnection > wconns = wire.getConnections();
+		for (unsigned int i = 0; i < wconns.size(); i++) {
+			copyWire.connections.push_back( make_pair( wconns[i].cGate->getID(), wconns[i].connection ) );
+		}
+		copyWire.shape = wire.getSegmentMap();
+		block.wires.push_back( copyWire );
 		wireWalk++;
 	}
-	// Now actually generate copy of wire
-	for (unsigned int i = 0; i < copyWires.size(); i++) {
-		vector < wireConnection > wconns = copyWires[i]->getConnections();
+
+	copiedBlock = make_shared< const clipboardBlock >( move( block ) );
+	copySerial++;
+
+	clipboardCtx clipboard;
+	if ( !clipboard.valid ) return;
+	putOnClipboard();
+}
+
+vector < klsCommand* > klsClipboard::makeCommands( const clipboardBlock& block ) {
+	vector < klsCommand* > cmdList;
+	for (unsigned int i = 0; i < block.gates.size(); i++) {
+		const clipboardGate& copyGate = block.gates[i];
+		cmdList.push_back( new cmdCreateGate( NULL, NULL, copyGate.id, copyGate.type, copyGate.x, copyGate.y, true ) );
+		cmdList.push_back( new cmdSetParams( copyGate.id, copyGate.gParams, copyGate.lParams ) );
+	}
+	for (unsigned int i = 0; i < block.wires.size(); i++) {
+		const clipboardWire& copyWire = block.wires[i];
+		unsigned long wid = copyWire.ids[0];
 		// now generate the connections - connections 1 and 2 must be passed to create the wire
 		//	after which all connections may be done in succession.
-		cmdConnectWire *conn1 = new cmdConnectWire(gCircuit, copyWires[i]->getID(), wconns[0].cGate->getID(), wconns[0].connection);
-		cmdConnectWire *conn2 = new cmdConnectWire(gCircuit, copyWires[i]->getID(), wconns[1].cGate->getID(), wconns[1].connection);
-		cmdTemp = new cmdCreateWire(gCanvas, gCircuit, gCircuit->getWires()->at(copyWires[i]->getID())->getIDs(), conn1, conn2);
-		oss << cmdTemp->toString() << endl;
-		delete cmdTemp;
-		for (unsigned int j = 2; j < wconns.size(); j++) {
-			cmdTemp = new cmdConnectWire(gCircuit, copyWires[i]->getID(), wconns[j].cGate->getID(), wconns[j].connection);
-			oss << cmdTemp->toString() << endl;
-			delete cmdTemp;
+		vector < cmdConnectWire* > conns;
+		for (unsigned int j = 0; j < copyWire.connections.size(); j++) {
+			conns.push_back( new cmdConnectWire( NULL, wid, copyWire.connections[j].first, copyWire.connections[j].second, true ) );
 		}
+		cmdList.push_back( new cmdCreateWire( NULL, NULL, copyWire.ids, conns[0], conns[1] ) );
+		for (unsigned int j = 2; j < conns.size(); j++) cmdList.push_back( conns[j] );
 		// now track the wire's shape:
-		cmdTemp = new cmdMoveWire(gCircuit, copyWires[i]->getID(), copyWires[i]->getSegmentMap(), copyWires[i]->getSegmentMap());
-		oss << cmdTemp->toString() << endl;
-		delete cmdTemp;
-		delete copyWires[i];
+		cmdList.push_back( new cmdMoveWire( NULL, wid, copyWire.shape, copyWire.shape ) );
+	}
+	return cmdList;
+}
+
+string klsClipboard::blockToText( const clipboardBlock& block ) {
+	ostringstream oss;
+	vector < klsCommand* > cmdList = makeCommands( block );
+	for (unsigned int i = 0; i < cmdList.size(); i++) {
+		oss << cmdList[i]->toString() << endl;
+		delete cmdList[i];
 	}
-	if (!wxTheClipboard->Open()) return;
-	wxTheClipboard->AddData(new wxTextDataObject(oss.str()));
-	wxTheClipboard->Close();
+	return oss.str();
+}
+
+void klsClipboard::putOnClipboard( void ) {
+	clipboardToken token;
+	token.processID = wxGetProcessId();
+	token.serial = copySerial;
+	wxCustomDataObject* tokenData = new wxCustomDataObject( blockFormat() );
+	tokenData->SetData( sizeof(token), &token );
+
+	wxDataObjectComposite* data = new wxDataObjectComposite();
+	data->Add( tokenData, true );
+	data->Add( new blockTextDataObject( copiedBlock ) );
+	wxTheClipboard->SetData( data );
+}
+
+bool klsClipboard::holdsCopiedBlock( void ) {
+	if ( copySerial == 0 || !wxTheClipboard->IsSupported( blockFormat() ) ) return false;
+
+	wxCustomDataObject tokenData( blockFormat() );
+	if ( !wxTheClipboard->GetData( tokenData ) || tokenData.GetSize() != sizeof(clipboardToken) ) return false;
+	clipboardToken token;
+	memcpy( &token, tokenData.GetData(), sizeof(token) );
+	return token.processID == wxGetProcessId() && token.serial == copySerial;
+}
+
+bool klsClipboard::incrementJunction( clipboardGate& gate ) {
+	map < string, string >::iterator junction = gate.lParams.find( "JUNCTION_ID" );
+	if ( junction == gate.lParams.end() ) return false;
+
+	string& name = junction->second;
+	size_t numStart = name.size();
+	while ( numStart > 0 && isdigit( (unsigned char)name[numStart - 1] ) ) numStart--;
+	if ( numStart == name.size() ) return false;
+
+	name = name.substr( 0, numStart ) + to_string( stoul( name.substr( numStart ) ) + 1 );
+	return true;
 }
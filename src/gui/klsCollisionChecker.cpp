@@ -18,9 +18,13 @@ DECLARE_APP(MainApp)
 klsCollisionObject::klsCollisionObject(klsCollisionObjectType theType) {
 	setType(theType);
 	cData.bboxChanged = true; // The object is new, so mark it as having changed!
+	cData.checker = NULL;
 };
 
 klsCollisionObject::~klsCollisionObject() {
+	// Don't leave a dangling pointer in the checker:
+	if( cData.checker != NULL ) cData.checker->forgetObject( this );
+
 	deleteSubObjects();
 	deleteCollisionObject();
 }
@@ -76,6 +80,15 @@ CollisionGroup klsCollisionObject::checkSubsToSubs( klsCollisionObject* objB, bo
 	return klsCollisionChecker::checkGroupCollisions( this->getSubObjects(), objB->getSubObjects(), resetOverlaps );
 }
 
+bool klsCollisionObject::subsOverlap( klsBBox box ) {
+	CollisionGroup::iterator sub = cData.subObjs.begin();
+	while( sub != cData.subObjs.end() ) {
+		if( (*sub)->getBBox().overlaps( box ) ) return true;
+		sub++;
+	}
+	return false;
+}
+
 CollisionGroup klsCollisionObject::getOverlaps() {
 	return cData.overlaps;
 }
@@ -117,6 +130,7 @@ void klsCollisionObject::deleteCollisionObject() {
 
 void klsCollisionObject::setBBoxChanged() {
 	cData.bboxChanged = true;
+	if( cData.checker != NULL ) cData.checker->objectMoved( this );
 }
 
 void klsCollisionObject::setBBoxUpdated() {
@@ -128,7 +142,9 @@ bool klsCollisionObject::bboxHasChanged() {
 }
 
 void klsCollisionObject::clearOverlaps() {
+	if( cData.overlaps.empty() ) return;
 	cData.overlaps.clear();
+	if( cData.checker != NULL ) cData.checker->objectOverlapsChanged( this );
 }
 
 void klsCollisionObject::clearSubsOverlaps() {
@@ -141,10 +157,12 @@ void klsCollisionObject::clearSubsOverlaps() {
 
 void klsCollisionObject::addOverlap(klsCollisionObject* newOverlap) {
 	cData.overlaps.insert(newOverlap);
+	if( cData.overlaps.size() == 1 && cData.checker != NULL ) cData.checker->objectOverlapsChanged( this );
 }
 
 void klsCollisionObject::removeOverlap(klsCollisionObject* oldOverlap) {
-	cData.overlaps.erase(oldOverlap);
+	if( cData.overlaps.erase(oldOverlap) == 0 ) return;
+	if( cData.overlaps.empty() && cData.checker != NULL ) cData.checker->objectOverlapsChanged( this );
 }
 
 CollisionGroup klsCollisionObject::verifyOverlaps() {
@@ -176,85 +194,73 @@ CollisionGroup klsCollisionObject::verifyOverlaps() {
 
 // ************************* klsCollisionChecker *****************************
 
+klsCollisionChecker::~klsCollisionChecker() {
+	// Let go of the objects, so they don't report back to a deleted checker:
+	CollisionGroup::iterator thisObj = collisionObjects.begin();
+	while( thisObj != collisionObjects.end() ) {
+		(*thisObj)->cData.checker = NULL;
+		thisObj++;
+	}
+}
+
 // Check the overlaps of all of the collision objects stored in this checker,
 // and update their status:
 void klsCollisionChecker::update( void ) {
-	//TODO: Put a more efficient algorithm in to this that uses a sort-sweep algorithm
-	// or something to that effect to do an all-to-all comparison, that keeps the data
-	// structure between calls to update(). For now, it simply slices the problem up into
-	// an N by N comparison that is order N^2.
-	//NOTE: I made the algorithm more efficient by only updating bboxes that have changed
-	// since the last call to update. So, it is now order S*N, where S is the number
-	// of things that have changed.  Also, moving items are now only checked against
-	// stationary ones, and if S < N/2, then the groups are switched.
+	// Only objects whose bboxes have changed since the last call (plus the
+	// special-type objects) are checked, and each of them is only checked
+	// against the objects near it in the spatial index, so the cost depends
+	// on how much has moved rather than on the size of the page.
+	// Changed objects are only checked against stationary ones.
 
 	// Clear out the old collisions:
 	overlaps.clear();
 
-	// Loop through all collision objects, and identify those that have changed:
-	CollisionGroup changedObjs, stationaryObjs;
-	CollisionGroup::iterator thisObj = collisionObjects.begin();
-	while( thisObj != collisionObjects.end() ) {
-		// Changed objects and special-type objects (view box, sel box, mouse, etc)
-		if( (*thisObj)->bboxHasChanged() || (*thisObj)->getType() > COLL_WIRE_SEG) {
-			// Add it to the update list.
-			changedObjs.insert( *thisObj );
-
-			// Verify and remove invalid collisions with all "colliding" objects,
-			// to remove overlaps that are no longer current:
-			(*thisObj)->verifyOverlaps();
-
-			// Tell it that we've fixed the problem:
-			(*thisObj)->setBBoxUpdated();
-		} else {
-			stationaryObjs.insert( *thisObj );
-		}
-		
-		// Add all of the overlaps of this object into the main overlaps object:
-		CollisionGroup hits = (*thisObj)->getOverlaps();
-		CollisionGroup::iterator thisHit = hits.begin();
-		while( thisHit != hits.end() ) {
-			overlaps[(*thisHit)->getType()].insert(*thisHit);
-			thisHit++;
-		}
-		
-		thisObj++;
+	CollisionGroup changedObjs;
+	changedObjs.swap( changedObjects );
+	changedObjs.insert( specialObjects.begin(), specialObjects.end() );
+
+	// Verify and remove invalid collisions with all "colliding" objects,
+	// to remove overlaps that are no longer current:
+	CollisionGroup::iterator changedObj = changedObjs.begin();
+	while( changedObj != changedObjs.end() ) {
+		(*changedObj)->verifyOverlaps();
+
+		// Tell it that we've fixed the problem:
+		(*changedObj)->setBBoxUpdated();
+		changedObj++;
 	}
 
-	// Now, the question is, which group has more objects?
-	CollisionGroup* relChanged = &(changedObjs.size() < stationaryObjs.size() ? changedObjs : stationaryObjs);
-	CollisionGroup* relStatic = &(changedObjs.size() >= stationaryObjs.size() ? changedObjs : stationaryObjs);
-
-	// With the objects that have changed their bounding boxes, update their
-	// collision information:
-	unsigned long long numCompares = 0;
-	CollisionGroup::iterator changedObj = relChanged->begin();
-	while( changedObj != relChanged->end() ) {
-		// Check this object against all of the other objects, to add potential
-		// new overlaps:
-//* Slow collision checking system:
-		CollisionGroup groupA, groupB;
-		groupA.insert( *changedObj );
-		groupB.insert( relStatic->begin(), relStatic->end() );
-		groupB.erase( *changedObj );
-
-		// Check the collisions of object A with the rest of the group,
-		// while not resetting the other object's overlap information:
-		CollisionGroup hits;
-		hits = checkGroupCollisions( groupA, groupB, false );
-		numCompares += groupB.size();
-/**/
-
-		// Sort the hits into the main map object:
-		CollisionGroup::iterator thisHit = hits.begin();
-		while( thisHit != hits.end() ) {
-			overlaps[(*thisHit)->getType()].insert(*thisHit);
-			thisHit++;
+	// Look for new overlaps between the changed objects and the stationary
+	// objects near them:
+	changedObj = changedObjs.begin();
+	while( changedObj != changedObjs.end() ) {
+		CollisionGroup nearObjs;
+		index.query( (*changedObj)->getBBox(), nearObjs );
+
+		CollisionGroup::iterator nearObj = nearObjs.begin();
+		while( nearObj != nearObjs.end() ) {
+			if( changedObjs.find( *nearObj ) == changedObjs.end() ) {
+				// Register the collision in both object's data structures:
+				(*changedObj)->addOverlap( *nearObj );
+				(*nearObj)->addOverlap( *changedObj );
+			}
+			nearObj++;
 		}
 
 		// Check the next changed object:
 		changedObj++;
 	}
+
+	// Sort all of the current overlaps into the main map object:
+	CollisionGroup::iterator thisObj = overlappingObjects.begin();
+	while( thisObj != overlappingObjects.end() ) {
+		CollisionGroup::iterator thisHit = (*thisObj)->cData.overlaps.begin();
+		while( thisHit != (*thisObj)->cData.overlaps.end() ) {
+			overlaps[(*thisHit)->getType()].insert(*thisHit);
+			thisHit++;
+		}
+		thisObj++;
+	}
 }
 
 // Check a specific overlap group against another:
@@ -310,18 +316,65 @@ CollisionGroup klsCollisionChecker::checkGroupCollisions( CollisionGroup groupA,
 }
 
 void klsCollisionChecker::addObject(klsCollisionObject* newObj) {
-	collisionObjects.insert(newObj);
-	newObj->bboxHasChanged();
+	// An object can only be in one checker at a time:
+	if( newObj->cData.checker != NULL && newObj->cData.checker != this ) {
+		newObj->cData.checker->forgetObject( newObj );
+	}
 	newObj->clearOverlaps();
 	newObj->clearSubsOverlaps();
+
+	newObj->cData.checker = this;
+	collisionObjects.insert(newObj);
+	if( newObj->getType() > COLL_WIRE_SEG ) specialObjects.insert( newObj );
+
+	// File it in the index and check it on the next update():
+	newObj->setBBoxChanged();
 };
 
 void klsCollisionChecker::removeObject( klsCollisionObject* oldObj ) {
-	collisionObjects.erase( oldObj );
+	if( oldObj->cData.checker == this ) forgetObject( oldObj );
+
 	oldObj->deleteSubObjects();
 	oldObj->deleteCollisionObject();
 }
 
 void klsCollisionChecker::clear() {
+	CollisionGroup::iterator thisObj = collisionObjects.begin();
+	while( thisObj != collisionObjects.end() ) {
+		(*thisObj)->cData.checker = NULL;
+		thisObj++;
+	}
+	index.clear();
+	changedObjects.clear();
+	specialObjects.clear();
+	overlappingObjects.clear();
 	collisionObjects.clear(); update();
-};
\ No newline at end of file
+};
+
+CollisionGroup klsCollisionChecker::getObjectsInBox( klsBBox box ) {
+	CollisionGroup found;
+	index.query( box, found );
+	return found;
+}
+
+void klsCollisionChecker::objectMoved( klsCollisionObject* obj ) {
+	index.update( obj );
+	changedObjects.insert( obj );
+}
+
+void klsCollisionChecker::objectOverlapsChanged( klsCollisionObject* obj ) {
+	if( obj->cData.overlaps.empty() ) {
+		overlappingObjects.erase( obj );
+	} else {
+		overlappingObjects.insert( obj );
+	}
+}
+
+void klsCollisionChecker::forgetObject( klsCollisionObject* obj ) {
+	collisionObjects.erase( obj );
+	index.remove( obj );
+	changedObjects.erase( obj );
+	specialObjects.erase( obj );
+	overlappingObjects.erase( obj );
+	obj->cData.checker = NULL;
+}
\ No newline at end of file
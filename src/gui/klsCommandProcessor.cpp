@@ -0,0 +1,110 @@
+/*****************************************************************************
+   Project: CEDAR Logic Simulator
+   Copyright 2006 Cedarville University, Benjamin Sprague,
+                     Matt Lewellyn, and David Knierim
+   All rights reserved.
+   For license information see license.txt included with distribution.
+
+   klsCommandProcessor: Undo history with a memory budget
+*****************************************************************************/
+
+#include "klsCommandProcessor.h"
+#include "MainApp.h"
+#include "command/klsCommand.h"
+
+DECLARE_APP(MainApp)
+
+void klsCommandProcessor::Store( wxCommand* command ) {
+	// Take out what the base class is about to delete: the oldest command
+	// if the history is full, and anything that could have been redone.
+	// (With no current command, it all goes through ClearCommands.)
+	if( m_maxNoCommands >= 0 && (int)m_commands.GetCount() == m_maxNoCommands ) {
+		droppingOldest( m_commands.GetFirst() );
+		forget( (wxCommand*)m_commands.GetFirst()->GetData() );
+	}
+	if( m_currentCommand ) {
+		wxList::compatibility_iterator node = m_currentCommand->GetNext();
+		while( node ) {
+			forget( (wxCommand*)node->GetData() );
+			node = node->GetNext();
+		}
+	}
+
+	// (The base class may clear the history here, but that doesn't bring
+	// a dropped save back.)
+	bool dropped = savedStateDropped;
+	wxCommandProcessor::Store( command );
+	savedStateDropped = dropped;
+
+	size_t size = getMemorySize( command );
+	commandSizes[command] = size;
+	historySize += size;
+	trimHistory();
+}
+
+void klsCommandProcessor::ClearCommands() {
+	wxCommandProcessor::ClearCommands();
+	commandSizes.clear();
+	historySize = 0;
+	savedStateDropped = false;
+}
+
+bool klsCommandProcessor::IsDirty() const {
+	return savedStateDropped || wxCommandProcessor::IsDirty();
+}
+
+void klsCommandProcessor::MarkAsSaved() {
+	wxCommandProcessor::MarkAsSaved();
+	savedStateDropped = false;
+}
+
+void klsCommandProcessor::remeasureCurrentCommand( void ) {
+	if( !m_currentCommand ) return;
+	wxCommand* command = (wxCommand*)m_currentCommand->GetData();
+	std::unordered_map< wxCommand*, size_t >::iterator found = commandSizes.find( command );
+	if( found == commandSizes.end() ) return;
+
+	size_t size = getMemorySize( command );
+	historySize = historySize - found->second + size;
+	found->second = size;
+	trimHistory();
+}
+
+void klsCommandProcessor::trimHistory( void ) {
+	int limit = wxGetApp().appSettings.undoMemoryLimit;
+	if( limit <= 0 ) return;
+	size_t budget = (size_t)limit * 1024 * 1024;
+
+	while( historySize > budget ) {
+		wxList::compatibility_iterator oldest = m_commands.GetFirst();
+		if( !oldest || !m_currentCommand || oldest == m_currentCommand ) break;
+
+		droppingOldest( oldest );
+		wxCommand* oldestCommand = (wxCommand*)oldest->GetData();
+		forget( oldestCommand );
+		delete oldestCommand;
+		m_commands.Erase( oldest );
+
+		// Make sure m_lastSavedCommand won't point to freed memory:
+		if( m_lastSavedCommand == oldest ) m_lastSavedCommand = wxList::compatibility_iterator();
+	}
+}
+
+void klsCommandProcessor::droppingOldest( wxList::compatibility_iterator oldest ) {
+	// The save was made with this command done, or before any command (in
+	// which case undoing everything used to get back to it):
+	if( !m_lastSavedCommand || m_lastSavedCommand == oldest ) savedStateDropped = true;
+}
+
+void klsCommandProcessor::forget( wxCommand* command ) {
+	std::unordered_map< wxCommand*, size_t >::iterator found = commandSizes.find( command );
+	if( found == commandSizes.end() ) return;
+	historySize -= found->second;
+	commandSizes.erase( found );
+}
+
+size_t klsCommandProcessor::getMemorySize( wxCommand* command ) {
+	klsCommand* cmd = dynamic_cast< klsCommand* >( command );
+	if( cmd == nullptr ) return sizeof( wxCommand );
+	return cmd->getMemorySize();
+}
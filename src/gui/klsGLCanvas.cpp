@@ -13,6 +13,7 @@
 #include "paramDialog.h"
 #include "GLFont/glfont2.h"
 #include "glToImage.h"
+#include <cstring>
 
 // Included to use the min() and max() templates:
 #include <algorithm>
@@ -47,6 +48,7 @@ klsGLCanvas::klsGLCanvas(wxWindow *parent, const wxString& name, wxWindowID id,
 	// Zoom and OpenGL coordinate of upper-left corner of this canvas:
 	viewZoom = DEFAULT_ZOOM;
 	panX = panY = 0.0;
+	renderingTile = false;
 
 	autoScrollEnable();
 	
@@ -106,24 +108,19 @@ void klsGLCanvas::updateMiniMap() {
 
 // Print the canvas contents to a bitmap:
 wxImage klsGLCanvas::renderToImage( unsigned long width, unsigned long height, unsigned long colorDepth, bool noColor ) {
-	wxGetApp().SetCurrentCanvas(this);
-	glImageCtx glCtx((int)width, (int)height, this);
+	klsMemoryImageWriter out;
+	renderTiled( out, width, height, noColor );
+	return out.getImage();
+}
 
-	// Setup the projection matrix - use canvas size for world coordinates
-	glMatrixMode(GL_PROJECTION);
-	glLoadIdentity();
+bool klsGLCanvas::renderTiled( klsImageWriter& out, unsigned long width, unsigned long height, bool noColor ) {
+	if( width == 0 || height == 0 || !out.begin( width, height ) ) return false;
 
-	// Use canvas dimensions for world coordinates (what area we're looking at)
-	wxSize sz = GetClientSize();
-	gluOrtho2D(panX, panX + (sz.GetWidth() * viewZoom), panY - (sz.GetHeight() * viewZoom), panY);
-
-	// Set the viewport to bitmap size (resolution we're rendering at)
-	glViewport(0, 0, (GLint) width, (GLint) height);
+	wxGetApp().SetCurrentCanvas(this);
+	int tileWidth = (int) min( width, (unsigned long) EXPORT_TILE_SIZE );
+	int tileHeight = (int) min( height, (unsigned long) EXPORT_TILE_SIZE );
+	glImageCtx glCtx(tileWidth, tileHeight, this);
 
-	// Set the model matrix:
-	glMatrixMode(GL_MODELVIEW);
-	glLoadIdentity();
-	
 	// Set the bitmap clear color:
 	glClearColor (1.0, 1.0, 1.0, 0.0);
 	glColor3b(0, 0, 0);
@@ -145,15 +142,56 @@ wxImage klsGLCanvas::renderToImage( unsigned long width, unsigned long height, u
 	//anti-alies the gates which looks nice.
 	glEnable( GL_LINE_SMOOTH );
 	//End of edit
-		
 
-	// Do the rendering here.
-	klsGLCanvasRender( noColor );
+	// The world size of one image pixel - use canvas size for world
+	// coordinates (what area we're looking at):
+	wxSize sz = GetClientSize();
+	GLdouble pixelWidth = sz.GetWidth() * viewZoom / width;
+	GLdouble pixelHeight = sz.GetHeight() * viewZoom / height;
+
+	// The tiles of one band are pieced together here, and then the band is
+	// handed off before the next one is rendered:
+	vector< unsigned char > tile( tileWidth * tileHeight * 3 );
+	vector< unsigned char > band( (size_t) width * tileHeight * 3 );
 
-	// Flush the OpenGL buffer to make sure the rendering has happened:	
-	glFlush();
+	bool success = true;
+	renderingTile = true;
+	for( unsigned long top = 0; success && top < height; top += tileHeight ) {
+		int bandHeight = (int) min( (unsigned long) tileHeight, height - top );
+		for( unsigned long left = 0; left < width; left += tileWidth ) {
+			int cellWidth = (int) min( (unsigned long) tileWidth, width - left );
+
+			tileTopLeft = GLPoint2f( panX + left * pixelWidth, panY - top * pixelHeight );
+			tileBottomRight = GLPoint2f( panX + (left + cellWidth) * pixelWidth, panY - (top + bandHeight) * pixelHeight );
 
-	return glCtx.getImage();
+			// Setup the projection matrix for just this tile:
+			glMatrixMode(GL_PROJECTION);
+			glLoadIdentity();
+			gluOrtho2D(tileTopLeft.x, tileBottomRight.x, tileBottomRight.y, tileTopLeft.y);
+
+			// Set the viewport to the tile size (resolution we're rendering at)
+			glViewport(0, 0, (GLint) cellWidth, (GLint) bandHeight);
+
+			// Set the model matrix:
+			glMatrixMode(GL_MODELVIEW);
+			glLoadIdentity();
+
+			// Do the rendering here.
+			klsGLCanvasRender( noColor );
+
+			// Flush the OpenGL buffer to make sure the rendering has happened:	
+			glFlush();
+
+			glCtx.readPixels( cellWidth, bandHeight, &tile[0] );
+			for( int y = 0; y < bandHeight; y++ ) {
+				memcpy( &band[((size_t) y * width + left) * 3], &tile[y * cellWidth * 3], cellWidth * 3 );
+			}
+		}
+		success = out.writeRows( &band[0], bandHeight );
+	}
+	renderingTile = false;
+
+	return out.finish() && success;
 }
 
 // Setup the GL matrices for this canvas:
@@ -231,6 +269,15 @@ void klsGLCanvas::getViewport( GLPoint2f& p1, GLPoint2f& p2 ) {
 	p2.y = panY - (sz.GetHeight()*viewZoom);
 }
 
+void klsGLCanvas::getRenderArea( GLPoint2f& p1, GLPoint2f& p2 ) {
+	if( !renderingTile ) {
+		getViewport( p1, p2 );
+		return;
+	}
+	p1 = tileTopLeft;
+	p2 = tileBottomRight;
+}
+
 GLPoint2f klsGLCanvas::mapToCanvas(wxPoint m) {
 	int w, h;
 	GetClientSize(&w, &h);
@@ -0,0 +1,229 @@
+/*****************************************************************************
+   Project: CEDAR Logic Simulator
+   Copyright 2006 Cedarville University, Benjamin Sprague,
+                     Matt Lewellyn, and David Knierim
+   All rights reserved.
+   For license information see license.txt included with distribution.
+
+   klsImageWriter: Receives an image a band of rows at a time
+*****************************************************************************/
+
+#include "klsImageWriter.h"
+#include "wx/wfstream.h"
+#include "wx/zstream.h"
+#include <cstring>
+#include <vector>
+using namespace std;
+
+// Bytes of compressed image data to collect before writing a PNG IDAT chunk:
+#define PNG_CHUNK_SIZE 65536
+
+static void putBigEndian( unsigned char* dest, unsigned long value ) {
+	dest[0] = (unsigned char)(value >> 24);
+	dest[1] = (unsigned char)(value >> 16);
+	dest[2] = (unsigned char)(value >> 8);
+	dest[3] = (unsigned char)value;
+}
+
+static void putLittleEndian( unsigned char* dest, unsigned long value, int bytes ) {
+	for( int i = 0; i < bytes; i++ ) {
+		dest[i] = (unsigned char)(value >> (8 * i));
+	}
+}
+
+// The CRC-32 that PNG puts at the end of each chunk:
+static unsigned long pngCRC( unsigned long crc, const unsigned char* data, size_t length ) {
+	static unsigned long table[256];
+	static bool tableMade = false;
+	if( !tableMade ) {
+		for( unsigned long n = 0; n < 256; n++ ) {
+			unsigned long c = n;
+			for( int k = 0; k < 8; k++ ) {
+				c = (c & 1) ? (0xEDB88320UL ^ (c >> 1)) : (c >> 1);
+			}
+			table[n] = c;
+		}
+		tableMade = true;
+	}
+
+	crc ^= 0xFFFFFFFFUL;
+	for( size_t i = 0; i < length; i++ ) {
+		crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+	}
+	return crc ^ 0xFFFFFFFFUL;
+}
+
+static bool writePNGChunk( wxOutputStream& out, const char* type, const unsigned char* data, size_t length ) {
+	unsigned char header[8];
+	putBigEndian( header, (unsigned long)length );
+	memcpy( header + 4, type, 4 );
+	unsigned long crc = pngCRC( 0, header + 4, 4 );
+	crc = pngCRC( crc, data, length );
+	unsigned char footer[4];
+	putBigEndian( footer, crc );
+
+	out.Write( header, 8 );
+	if( length > 0 ) out.Write( data, length );
+	out.Write( footer, 4 );
+	return out.IsOk();
+}
+
+// Cuts the zlib stream of the image data into IDAT chunks as it comes:
+class pngDataStream : public wxOutputStream {
+public:
+	pngDataStream( wxOutputStream& file ) : file(file) {};
+
+	bool flushChunk( void ) {
+		if( pending.empty() ) return true;
+		bool ok = writePNGChunk( file, "IDAT", &pending[0], pending.size() );
+		pending.clear();
+		return ok;
+	}
+
+protected:
+	size_t OnSysWrite( const void* buffer, size_t size ) {
+		const unsigned char* bytes = (const unsigned char*)buffer;
+		pending.insert( pending.end(), bytes, bytes + size );
+		if( pending.size() >= PNG_CHUNK_SIZE && !flushChunk() ) {
+			m_lasterror = wxSTREAM_WRITE_ERROR;
+			return 0;
+		}
+		return size;
+	}
+
+private:
+	wxOutputStream& file;
+	vector< unsigned char > pending;
+};
+
+// Writes a 24-bit PNG, compressing each row as it comes in:
+class klsPNGWriter : public klsImageWriter {
+public:
+	klsPNGWriter( const wxString& path ) : file(path), data(file), zip(NULL), width(0) {};
+	~klsPNGWriter() { delete zip; };
+
+	bool begin( unsigned long width, unsigned long height ) {
+		if( !file.IsOk() ) return false;
+		this->width = width;
+
+		static const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+		file.Write( signature, 8 );
+
+		unsigned char header[13];
+		putBigEndian( header, width );
+		putBigEndian( header + 4, height );
+		header[8] = 8;  // Bits per sample
+		header[9] = 2;  // RGB
+		header[10] = 0; // Deflate
+		header[11] = 0; // Adaptive filtering
+		header[12] = 0; // Not interlaced
+		if( !writePNGChunk( file, "IHDR", header, 13 ) ) return false;
+
+		zip = new wxZlibOutputStream( data, wxZ_DEFAULT_COMPRESSION, wxZLIB_ZLIB );
+		return zip->IsOk();
+	}
+
+	bool writeRows( const unsigned char* rgb, unsigned long rows ) {
+		// Each row starts with its filter type, which is always "none":
+		const unsigned char filter = 0;
+		for( unsigned long y = 0; y < rows; y++ ) {
+			zip->Write( &filter, 1 );
+			zip->Write( rgb + y * width * 3, width * 3 );
+		}
+		return zip->IsOk() && data.IsOk();
+	}
+
+	bool finish( void ) {
+		if( zip == NULL || !zip->Close() || !data.flushChunk() ) return false;
+		if( !writePNGChunk( file, "IEND", NULL, 0 ) ) return false;
+		return file.Close();
+	}
+
+private:
+	wxFileOutputStream file;
+	pngDataStream data;
+	wxZlibOutputStream* zip;
+	unsigned long width;
+};
+
+// Writes an uncompressed 24-bit BMP with its rows stored top-down:
+class klsBMPWriter : public klsImageWriter {
+public:
+	klsBMPWriter( const wxString& path ) : file(path), width(0) {};
+
+	bool begin( unsigned long width, unsigned long height ) {
+		if( !file.IsOk() ) return false;
+		this->width = width;
+
+		// Rows are padded out to a multiple of four bytes:
+		unsigned long long rowSize = (width * 3 + 3) & ~3ULL;
+		unsigned long long imageSize = rowSize * height;
+		if( imageSize + 54 > 0xFFFFFFFFULL ) return false;
+		padded.assign( (size_t)rowSize, 0 );
+
+		unsigned char header[54];
+		memset( header, 0, 54 );
+		header[0] = 'B';
+		header[1] = 'M';
+		putLittleEndian( header + 2, (unsigned long)(imageSize + 54), 4 );
+		putLittleEndian( header + 10, 54, 4 );
+		putLittleEndian( header + 14, 40, 4 );
+		putLittleEndian( header + 18, width, 4 );
+		// A negative height marks the rows as top-down:
+		putLittleEndian( header + 22, (unsigned long)(-(long)height), 4 );
+		putLittleEndian( header + 26, 1, 2 );
+		putLittleEndian( header + 28, 24, 2 );
+		putLittleEndian( header + 34, (unsigned long)imageSize, 4 );
+		putLittleEndian( header + 38, 2835, 4 ); // 72 DPI
+		putLittleEndian( header + 42, 2835, 4 );
+		file.Write( header, 54 );
+		return file.IsOk();
+	}
+
+	bool writeRows( const unsigned char* rgb, unsigned long rows ) {
+		for( unsigned long y = 0; y < rows; y++ ) {
+			const unsigned char* row = rgb + y * width * 3;
+			for( unsigned long x = 0; x < width; x++ ) {
+				padded[x * 3] = row[x * 3 + 2];
+				padded[x * 3 + 1] = row[x * 3 + 1];
+				padded[x * 3 + 2] = row[x * 3];
+			}
+			file.Write( &padded[0], padded.size() );
+		}
+		return file.IsOk();
+	}
+
+	bool finish( void ) {
+		return file.Close();
+	}
+
+private:
+	wxFileOutputStream file;
+	unsigned long width;
+	vector< unsigned char > padded;
+};
+
+
+klsImageWriter* klsImageWriter::create( const wxString& path, wxBitmapType fileType ) {
+	if( fileType == wxBITMAP_TYPE_PNG ) return new klsPNGWriter( path );
+	if( fileType == wxBITMAP_TYPE_BMP ) return new klsBMPWriter( path );
+	return NULL;
+}
+
+
+bool klsMemoryImageWriter::begin( unsigned long width, unsigned long height ) {
+	nextRow = 0;
+	return image.Create( (int)width, (int)height, false );
+}
+
+bool klsMemoryImageWriter::writeRows( const unsigned char* rgb, unsigned long rows ) {
+	unsigned long rowSize = image.GetWidth() * 3;
+	if( nextRow + rows > (unsigned long)image.GetHeight() ) return false;
+	memcpy( image.GetData() + nextRow * rowSize, rgb, rows * rowSize );
+	nextRow += rows;
+	return true;
+}
+
+bool klsMemoryImageWriter::finish( void ) {
+	return nextRow == (unsigned long)image.GetHeight();
+}
@@ -0,0 +1,245 @@
+/*****************************************************************************
+   Project: CEDAR Logic Simulator
+   Copyright 2006 Cedarville University, Benjamin Sprague,
+                     Matt Lewellyn, and David Knierim
+   All rights reserved.
+   For license information see license.txt included with distribution.
+
+   klsLibraryCache: Binary cache of a parsed gate library
+*****************************************************************************/
+
+#include "klsLibraryCache.h"
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+// Marks the start of a cache file:
+static const char CACHE_MAGIC[4] = { 'C', 'L', 'G', 'C' };
+
+// Writes values into a byte buffer:
+class cacheWriter {
+public:
+	string buffer;
+
+	void putBytes( const void* data, size_t size ) {
+		buffer.append( (const char*)data, size );
+	}
+	void putInt( unsigned int value ) { putBytes( &value, sizeof(value) ); }
+	void putBool( bool value ) { char c = value ? 1 : 0; putBytes( &c, 1 ); }
+	void putFloat( float value ) { putBytes( &value, sizeof(value) ); }
+	void putString( const string& value ) {
+		putInt( (unsigned int)value.size() );
+		putBytes( value.data(), value.size() );
+	}
+	void putParams( const map < string, string >& params ) {
+		putInt( (unsigned int)params.size() );
+		map < string, string >::const_iterator paramWalk = params.begin();
+		while( paramWalk != params.end() ) {
+			putString( paramWalk->first );
+			putString( paramWalk->second );
+			paramWalk++;
+		}
+	}
+};
+
+// Reads values back out of a byte buffer. Once a read runs past the end,
+// ok is false and every later read returns a default value:
+class cacheReader {
+public:
+	cacheReader( const vector < char >& data ) : data(data), pos(0), ok(true) {}
+
+	const vector < char >& data;
+	size_t pos;
+	bool ok;
+
+	bool getBytes( void* dest, size_t size ) {
+		if( !ok || size > data.size() - pos ) {
+			ok = false;
+			return false;
+		}
+		if( size > 0 ) memcpy( dest, &data[pos], size );
+		pos += size;
+		return true;
+	}
+	unsigned int getInt( void ) { unsigned int value = 0; getBytes( &value, sizeof(value) ); return value; }
+	bool getBool( void ) { char c = 0; getBytes( &c, 1 ); return c != 0; }
+	float getFloat( void ) { float value = 0; getBytes( &value, sizeof(value) ); return value; }
+	string getString( void ) {
+		unsigned int size = getInt();
+		if( !ok || size > data.size() - pos ) {
+			ok = false;
+			return "";
+		}
+		string value( &data[0] + pos, size );
+		pos += size;
+		return value;
+	}
+	void getParams( map < string, string >& params ) {
+		unsigned int numParams = getInt();
+		for( unsigned int i = 0; i < numParams && ok; i++ ) {
+			string name = getString();
+			params[name] = getString();
+		}
+	}
+};
+
+unsigned long long klsLibraryCache::hashText( const string& text ) {
+	unsigned long long hash = 14695981039346656037ULL;
+	for( size_t i = 0; i < text.size(); i++ ) {
+		hash ^= (unsigned char)text[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+bool klsLibraryCache::load( const string& cacheFile, unsigned long long textHash,
+		string& libName, map < string, map < string, LibraryGate > >& gates ) {
+
+	// Read the whole file at once:
+	ifstream in( cacheFile.c_str(), ios::in | ios::binary | ios::ate );
+	if( !in ) return false;
+	streamoff size = in.tellg();
+	if( size <= 0 ) return false;
+	vector < char > data( (size_t)size );
+	in.seekg( 0 );
+	if( !in.read( &data[0], size ) ) return false;
+
+	cacheReader reader( data );
+	char magic[4];
+	unsigned long long hash = 0;
+	reader.getBytes( magic, sizeof(magic) );
+	unsigned int version = reader.getInt();
+	reader.getBytes( &hash, sizeof(hash) );
+	if( !reader.ok || memcmp( magic, CACHE_MAGIC, sizeof(magic) ) != 0 ||
+		version != LIBRARY_CACHE_VERSION || hash != textHash ) return false;
+
+	map < string, map < string, LibraryGate > > newGates;
+	string newLibName = reader.getString();
+	unsigned int numLibs = reader.getInt();
+	for( unsigned int l = 0; l < numLibs && reader.ok; l++ ) {
+		map < string, LibraryGate >& library = newGates[reader.getString()];
+		unsigned int numGates = reader.getInt();
+		for( unsigned int g = 0; g < numGates && reader.ok; g++ ) {
+			LibraryGate gate;
+			gate.gateName = reader.getString();
+			gate.caption = reader.getString();
+			gate.guiType = reader.getString();
+			gate.logicType = reader.getString();
+
+			unsigned int count = reader.getInt();
+			for( unsigned int i = 0; i < count && reader.ok; i++ ) {
+				lgHotspot hotspot;
+				hotspot.name = reader.getString();
+				hotspot.isInput = reader.getBool();
+				hotspot.x = reader.getFloat();
+				hotspot.y = reader.getFloat();
+				hotspot.isInverted = reader.getBool();
+				hotspot.logicEInput = reader.getString();
+				hotspot.busLines = (int)reader.getInt();
+				gate.hotspots.push_back( hotspot );
+			}
+
+			count = reader.getInt();
+			for( unsigned int i = 0; i < count && reader.ok; i++ ) {
+				lgLine line;
+				line.x1 = reader.getFloat();
+				line.y1 = reader.getFloat();
+				line.x2 = reader.getFloat();
+				line.y2 = reader.getFloat();
+				line.isLabel = reader.getBool();
+				gate.shape.push_back( line );
+			}
+
+			count = reader.getInt();
+			for( unsigned int i = 0; i < count && reader.ok; i++ ) {
+				lgDlgParam param;
+				param.textLabel = reader.getString();
+				param.name = reader.getString();
+				param.isGui = reader.getBool();
+				param.type = reader.getString();
+				param.Rmin = reader.getFloat();
+				param.Rmax = reader.getFloat();
+				gate.dlgParams.push_back( param );
+			}
+
+			reader.getParams( gate.guiParams );
+			reader.getParams( gate.logicParams );
+			library[gate.gateName] = gate;
+		}
+	}
+
+	// Anything left over (or missing) means the file is damaged:
+	if( !reader.ok || reader.pos != data.size() ) return false;
+
+	libName = newLibName;
+	gates.swap( newGates );
+	return true;
+}
+
+bool klsLibraryCache::save( const string& cacheFile, unsigned long long textHash,
+		const string& libName, const map < string, map < string, LibraryGate > >& gates ) {
+
+	cacheWriter writer;
+	writer.putBytes( CACHE_MAGIC, sizeof(CACHE_MAGIC) );
+	writer.putInt( LIBRARY_CACHE_VERSION );
+	writer.putBytes( &textHash, sizeof(textHash) );
+	writer.putString( libName );
+
+	writer.putInt( (unsigned int)gates.size() );
+	map < string, map < string, LibraryGate > >::const_iterator libWalk = gates.begin();
+	while( libWalk != gates.end() ) {
+		writer.putString( libWalk->first );
+		writer.putInt( (unsigned int)(libWalk->second).size() );
+		map < string, LibraryGate >::const_iterator gateWalk = (libWalk->second).begin();
+		while( gateWalk != (libWalk->second).end() ) {
+			const LibraryGate& gate = gateWalk->second;
+			writer.putString( gate.gateName );
+			writer.putString( gate.caption );
+			writer.putString( gate.guiType );
+			writer.putString( gate.logicType );
+
+			writer.putInt( (unsigned int)gate.hotspots.size() );
+			for( unsigned int i = 0; i < gate.hotspots.size(); i++ ) {
+				const lgHotspot& hotspot = gate.hotspots[i];
+				writer.putString( hotspot.name );
+				writer.putBool( hotspot.isInput );
+				writer.putFloat( hotspot.x );
+				writer.putFloat( hotspot.y );
+				writer.putBool( hotspot.isInverted );
+				writer.putString( hotspot.logicEInput );
+				writer.putInt( (unsigned int)hotspot.busLines );
+			}
+
+			writer.putInt( (unsigned int)gate.shape.size() );
+			for( unsigned int i = 0; i < gate.shape.size(); i++ ) {
+				const lgLine& line = gate.shape[i];
+				writer.putFloat( line.x1 );
+				writer.putFloat( line.y1 );
+				writer.putFloat( line.x2 );
+				writer.putFloat( line.y2 );
+				writer.putBool( line.isLabel );
+			}
+
+			writer.putInt( (unsigned int)gate.dlgParams.size() );
+			for( unsigned int i = 0; i < gate.dlgParams.size(); i++ ) {
+				const lgDlgParam& param = gate.dlgParams[i];
+				writer.putString( param.textLabel );
+				writer.putString( param.name );
+				writer.putBool( param.isGui );
+				writer.putString( param.type );
+				writer.putFloat( param.Rmin );
+				writer.putFloat( param.Rmax );
+			}
+
+			writer.putParams( gate.guiParams );
+			writer.putParams( gate.logicParams );
+			gateWalk++;
+		}
+		libWalk++;
+	}
+
+	ofstream out( cacheFile.c_str(), ios::out | ios::binary | ios::trunc );
+	if( !out ) return false;
+	out.write( writer.buffer.data(), writer.buffer.size() );
+	return (bool)out;
+}
@@ -27,9 +27,15 @@ klsMiniMap::klsMiniMap(wxWindow *parent, wxWindowID id,
         long style, const wxString& name)
 		: wxGLCanvas(parent, id, NULL, pos, size, style|wxSUNKEN_BORDER, name) {
 	currentCanvas = NULL;
+	gateList = NULL;
+	wireList = NULL;
+	pageTexture = 0;
+	textureWidth = textureHeight = 0;
+	imageWidth = imageHeight = 0;
+	pageValid = false;
 }
 
-void klsMiniMap::setViewport() {
+bool klsMiniMap::setViewport() {
 	// Set the projection matrix:	
 	glMatrixMode (GL_PROJECTION);
 	glLoadIdentity ();
@@ -54,6 +60,24 @@ void klsMiniMap::setViewport() {
 	minCorner = GLPoint2f(minX-5,maxY+5);
 	maxCorner = GLPoint2f(maxX+5,minY-5);
 
+	// Keep showing the same area if it still holds everything and isn't
+	// much bigger than it needs to be, so that the page texture can be
+	// reused. Otherwise, leave some room around the new area so that
+	// panning a little doesn't change it again:
+	bool areaChanged = true;
+	double needWidth = maxCorner.x - minCorner.x;
+	double needHeight = minCorner.y - maxCorner.y; // max and min corner's defs are weird...
+	if( pageValid && minCorner.x >= pageTL.x && maxCorner.x <= pageBR.x &&
+		minCorner.y <= pageTL.y && maxCorner.y >= pageBR.y &&
+		4 * needWidth * needHeight >= (pageBR.x - pageTL.x) * (pageTL.y - pageBR.y) ) {
+		areaChanged = false;
+	} else {
+		pageTL = GLPoint2f( minCorner.x - 0.1*needWidth, minCorner.y + 0.1*needHeight );
+		pageBR = GLPoint2f( maxCorner.x + 0.1*needWidth, maxCorner.y - 0.1*needHeight );
+	}
+	minCorner = pageTL;
+	maxCorner = pageBR;
+
 	double screenAspect = (double) sz.GetHeight() / (double) sz.GetWidth();
 	double mapWidth = maxCorner.x - minCorner.x;
 	double mapHeight = minCorner.y - maxCorner.y; // max and min corner's defs are weird...
@@ -92,17 +116,24 @@ void klsMiniMap::setViewport() {
 	// Set the model matrix:
 	glMatrixMode (GL_MODELVIEW);
 	glLoadIdentity ();
+
+	return areaChanged;
 }
 
 // Print the canvas contents to a bitmap:
 void klsMiniMap::generateImage() {
+	if (gateList == NULL || wireList == NULL) return;
+
 	wxSize sz = GetClientSize();
+	double scaleFactorImg = GetContentScaleFactor();
+	int width = (int)(sz.GetWidth() * scaleFactorImg);
+	int height = (int)(sz.GetHeight() * scaleFactorImg);
+	if (width <= 0 || height <= 0) return;
 
 	// Setup the viewport for rendering:
-	setViewport();
+	bool areaChanged = setViewport();
 	// Reset the glViewport to the size of the bitmap:
-	double scaleFactorImg = GetContentScaleFactor();
-	glViewport(0, 0, (GLint)(sz.GetWidth() * scaleFactorImg), (GLint)(sz.GetHeight() * scaleFactorImg));
+	glViewport(0, 0, (GLint)width, (GLint)height);
 	
 	// Set the bitmap clear color:
 	glClearColor (1.0, 1.0, 1.0, 0.0);
@@ -119,34 +150,82 @@ void klsMiniMap::generateImage() {
 	//aleasing
 	glEnable( GL_LINE_SMOOTH );
 	//End of edit
-		
-	// Load the font texture
-	guiText::loadFont(wxGetApp().appSettings.textFontFile);
 
-	// Do the rendering here.
-	renderMap();
+	// (Re)make the page texture to fit the window:
+	// (Power-of-two sizes, since plain GL 1.1 needs them.)
+	if (pageTexture == 0) glGenTextures(1, &pageTexture);
+	if (width != imageWidth || height != imageHeight) {
+		imageWidth = width;
+		imageHeight = height;
+		textureWidth = textureHeight = 1;
+		while (textureWidth < width) textureWidth *= 2;
+		while (textureHeight < height) textureHeight *= 2;
+
+		glBindTexture(GL_TEXTURE_2D, pageTexture);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, textureWidth, textureHeight, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		pageValid = false;
+	}
+
+	klsBBox changedRegion = findChangedRegion();
+
+	if (!pageValid || areaChanged) {
+		// Render the whole page:
+		guiText::loadFont(wxGetApp().appSettings.textFontFile);
+		glClear(GL_COLOR_BUFFER_BIT);
+		renderMap(klsBBox());
+		copyToTexture(0, 0, width, height);
+		pageValid = true;
+	} else {
+		drawPageTexture();
+
+		// Only render the area that has changed:
+		if (!changedRegion.empty()) {
+			// Find the changed area in pixels, with a little extra for
+			// line widths:
+			double pixelsPerX = width / (maxCorner.x - minCorner.x);
+			double pixelsPerY = height / (minCorner.y - maxCorner.y);
+			int left = (int)floor((changedRegion.getLeft() - minCorner.x) * pixelsPerX) - 2;
+			int right = (int)ceil((changedRegion.getRight() - minCorner.x) * pixelsPerX) + 2;
+			int bottom = (int)floor((changedRegion.getBottom() - maxCorner.y) * pixelsPerY) - 2;
+			int top = (int)ceil((changedRegion.getTop() - maxCorner.y) * pixelsPerY) + 2;
+			left = max(left, 0);
+			bottom = max(bottom, 0);
+			right = min(right, width);
+			top = min(top, height);
+
+			if (right > left && top > bottom) {
+				guiText::loadFont(wxGetApp().appSettings.textFontFile);
+				glEnable(GL_SCISSOR_TEST);
+				glScissor(left, bottom, right - left, top - bottom);
+				glClear(GL_COLOR_BUFFER_BIT);
+				renderMap(changedRegion);
+				glDisable(GL_SCISSOR_TEST);
+				copyToTexture(left, bottom, right - left, top - bottom);
+			}
+		}
+	}
+
+	if (gateList->size() > 0) renderViewportRect();
 
 	// Flush the OpenGL buffer to make sure the rendering has happened:	
 	glFlush();
 	SwapBuffers();
 }
 
-void klsMiniMap::renderMap() {
-	int w, h;
-	GetClientSize(&w, &h);
+void klsMiniMap::renderMap( klsBBox region ) {
+	bool allObjects = region.empty();
 
-	//clear window
-	glClear(GL_COLOR_BUFFER_BIT);
 	glMatrixMode (GL_MODELVIEW);
 	glLoadIdentity ();
 	glColor4f( 0, 0, 0, 1 );
 	
 	// Draw the wires:
-	glMatrixMode (GL_MODELVIEW);
-	glLoadIdentity ();
 	unordered_map< unsigned long, guiWire* >::iterator thisWire = wireList->begin();
 	while( thisWire != wireList->end() ) {
-		if (thisWire->second != nullptr) {
+		if (thisWire->second != nullptr && (allObjects || region.overlaps((thisWire->second)->getBBox()))) {
 			(thisWire->second)->draw(false);
 		}
 		thisWire++;
@@ -155,15 +234,19 @@ void klsMiniMap::renderMap() {
 	// Draw the gates:
 	unordered_map< unsigned long, guiGate* >::iterator thisGate = gateList->begin();
 	while( thisGate != gateList->end() ) {
-		(thisGate->second)->draw(false);
+		if (allObjects || region.overlaps((thisGate->second)->getBBox())) {
+			(thisGate->second)->draw(false);
+		}
 		thisGate++;
 	}
-	
-	if (gateList->size() == 0) return;
+	glLoadIdentity();
+}
+
+void klsMiniMap::renderViewportRect() {
+	glMatrixMode (GL_MODELVIEW);
 	glLoadIdentity();
 	glColor4f( 1, 0, 0, 1 );
-	GLfloat lineWidthOld;
-	glGetFloatv(GL_LINE_WIDTH, &lineWidthOld);
+	glPushAttrib(GL_LINE_BIT);
 	glLineWidth(2.0);
 	glBegin(GL_LINE_LOOP);
 		glVertex2f( origin.x, origin.y );
@@ -171,7 +254,109 @@ void klsMiniMap::renderMap() {
 		glVertex2f( endpoint.x, endpoint.y );
 		glVertex2f( endpoint.x, origin.y );
 	glEnd();
-	glLineWidth(lineWidthOld);
+	glPopAttrib();
+}
+
+template< class T >
+void klsMiniMap::checkObject( T* obj, unordered_map< T*, renderedObject >& rendered,
+	unordered_map< T*, renderedObject >& newRendered, klsBBox& changed ) {
+	renderedObject now;
+	now.box = obj->getBBox();
+	now.revision = obj->getShapeRevision();
+
+	typename unordered_map< T*, renderedObject >::iterator old = rendered.find( obj );
+	if( old == rendered.end() ) {
+		changed.addBBox( now.box );
+	} else {
+		// (Some edits, like turning a square gate or dragging a wire
+		// segment inside the wire's extent, don't change the bbox, so the
+		// revision is checked as well.)
+		if( old->second.revision != now.revision ||
+			old->second.box.getBottomLeft() != now.box.getBottomLeft() ||
+			old->second.box.getTopRight() != now.box.getTopRight() ) {
+			changed.addBBox( old->second.box );
+			changed.addBBox( now.box );
+		}
+		rendered.erase( old );
+	}
+	newRendered[obj] = now;
+}
+
+klsBBox klsMiniMap::findChangedRegion() {
+	klsBBox changed;
+
+	// Gates:
+	unordered_map< guiGate*, renderedObject > gates;
+	unordered_map< unsigned long, guiGate* >::iterator thisGate = gateList->begin();
+	while( thisGate != gateList->end() ) {
+		checkObject( thisGate->second, renderedGates, gates, changed );
+		thisGate++;
+	}
+
+	// Whatever is left over was deleted:
+	unordered_map< guiGate*, renderedObject >::iterator goneGate = renderedGates.begin();
+	while( goneGate != renderedGates.end() ) {
+		changed.addBBox( goneGate->second.box );
+		goneGate++;
+	}
+	renderedGates.swap( gates );
+
+	// Wires:
+	unordered_map< guiWire*, renderedObject > wires;
+	unordered_map< unsigned long, guiWire* >::iterator thisWire = wireList->begin();
+	while( thisWire != wireList->end() ) {
+		if( thisWire->second != nullptr ) {
+			checkObject( thisWire->second, renderedWires, wires, changed );
+		}
+		thisWire++;
+	}
+
+	unordered_map< guiWire*, renderedObject >::iterator goneWire = renderedWires.begin();
+	while( goneWire != renderedWires.end() ) {
+		changed.addBBox( goneWire->second.box );
+		goneWire++;
+	}
+	renderedWires.swap( wires );
+
+	return changed;
+}
+
+void klsMiniMap::copyToTexture( int x, int y, int width, int height ) {
+	glBindTexture(GL_TEXTURE_2D, pageTexture);
+	glCopyTexSubImage2D(GL_TEXTURE_2D, 0, x, y, x, y, width, height);
+	glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void klsMiniMap::drawPageTexture() {
+	// Draw in pixel coordinates:
+	glMatrixMode(GL_PROJECTION);
+	glPushMatrix();
+	glLoadIdentity();
+	gluOrtho2D(0, imageWidth, 0, imageHeight);
+	glMatrixMode(GL_MODELVIEW);
+	glPushMatrix();
+	glLoadIdentity();
+
+	GLfloat s = (GLfloat) imageWidth / (GLfloat) textureWidth;
+	GLfloat t = (GLfloat) imageHeight / (GLfloat) textureHeight;
+
+	glColor4f( 1, 1, 1, 1 );
+	glEnable(GL_TEXTURE_2D);
+	glBindTexture(GL_TEXTURE_2D, pageTexture);
+	glBegin(GL_QUADS);
+		glTexCoord2f( 0, 0 ); glVertex2f( 0, 0 );
+		glTexCoord2f( s, 0 ); glVertex2f( imageWidth, 0 );
+		glTexCoord2f( s, t ); glVertex2f( imageWidth, imageHeight );
+		glTexCoord2f( 0, t ); glVertex2f( 0, imageHeight );
+	glEnd();
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glDisable(GL_TEXTURE_2D);
+	glColor4f( 0, 0, 0, 1 );
+
+	glMatrixMode(GL_PROJECTION);
+	glPopMatrix();
+	glMatrixMode(GL_MODELVIEW);
+	glPopMatrix();
 }
 
 void klsMiniMap::update(GLPoint2f origin, GLPoint2f endpoint) {
@@ -0,0 +1,74 @@
+/*****************************************************************************
+   Project: CEDAR Logic Simulator
+   Copyright 2006 Cedarville University, Benjamin Sprague,
+                     Matt Lewellyn, and David Knierim
+   All rights reserved.
+   For license information see license.txt included with distribution.
+
+   klsPrefixTrie: Finds the names that start with what has been typed
+*****************************************************************************/
+
+#include "klsPrefixTrie.h"
+#include <cctype>
+#include <set>
+
+klsPrefixTrie::klsPrefixTrie() {
+	clear();
+}
+
+void klsPrefixTrie::clear( void ) {
+	nodes.clear();
+	nodes.push_back( trieNode() );
+}
+
+void klsPrefixTrie::insert( const string& name, size_t value ) {
+	string key = fold( name );
+	size_t node = 0;
+	for( unsigned int i = 0; i < key.size(); i++ ) {
+		map< char, size_t >::iterator child = nodes[node].children.find( key[i] );
+		if( child == nodes[node].children.end() ) {
+			// (Take the index first, since push_back may move the nodes.)
+			size_t newNode = nodes.size();
+			nodes.push_back( trieNode() );
+			nodes[node].children[key[i]] = newNode;
+			node = newNode;
+		} else {
+			node = child->second;
+		}
+	}
+	nodes[node].values.push_back( value );
+}
+
+void klsPrefixTrie::find( const string& prefix, vector< size_t >& found ) const {
+	string key = fold( prefix );
+	size_t node = 0;
+	for( unsigned int i = 0; i < key.size(); i++ ) {
+		map< char, size_t >::const_iterator child = nodes[node].children.find( key[i] );
+		if( child == nodes[node].children.end() ) return;
+		node = child->second;
+	}
+
+	// Collect the values of the whole subtree below the prefix:
+	set< size_t > added;
+	vector< size_t > toVisit( 1, node );
+	while( !toVisit.empty() ) {
+		const trieNode& visit = nodes[toVisit.back()];
+		toVisit.pop_back();
+		for( unsigned int i = 0; i < visit.values.size(); i++ ) {
+			if( added.insert( visit.values[i] ).second ) found.push_back( visit.values[i] );
+		}
+		map< char, size_t >::const_iterator child = visit.children.begin();
+		while( child != visit.children.end() ) {
+			toVisit.push_back( child->second );
+			child++;
+		}
+	}
+}
+
+string klsPrefixTrie::fold( const string& name ) {
+	string folded = name;
+	for( unsigned int i = 0; i < folded.size(); i++ ) {
+		folded[i] = (char)tolower( (unsigned char)folded[i] );
+	}
+	return folded;
+}
@@ -0,0 +1,135 @@
+/*****************************************************************************
+   Project: CEDAR Logic Simulator
+   Copyright 2006 Cedarville University, Benjamin Sprague,
+                     Matt Lewellyn, and David Knierim
+   All rights reserved.
+   For license information see license.txt included with distribution.
+
+   klsSegmentDelta: The change between two shapes of a wire
+*****************************************************************************/
+
+#include "klsSegmentDelta.h"
+
+// (Roughly what a std::map node costs on top of its value.)
+#define MAP_NODE_OVERHEAD 32
+
+klsSegmentDelta::klsSegmentDelta() {
+	isShift = true;
+}
+
+klsSegmentDelta::klsSegmentDelta( const map < long, wireSegment >& oldMap, const map < long, wireSegment >& newMap ) {
+	// See if the whole wire was just shifted over:
+	isShift = ( oldMap.size() == newMap.size() );
+	if( isShift && !oldMap.empty() ) {
+		map < long, wireSegment >::const_iterator firstNew = newMap.find( oldMap.begin()->first );
+		if( firstNew == newMap.end() ) {
+			isShift = false;
+		} else {
+			shift = firstNew->second.begin - oldMap.begin()->second.begin;
+		}
+	}
+	map < long, wireSegment >::const_iterator oldWalk = oldMap.begin();
+	while( isShift && oldWalk != oldMap.end() ) {
+		map < long, wireSegment >::const_iterator newSeg = newMap.find( oldWalk->first );
+		if( newSeg == newMap.end() || !sameSegment( oldWalk->second, newSeg->second, shift.x, shift.y ) ) isShift = false;
+		oldWalk++;
+	}
+	if( isShift ) return;
+
+	// Otherwise, keep the segments that differ:
+	shift = GLPoint2f( 0, 0 );
+	map < long, wireSegment >::const_iterator newWalk = newMap.begin();
+	while( newWalk != newMap.end() ) {
+		map < long, wireSegment >::const_iterator oldSeg = oldMap.find( newWalk->first );
+		if( oldSeg == oldMap.end() || !sameSegment( oldSeg->second, newWalk->second, 0, 0 ) ) {
+			changed.insert( *newWalk );
+		}
+		newWalk++;
+	}
+	oldWalk = oldMap.begin();
+	while( oldWalk != oldMap.end() ) {
+		if( newMap.find( oldWalk->first ) == newMap.end() ) removed.push_back( oldWalk->first );
+		oldWalk++;
+	}
+}
+
+map < long, wireSegment > klsSegmentDelta::apply( const map < long, wireSegment >& oldMap ) const {
+	map < long, wireSegment > newMap;
+	if( isShift ) {
+		map < long, wireSegment >::const_iterator oldWalk = oldMap.begin();
+		while( oldWalk != oldMap.end() ) {
+			newMap.insert( make_pair( oldWalk->first, shiftSegment( oldWalk->second, shift.x, shift.y ) ) );
+			oldWalk++;
+		}
+		return newMap;
+	}
+
+	newMap = oldMap;
+	for( unsigned int i = 0; i < removed.size(); i++ ) newMap.erase( removed[i] );
+	map < long, wireSegment >::const_iterator changeWalk = changed.begin();
+	while( changeWalk != changed.end() ) {
+		newMap[changeWalk->first] = changeWalk->second;
+		changeWalk++;
+	}
+	return newMap;
+}
+
+size_t klsSegmentDelta::getMemorySize( void ) const {
+	return sizeof( klsSegmentDelta ) + getMemorySize( changed ) - sizeof( changed ) +
+		removed.capacity() * sizeof( long );
+}
+
+size_t klsSegmentDelta::getMemorySize( const map < long, wireSegment >& segMap ) {
+	size_t size = sizeof( segMap );
+	map < long, wireSegment >::const_iterator segWalk = segMap.begin();
+	while( segWalk != segMap.end() ) {
+		const wireSegment& seg = segWalk->second;
+		size += MAP_NODE_OVERHEAD + sizeof( *segWalk );
+		for( unsigned int i = 0; i < seg.connections.size(); i++ ) {
+			size += sizeof( wireConnection ) + seg.connections[i].connection.capacity();
+		}
+		map < GLfloat, vector < long > >::const_iterator isectWalk = seg.intersects.begin();
+		while( isectWalk != seg.intersects.end() ) {
+			size += MAP_NODE_OVERHEAD + sizeof( *isectWalk ) + isectWalk->second.capacity() * sizeof( long );
+			isectWalk++;
+		}
+		segWalk++;
+	}
+	return size;
+}
+
+bool klsSegmentDelta::sameSegment( const wireSegment& a, const wireSegment& b, GLfloat dx, GLfloat dy ) {
+	if( a.id != b.id || a.verticalSeg != b.verticalSeg ) return false;
+	if( a.begin.x + dx != b.begin.x || a.begin.y + dy != b.begin.y ||
+		a.end.x + dx != b.end.x || a.end.y + dy != b.end.y ) return false;
+
+	if( a.connections.size() != b.connections.size() ) return false;
+	for( unsigned int i = 0; i < a.connections.size(); i++ ) {
+		if( a.connections[i].cGate != b.connections[i].cGate || a.connections[i].gid != b.connections[i].gid ||
+			a.connections[i].connection != b.connections[i].connection ) return false;
+	}
+
+	// Intersections are keyed by position along the segment:
+	GLfloat keyShift = a.isVertical() ? dy : dx;
+	if( a.intersects.size() != b.intersects.size() ) return false;
+	map < GLfloat, vector < long > >::const_iterator aWalk = a.intersects.begin();
+	map < GLfloat, vector < long > >::const_iterator bWalk = b.intersects.begin();
+	while( aWalk != a.intersects.end() ) {
+		if( aWalk->first + keyShift != bWalk->first || aWalk->second != bWalk->second ) return false;
+		aWalk++;
+		bWalk++;
+	}
+	return true;
+}
+
+wireSegment klsSegmentDelta::shiftSegment( const wireSegment& seg, GLfloat dx, GLfloat dy ) {
+	wireSegment shifted( GLPoint2f( seg.begin.x + dx, seg.begin.y + dy ), GLPoint2f( seg.end.x + dx, seg.end.y + dy ), seg.verticalSeg, seg.id );
+	shifted.connections = seg.connections;
+	GLfloat keyShift = seg.isVertical() ? dy : dx;
+	map < GLfloat, vector < long > >::const_iterator isectWalk = seg.intersects.begin();
+	while( isectWalk != seg.intersects.end() ) {
+		shifted.intersects[isectWalk->first + keyShift] = isectWalk->second;
+		isectWalk++;
+	}
+	return shifted;
+}
@@ -0,0 +1,168 @@
+/*****************************************************************************
+   Project: CEDAR Logic Simulator
+   Copyright 2006 Cedarville University, Benjamin Sprague,
+                     Matt Lewellyn, and David Knierim
+   All rights reserved.
+   For license information see license.txt included with distribution.
+
+   klsSpatialGrid: Uniform grid of collision objects for area queries
+*****************************************************************************/
+
+#include "klsSpatialGrid.h"
+#include "klsCollisionChecker.h"
+
+unsigned long long klsSpatialGrid::cellRange::count( void ) const {
+	if( empty() ) return 0;
+	return (unsigned long long)(right - left + 1) * (unsigned long long)(top - bottom + 1);
+}
+
+bool klsSpatialGrid::cellRange::operator==( const cellRange& other ) const {
+	return left == other.left && bottom == other.bottom && right == other.right && top == other.top;
+}
+
+
+klsSpatialGrid::klsSpatialGrid( GLfloat cellSize ) : cellSize(cellSize) {
+}
+
+void klsSpatialGrid::update( klsCollisionObject* obj ) {
+	cellRange newCells = getCells( obj->getBBox() );
+
+	unordered_map< klsCollisionObject*, cellRange >::iterator oldCells = filed.find( obj );
+	if( oldCells != filed.end() ) {
+		// Nothing to do if the object is still in the same cells:
+		if( !newCells.empty() && oldCells->second == newCells ) return;
+		unfileObject( obj, oldCells->second );
+	}
+
+	fileObject( obj, newCells );
+	filed[obj] = newCells;
+}
+
+void klsSpatialGrid::remove( klsCollisionObject* obj ) {
+	unordered_map< klsCollisionObject*, cellRange >::iterator oldCells = filed.find( obj );
+	if( oldCells == filed.end() ) return;
+
+	unfileObject( obj, oldCells->second );
+	filed.erase( oldCells );
+}
+
+void klsSpatialGrid::clear( void ) {
+	cells.clear();
+	oversized.clear();
+	filed.clear();
+}
+
+void klsSpatialGrid::query( klsBBox box, CollisionGroup& found ) {
+	if( box.empty() ) return;
+
+	// Check the objects that aren't filed by cell:
+	CollisionGroup::iterator bigObj = oversized.begin();
+	while( bigObj != oversized.end() ) {
+		if( (*bigObj)->getBBox().overlaps( box ) ) found.insert( *bigObj );
+		bigObj++;
+	}
+
+	cellRange range = getCells( box );
+	if( range.empty() ) {
+		// The box is too big to walk cell by cell, so check everything:
+		unordered_map< klsCollisionObject*, cellRange >::iterator obj = filed.begin();
+		while( obj != filed.end() ) {
+			if( (obj->first)->getBBox().overlaps( box ) ) found.insert( obj->first );
+			obj++;
+		}
+		return;
+	}
+
+	// When the box covers more cells than are occupied (zoomed far out),
+	// walk the occupied cells instead of the box:
+	if( range.count() > cells.size() ) {
+		unordered_map< unsigned long long, vector< klsCollisionObject* > >::iterator cell = cells.begin();
+		while( cell != cells.end() ) {
+			for( unsigned int i = 0; i < (cell->second).size(); i++ ) {
+				if( (cell->second)[i]->getBBox().overlaps( box ) ) found.insert( (cell->second)[i] );
+			}
+			cell++;
+		}
+		return;
+	}
+
+	for( long x = range.left; x <= range.right; x++ ) {
+		for( long y = range.bottom; y <= range.top; y++ ) {
+			unordered_map< unsigned long long, vector< klsCollisionObject* > >::iterator cell = cells.find( cellKey( x, y ) );
+			if( cell == cells.end() ) continue;
+			for( unsigned int i = 0; i < (cell->second).size(); i++ ) {
+				if( (cell->second)[i]->getBBox().overlaps( box ) ) found.insert( (cell->second)[i] );
+			}
+		}
+	}
+}
+
+void klsSpatialGrid::query( GLPoint2f pt, CollisionGroup& found ) {
+	klsBBox ptBox;
+	ptBox.addPoint( pt );
+	query( ptBox, found );
+}
+
+// Get the cells that a box covers. Returns an empty range for an empty box,
+// or for a box that covers more than SPATIAL_GRID_MAX_CELLS cells:
+klsSpatialGrid::cellRange klsSpatialGrid::getCells( klsBBox box ) {
+	cellRange range;
+	range.left = range.bottom = 0;
+	range.right = range.top = -1;
+	if( box.empty() ) return range;
+
+	double left = floor( box.getLeft() / cellSize );
+	double right = floor( box.getRight() / cellSize );
+	double bottom = floor( box.getBottom() / cellSize );
+	double top = floor( box.getTop() / cellSize );
+	if( (right - left + 1) * (top - bottom + 1) > SPATIAL_GRID_MAX_CELLS ) return range;
+
+	range.left = (long)left;
+	range.right = (long)right;
+	range.bottom = (long)bottom;
+	range.top = (long)top;
+	return range;
+}
+
+unsigned long long klsSpatialGrid::cellKey( long x, long y ) {
+	return ((unsigned long long)(unsigned int)x << 32) | (unsigned long long)(unsigned int)y;
+}
+
+void klsSpatialGrid::fileObject( klsCollisionObject* obj, const cellRange& range ) {
+	if( range.empty() ) {
+		// Objects with no bbox can't overlap anything, so only keep
+		// the big ones:
+		if( !obj->getBBox().empty() ) oversized.insert( obj );
+		return;
+	}
+
+	for( long x = range.left; x <= range.right; x++ ) {
+		for( long y = range.bottom; y <= range.top; y++ ) {
+			cells[cellKey( x, y )].push_back( obj );
+		}
+	}
+}
+
+void klsSpatialGrid::unfileObject( klsCollisionObject* obj, const cellRange& range ) {
+	if( range.empty() ) {
+		oversized.erase( obj );
+		return;
+	}
+
+	for( long x = range.left; x <= range.right; x++ ) {
+		for( long y = range.bottom; y <= range.top; y++ ) {
+			unordered_map< unsigned long long, vector< klsCollisionObject* > >::iterator cell = cells.find( cellKey( x, y ) );
+			if( cell == cells.end() ) continue;
+
+			vector< klsCollisionObject* >& cellObjs = cell->second;
+			for( unsigned int i = 0; i < cellObjs.size(); i++ ) {
+				if( cellObjs[i] == obj ) {
+					cellObjs[i] = cellObjs.back();
+					cellObjs.pop_back();
+					break;
+				}
+			}
+			if( cellObjs.empty() ) cells.erase( cell );
+		}
+	}
+}
@@ -0,0 +1,126 @@
+/*****************************************************************************
+   Project: CEDAR Logic Simulator
+   Copyright 2006 Cedarville University, Benjamin Sprague,
+                     Matt Lewellyn, and David Knierim
+   All rights reserved.
+   For license information see license.txt included with distribution.
+
+   klsThumbnailAtlas: One image holding the palette pictures of every gate
+*****************************************************************************/
+
+#include "klsThumbnailAtlas.h"
+#include "MainApp.h"
+#include "GUICircuit.h"
+#include "guiGate.h"
+#include "guiText.h"
+#include "gateImage.h"
+#include "glToImage.h"
+#include "gl_wrapper.h"
+#include <vector>
+#include <algorithm>
+
+DECLARE_APP(MainApp)
+
+void klsThumbnailAtlas::build( wxWindow* parent ) {
+	if( atlas.IsOk() ) return;
+	cells.clear();
+
+	// Lay out one cell per gate:
+	vector < string > gateNames;
+	map < string, map < string, LibraryGate > >::iterator libWalk = wxGetApp().libraries.begin();
+	while( libWalk != wxGetApp().libraries.end() ) {
+		map < string, LibraryGate >::iterator gateWalk = (libWalk->second).begin();
+		while( gateWalk != (libWalk->second).end() ) {
+			gateNames.push_back( gateWalk->first );
+			gateWalk++;
+		}
+		libWalk++;
+	}
+	if( gateNames.empty() ) return;
+
+	int columns = min( (int)gateNames.size(), ATLAS_COLUMNS );
+	int rows = ((int)gateNames.size() + columns - 1) / columns;
+	int width = columns * GATEIMAGESIZE;
+	int height = rows * GATEIMAGESIZE;
+
+	glImageCtx glCtx( width, height, parent );
+
+	// Set the bitmap clear color:
+	glViewport( 0, 0, width, height );
+	glClearColor( 1.0, 1.0, 1.0, 0.0 );
+	glClear( GL_COLOR_BUFFER_BIT );
+
+	glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+	glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+	glEnable( GL_BLEND );
+	glTexEnvi( GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE );
+	glEnable( GL_LINE_SMOOTH );
+
+	// Load the font texture
+	guiText::loadFont( wxGetApp().appSettings.textFontFile );
+
+	// Keep each gate inside its own cell:
+	glEnable( GL_SCISSOR_TEST );
+	for( unsigned int i = 0; i < gateNames.size(); i++ ) {
+		guiGate* gate = GUICircuit().createGate( gateNames[i], 0, true );
+		if( gate == NULL ) continue;
+		gate->setGLcoords( 0, 0 );
+		gate->calcBBox();
+
+		// GL counts rows from the bottom, and the image from the top:
+		wxRect cell( (i % columns) * GATEIMAGESIZE, (i / columns) * GATEIMAGESIZE, GATEIMAGESIZE, GATEIMAGESIZE );
+		GLint glY = height - cell.y - GATEIMAGESIZE;
+		glViewport( cell.x, glY, GATEIMAGESIZE, GATEIMAGESIZE );
+		glScissor( cell.x, glY, GATEIMAGESIZE, GATEIMAGESIZE );
+
+		setProjection( gate->getModelBBox() );
+		glColor4f( 0, 0, 0, 1 );
+		gate->draw();
+		delete gate;
+
+		cells[gateNames[i]] = cell;
+	}
+	glDisable( GL_SCISSOR_TEST );
+
+	// Flush the OpenGL buffer to make sure the rendering has happened:
+	glFlush();
+
+	atlas = wxBitmap( glCtx.getImage() );
+}
+
+void klsThumbnailAtlas::clear( void ) {
+	atlas = wxNullBitmap;
+	cells.clear();
+}
+
+wxRect klsThumbnailAtlas::getRect( const string& gateName ) const {
+	map < string, wxRect >::const_iterator cell = cells.find( gateName );
+	if( cell == cells.end() ) return wxRect();
+	return cell->second;
+}
+
+void klsThumbnailAtlas::setProjection( klsBBox gateBox ) {
+	glMatrixMode( GL_PROJECTION );
+	glLoadIdentity();
+
+	GLPoint2f minCorner = GLPoint2f( gateBox.getLeft() - 0.5, gateBox.getTop() + 0.5 );
+	GLPoint2f maxCorner = GLPoint2f( gateBox.getRight() + 0.5, gateBox.getBottom() - 0.5 );
+	double mapWidth = maxCorner.x - minCorner.x;
+	double mapHeight = minCorner.y - maxCorner.y; // max and min corner's defs are weird...
+
+	// Center the gate in the square, fitting its longer side:
+	GLPoint2f orthoBoxTL, orthoBoxBR;
+	if( mapWidth >= mapHeight ) {
+		orthoBoxTL = GLPoint2f( minCorner.x, minCorner.y + 0.5*(mapWidth - mapHeight) );
+		orthoBoxBR = GLPoint2f( maxCorner.x, maxCorner.y - 0.5*(mapWidth - mapHeight) );
+	} else {
+		orthoBoxTL = GLPoint2f( minCorner.x - 0.5*(mapHeight - mapWidth), minCorner.y );
+		orthoBoxBR = GLPoint2f( maxCorner.x + 0.5*(mapHeight - mapWidth), maxCorner.y );
+	}
+
+	// gluOrtho2D(left, right, bottom, top); (In world-space coords.)
+	gluOrtho2D( orthoBoxTL.x, orthoBoxBR.x, orthoBoxBR.y, orthoBoxTL.y );
+
+	glMatrixMode( GL_MODELVIEW );
+	glLoadIdentity();
+}
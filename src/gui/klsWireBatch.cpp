@@ -0,0 +1,183 @@
+/*****************************************************************************
+   Project: CEDAR Logic Simulator
+   Copyright 2006 Cedarville University, Benjamin Sprague,
+                     Matt Lewellyn, and David Knierim
+   All rights reserved.
+   For license information see license.txt included with distribution.
+
+   klsWireBatch: Retained vertex arrays for drawing a page's wires at once
+*****************************************************************************/
+
+#include "klsWireBatch.h"
+#include "guiWire.h"
+#include "gl_defs.h"
+#include "MainApp.h"
+#include <cmath>
+#include <algorithm>
+
+DECLARE_APP(MainApp)
+
+void klsWireBatch::vertexArray::clear( void ) {
+	points.clear();
+	colors.clear();
+}
+
+void klsWireBatch::vertexArray::add( GLfloat x, GLfloat y, const GLfloat rgba[4] ) {
+	points.push_back( x );
+	points.push_back( y );
+	colors.insert( colors.end(), rgba, rgba + 4 );
+}
+
+void klsWireBatch::vertexArray::draw( GLenum mode ) {
+	if( points.empty() ) return;
+	glVertexPointer( 2, GL_FLOAT, 0, &points[0] );
+	glColorPointer( 4, GL_FLOAT, 0, &colors[0] );
+	glDrawArrays( mode, 0, (GLsizei)(points.size() / 2) );
+}
+
+void klsWireBatch::vertexArray::setColor( size_t first, size_t count, const GLfloat rgba[4] ) {
+	for( size_t i = first; i < first + count; i++ ) {
+		copy( rgba, rgba + 4, colors.begin() + i * 4 );
+	}
+}
+
+
+klsWireBatch::klsWireBatch() {
+	valid = false;
+	builtColor = true;
+	builtConnVisible = true;
+	builtConnRadius = 0;
+}
+
+void klsWireBatch::draw( const vector< guiWire* >& wires, bool color, bool detail ) {
+	if( !valid || builtWires != wires || builtColor != color ||
+		builtConnVisible != wxGetApp().appSettings.wireConnVisible ||
+		builtConnRadius != wxGetApp().appSettings.wireConnRadius ||
+		!updateColors( color ) ) {
+		rebuild( wires, color );
+	}
+
+	glEnableClientState( GL_VERTEX_ARRAY );
+	glEnableClientState( GL_COLOR_ARRAY );
+
+	wireLines.draw( GL_LINES );
+
+	glLineWidth( 4 );
+	busLines.draw( GL_LINES );
+	glLineWidth( 1 );
+
+	if( detail ) {
+		glPointSize( 4 );
+		busCaps.draw( GL_POINTS );
+		glPointSize( 1 );
+
+		connectDots.draw( GL_TRIANGLES );
+	}
+
+	glDisableClientState( GL_COLOR_ARRAY );
+	glDisableClientState( GL_VERTEX_ARRAY );
+
+	// Reset the color back to black:
+	glColor4f( 0.0, 0.0, 0.0, 1.0 );
+}
+
+void klsWireBatch::rebuild( const vector< guiWire* >& wires, bool color ) {
+	wireLines.clear();
+	busLines.clear();
+	busCaps.clear();
+	connectDots.clear();
+
+	records.clear();
+
+	bool connVisible = wxGetApp().appSettings.wireConnVisible;
+
+	for( unsigned int w = 0; w < wires.size(); w++ ) {
+		guiWire* wire = wires[w];
+		if( wire == nullptr ) continue;
+
+		wireRecord record;
+		record.wire = wire;
+		record.shapeRevision = wire->getShapeRevision();
+		record.stateRevision = wire->getStateRevision();
+		bool isBus = ( wire->getIDs().size() != 1 );
+		vertexArray &lines = ( isBus ? busLines : wireLines );
+		record.lines.first = lines.size();
+		record.caps.first = busCaps.size();
+		record.dots.first = connectDots.size();
+
+		if( wire->numConnections() >= 2 && !(color && wire->isSelected()) ) {
+			addWire( wire, isBus, connVisible, color );
+		}
+
+		record.lines.count = lines.size() - record.lines.first;
+		record.caps.count = busCaps.size() - record.caps.first;
+		record.dots.count = connectDots.size() - record.dots.first;
+		records.push_back( record );
+	}
+
+	valid = true;
+	builtWires = wires;
+	builtColor = color;
+	builtConnVisible = connVisible;
+	builtConnRadius = wxGetApp().appSettings.wireConnRadius;
+}
+
+bool klsWireBatch::updateColors( bool color ) {
+	GLfloat rgba[4];
+	for( unsigned int r = 0; r < records.size(); r++ ) {
+		wireRecord &record = records[r];
+		guiWire* wire = record.wire;
+		if( wire->getShapeRevision() != record.shapeRevision ) return false;
+		if( wire->getStateRevision() == record.stateRevision ) continue;
+		record.stateRevision = wire->getStateRevision();
+
+		// (Without color, every wire is black whatever its state.)
+		if( !color ) continue;
+		wire->getColor( rgba, color );
+		bool isBus = ( wire->getIDs().size() != 1 );
+		( isBus ? busLines : wireLines ).setColor( record.lines.first, record.lines.count, rgba );
+		busCaps.setColor( record.caps.first, record.caps.count, rgba );
+		connectDots.setColor( record.dots.first, record.dots.count, rgba );
+	}
+	return true;
+}
+
+void klsWireBatch::addWire( guiWire* wire, bool isBus, bool connVisible, bool color ) {
+	GLfloat rgba[4];
+	wire->getColor( rgba, color );
+
+	const vector< GLLine2f > &lineSegments = wire->getLineSegments();
+	vertexArray &lines = ( isBus ? busLines : wireLines );
+	for( unsigned int i = 0; i < lineSegments.size(); i++ ) {
+		lines.add( lineSegments[i].begin.x, lineSegments[i].begin.y, rgba );
+		lines.add( lineSegments[i].end.x, lineSegments[i].end.y, rgba );
+		if( isBus ) {
+			busCaps.add( lineSegments[i].begin.x, lineSegments[i].begin.y, rgba );
+			busCaps.add( lineSegments[i].end.x, lineSegments[i].end.y, rgba );
+		}
+	}
+
+	const vector< GLPoint2f > &isectPoints = wire->getIntersectPoints();
+	for( unsigned int i = 0; i < isectPoints.size(); i++ ) {
+		addConnectDot( isectPoints[i].x, isectPoints[i].y, rgba );
+	}
+	if( connVisible ) {
+		const vector< GLPoint2f > &vertexPoints = wire->getVertexPoints();
+		for( unsigned int i = 0; i < vertexPoints.size(); i++ ) {
+			addConnectDot( vertexPoints[i].x, vertexPoints[i].y, rgba );
+		}
+	}
+}
+
+void klsWireBatch::addConnectDot( GLfloat x, GLfloat y, const GLfloat rgba[4] ) {
+	// The same fan as CEDAR_GLLIST_CONNECTPOINT, split into triangles:
+	float radius = wxGetApp().appSettings.wireConnRadius;
+	int step = 360 / POINTS_PER_VERTEX;
+	for( int z = 0; z < 360; z += step ) {
+		float a1 = z * DEG2RAD;
+		float a2 = (z + step) * DEG2RAD;
+		connectDots.add( x, y, rgba );
+		connectDots.add( x + cos(a1) * radius, y + sin(a1) * radius, rgba );
+		connectDots.add( x + cos(a2) * radius, y + sin(a2) * radius, rgba );
+	}
+}
@@ -15,16 +15,190 @@
 #include "MainApp.h"
 #include "logic_values.h"
 #include "wireSegment.h"
-#include <iomanip>
+#include <algorithm>
+#include <cctype>
 #include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <map>
 #include <string>
 #include <sstream>
+#include <vector>
+
+// Bytes of SVG text to collect before handing them to the file:
+#define SVG_WRITE_BUFFER_SIZE 262144
+
+// Writes the SVG text straight to the file through a large buffer, without
+// building up strings along the way. Numbers are written with two decimals.
+class svgWriter {
+public:
+    svgWriter(const std::string& filename) {
+        file = fopen(filename.c_str(), "wb");
+        failed = (file == NULL);
+        buffer.reserve(SVG_WRITE_BUFFER_SIZE + 256);
+    }
+
+    ~svgWriter() {
+        close();
+    }
+
+    bool isOpen() const { return file != NULL; }
+
+    // Flush the buffer and close the file. Returns false if any write failed.
+    bool close() {
+        if (file != NULL) {
+            flush();
+            if (fclose(file) != 0) failed = true;
+            file = NULL;
+        }
+        return !failed;
+    }
+
+    svgWriter& operator<<(const char* text) {
+        buffer.insert(buffer.end(), text, text + strlen(text));
+        return checkFlush();
+    }
+
+    svgWriter& operator<<(const std::string& text) {
+        buffer.insert(buffer.end(), text.begin(), text.end());
+        return checkFlush();
+    }
+
+    svgWriter& operator<<(double value) {
+        // (Don't write tiny negative values as "-0.00")
+        if (fabs(value) < 0.005) value = 0;
+        char number[64];
+        int length = snprintf(number, sizeof(number), "%.2f", value);
+        if (length > 0) buffer.insert(buffer.end(), number, number + std::min(length, (int)sizeof(number) - 1));
+        return checkFlush();
+    }
+
+    svgWriter& operator<<(float value) { return *this << (double)value; }
+
+    svgWriter& operator<<(int value) { return *this << (long)value; }
+
+    svgWriter& operator<<(long value) {
+        char number[32];
+        int length = snprintf(number, sizeof(number), "%ld", value);
+        if (length > 0) buffer.insert(buffer.end(), number, number + length);
+        return checkFlush();
+    }
+
+    svgWriter& operator<<(unsigned long value) { return *this << (unsigned long long)value; }
+
+    svgWriter& operator<<(unsigned long long value) {
+        char number[32];
+        int length = snprintf(number, sizeof(number), "%llu", value);
+        if (length > 0) buffer.insert(buffer.end(), number, number + length);
+        return checkFlush();
+    }
+
+private:
+    svgWriter& checkFlush() {
+        if (buffer.size() >= SVG_WRITE_BUFFER_SIZE) flush();
+        return *this;
+    }
+
+    void flush() {
+        if (file != NULL && !buffer.empty()) {
+            if (fwrite(&buffer[0], 1, buffer.size(), file) != buffer.size()) failed = true;
+        }
+        buffer.clear();
+    }
+
+    FILE* file;
+    bool failed;
+    std::vector<char> buffer;
+};
+
+// The lines of a library gate, written once as a <symbol>:
+struct gateSymbol {
+    std::string id;
+    std::vector<GLPoint2f> vertices;
+};
+
+// Turn a library gate name into something that can go in an id attribute:
+static std::string symbolName(const std::string& gateName) {
+    std::string name = gateName;
+    for (char& c : name) {
+        if (!isalnum((unsigned char)c) && c != '_' && c != '-') c = '_';
+    }
+    return name;
+}
+
+// Join line segments (given as pairs of points, like GL_LINES) that share
+// end points into polylines, and drop the points in the middle of straight
+// runs, so that each run is written once instead of segment by segment.
+static void buildPolylines(const std::vector<GLPoint2f>& lines,
+                           std::vector< std::vector<GLPoint2f> >& polylines) {
+    // The segments that end at each point:
+    std::map< std::pair<float, float>, std::vector<size_t> > ends;
+    for (size_t i = 0; i + 1 < lines.size(); i += 2) {
+        if (lines[i].x == lines[i+1].x && lines[i].y == lines[i+1].y) continue;
+        ends[std::make_pair(lines[i].x, lines[i].y)].push_back(i);
+        ends[std::make_pair(lines[i+1].x, lines[i+1].y)].push_back(i);
+    }
+
+    std::vector<bool> used(lines.size(), false);
+    auto degree = [&](const GLPoint2f& pt) {
+        return ends[std::make_pair(pt.x, pt.y)].size();
+    };
+
+    // Follow the chain from a segment's end through every point that joins
+    // exactly two segments:
+    auto walk = [&](size_t seg, GLPoint2f from) {
+        std::vector<GLPoint2f> poly;
+        poly.push_back(from);
+        while (true) {
+            used[seg] = true;
+            bool fromBegin = (lines[seg].x == from.x && lines[seg].y == from.y);
+            GLPoint2f to = fromBegin ? lines[seg+1] : lines[seg];
+
+            // Extend the last run instead of adding a point if the turn is
+            // straight ahead:
+            if (poly.size() >= 2) {
+                const GLPoint2f& a = poly[poly.size()-2];
+                const GLPoint2f& b = poly.back();
+                float cross = (b.x - a.x) * (to.y - b.y) - (b.y - a.y) * (to.x - b.x);
+                float dot = (b.x - a.x) * (to.x - b.x) + (b.y - a.y) * (to.y - b.y);
+                if (fabs(cross) < 1e-6 && dot > 0) poly.pop_back();
+            }
+            poly.push_back(to);
+
+            if (degree(to) != 2) break;
+            const std::vector<size_t>& next = ends[std::make_pair(to.x, to.y)];
+            size_t nextSeg = (next[0] == seg) ? next[1] : next[0];
+            if (used[nextSeg]) break;
+            seg = nextSeg;
+            from = to;
+        }
+        polylines.push_back(poly);
+    };
+
+    // Start at the ends and branch points first, then pick up the loops:
+    for (size_t i = 0; i + 1 < lines.size(); i += 2) {
+        if (used[i] || ends.find(std::make_pair(lines[i].x, lines[i].y)) == ends.end()) continue;
+        if (degree(lines[i]) != 2) walk(i, lines[i]);
+        else if (degree(lines[i+1]) != 2) walk(i, lines[i+1]);
+    }
+    for (size_t i = 0; i + 1 < lines.size(); i += 2) {
+        if (used[i] || ends.find(std::make_pair(lines[i].x, lines[i].y)) == ends.end()) continue;
+        walk(i, lines[i]);
+    }
+}
 
-// Helper to convert float to string with precision
-static std::string floatToStr(float value, int precision = 2) {
-    std::ostringstream oss;
-    oss << std::fixed << std::setprecision(precision) << value;
-    return oss.str();
+// Write polylines as points attributes, flipping each y with the given function:
+template <typename FlipFunc>
+static void writePolylines(svgWriter& svgFile, const std::vector< std::vector<GLPoint2f> >& polylines,
+                           const char* indent, FlipFunc flip) {
+    for (const auto& poly : polylines) {
+        svgFile << indent << "<polyline points=\"";
+        for (size_t i = 0; i < poly.size(); i++) {
+            if (i > 0) svgFile << " ";
+            svgFile << poly[i].x << "," << flip(poly[i].y);
+        }
+        svgFile << "\"/>\n";
+    }
 }
 
 // Helper to flip Y coordinate from OpenGL to SVG for world coordinates
@@ -54,16 +228,16 @@ std::string SVGExporter::escapeXML(const std::string& str) {
     return result;
 }
 
-std::string SVGExporter::getSVGHeader(float width, float height, float viewX, float viewY,
-                                      float viewWidth, float viewHeight) {
-    std::ostringstream oss;
+void SVGExporter::writeSVGHeader(svgWriter& oss, float width, float height, float viewX, float viewY,
+                                float viewWidth, float viewHeight) {
     oss << "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\"?>\n";
     // ViewBox: Use regular coordinates since we flip Y individually
     oss << "<svg xmlns=\"http://www.w3.org/2000/svg\" "
-        << "width=\"" << floatToStr(width) << "\" "
-        << "height=\"" << floatToStr(height) << "\" "
-        << "viewBox=\"" << floatToStr(viewX) << " " << floatToStr(viewY) << " "
-        << floatToStr(viewWidth) << " " << floatToStr(viewHeight) << "\">\n";
+        << "xmlns:xlink=\"http://www.w3.org/1999/xlink\" "
+        << "width=\"" << width << "\" "
+        << "height=\"" << height << "\" "
+        << "viewBox=\"" << viewX << " " << viewY << " "
+        << viewWidth << " " << viewHeight << "\">\n";
     oss << "  <defs>\n";
     oss << "    <style type=\"text/css\">\n";
     oss << "      .gate-line { fill: none; stroke: black; stroke-width: 0.1; }\n";
@@ -75,12 +249,11 @@ std::string SVGExporter::getSVGHeader(float width, float height, float viewX, fl
     oss << "      .grid-line { stroke: #00000014; stroke-width: 0.05; }\n";
     oss << "    </style>\n";
     oss << "  </defs>\n";
-    return oss.str();
 }
 
-std::string SVGExporter::getSVGFooter() {
+void SVGExporter::writeSVGFooter(svgWriter& oss) {
     // Close the canvas group and the SVG
-    return "  </g>\n</svg>\n";
+    oss << "  </g>\n</svg>\n";
 }
 
 std::string SVGExporter::getWireColorSVG(int state, bool noColor) {
@@ -107,8 +280,8 @@ bool SVGExporter::exportToSVG(GUICanvas* canvas, const std::string& filename,
                               bool showGrid, bool noColor, float scale) {
     if (!canvas) return false;
 
-    std::ofstream svgFile(filename);
-    if (!svgFile.is_open()) return false;
+    svgWriter svgFile(filename);
+    if (!svgFile.isOpen()) return false;
 
     // Get canvas bounds
     wxSize canvasSize = canvas->GetClientSize();
@@ -129,16 +302,16 @@ bool SVGExporter::exportToSVG(GUICanvas* canvas, const std::string& filename,
     float outputHeight = canvasSize.GetHeight() * scale;
 
     // Write SVG header (no transform, we'll flip Y coordinates manually)
-    svgFile << getSVGHeader(outputWidth, outputHeight, viewX, viewY, viewWidth, viewHeight);
+    writeSVGHeader(svgFile, outputWidth, outputHeight, viewX, viewY, viewWidth, viewHeight);
 
     // Debug comment with values
     svgFile << "  <!-- Debug: viewX=" << viewX << " viewY=" << viewY
             << " viewWidth=" << viewWidth << " viewHeight=" << viewHeight
-            << " panX=" << panX << " panY=" << panY << " -->\n";
+            << " panX=" << (double)panX << " panY=" << (double)panY << " -->\n";
 
     // White background
-    svgFile << "  <rect x=\"" << floatToStr(viewX) << "\" y=\"" << floatToStr(viewY)
-            << "\" width=\"" << floatToStr(viewWidth) << "\" height=\"" << floatToStr(viewHeight)
+    svgFile << "  <rect x=\"" << viewX << "\" y=\"" << viewY
+            << "\" width=\"" << viewWidth << "\" height=\"" << viewHeight
             << "\" fill=\"white\"/>\n";
 
     // Start the canvas group
@@ -146,7 +319,8 @@ bool SVGExporter::exportToSVG(GUICanvas* canvas, const std::string& filename,
 
     // Draw grid if requested (inside the transformed canvas group)
     if (showGrid) {
-        svgFile << "    <g id=\"grid\">\n";
+        // All of the grid lines go in one path
+        svgFile << "    <path id=\"grid\" class=\"grid-line\" d=\"";
 
         // Grid spacing - use same logic as the OpenGL renderer
         float gridSpacing = 1.0; // Base grid spacing in world units
@@ -159,23 +333,22 @@ bool SVGExporter::exportToSVG(GUICanvas* canvas, const std::string& filename,
 
         // Vertical lines
         for (float x = gridLeft; x <= gridRight; x += gridSpacing) {
-            svgFile << "      <line x1=\"" << floatToStr(x) << "\" y1=\"" << floatToStr(flipY(viewY, viewY, viewHeight))
-                    << "\" x2=\"" << floatToStr(x) << "\" y2=\"" << floatToStr(flipY(viewY + viewHeight, viewY, viewHeight))
-                    << "\" class=\"grid-line\"/>\n";
+            svgFile << "M" << x << "," << flipY(viewY, viewY, viewHeight)
+                    << "V" << flipY(viewY + viewHeight, viewY, viewHeight);
         }
 
         // Horizontal lines
         for (float y = gridBottom; y <= gridTop; y += gridSpacing) {
-            svgFile << "      <line x1=\"" << floatToStr(viewX) << "\" y1=\"" << floatToStr(flipY(y, viewY, viewHeight))
-                    << "\" x2=\"" << floatToStr(viewX + viewWidth) << "\" y2=\"" << floatToStr(flipY(y, viewY, viewHeight))
-                    << "\" class=\"grid-line\"/>\n";
+            svgFile << "M" << viewX << "," << flipY(y, viewY, viewHeight)
+                    << "H" << viewX + viewWidth;
         }
 
-        svgFile << "    </g>\n";
+        svgFile << "\"/>\n";
     }
 
     // Draw gates
     svgFile << "    <g id=\"gates\">\n";
+    std::map< std::string, std::vector<gateSymbol> > symbols;
     std::unordered_map<unsigned long, guiGate*>* gateList = canvas->getGateList();
     for (auto& gatePair : *gateList) {
         guiGate* gate = gatePair.second;
@@ -184,15 +357,13 @@ bool SVGExporter::exportToSVG(GUICanvas* canvas, const std::string& filename,
         float gateX, gateY;
         gate->getGLcoords(gateX, gateY);
 
-        // Get gate's transformation matrix
-        // We need to extract the transformed vertices
+        // Selected gates get a dashed outline, which the symbol's lines
+        // inherit from the <use>
         std::string pathClass = "gate-line";
         if (gate->isSelected() && !noColor) {
             pathClass += " gate-selected";
         }
 
-        svgFile << "      <g id=\"gate_" << gate->getID() << "\">\n";
-
         // Get gate parameters for rotation
         std::string angleStr = gate->getGUIParam("angle");
         float angle = 0;
@@ -201,33 +372,52 @@ bool SVGExporter::exportToSVG(GUICanvas* canvas, const std::string& filename,
             iss >> angle;
         }
 
-        // Get the vertices (they are in model space, pairs for lines)
-        // We need to transform them through the gate's model matrix
-        // Negate angle because Y-axis is flipped in SVG
-        // Note: angle is already in degrees (used with glRotatef)
-        std::ostringstream transform;
-        transform << "translate(" << floatToStr(gateX) << "," << floatToStr(flipY(gateY, viewY, viewHeight)) << ")";
-        if (angle != 0) {
-            transform << " rotate(" << floatToStr(-angle) << ")";
-        }
-
         // Export gate shape using actual vertices
         // Vertices are stored as pairs for GL_LINES
         const auto& vertices = gate->getVertices();
 
-        svgFile << "        <g transform=\"" << transform.str() << "\">\n";
-
-        // Draw all the lines that make up the gate
-        // Vertices come in pairs (GL_LINES format)
-        // Flip Y coordinates of vertices (these are local coordinates)
-        for (size_t i = 0; i + 1 < vertices.size(); i += 2) {
-            svgFile << "          <line x1=\"" << floatToStr(vertices[i].x)
-                    << "\" y1=\"" << floatToStr(flipLocalY(vertices[i].y))
-                    << "\" x2=\"" << floatToStr(vertices[i+1].x)
-                    << "\" y2=\"" << floatToStr(flipLocalY(vertices[i+1].y))
-                    << "\" class=\"" << pathClass << "\"/>\n";
+        // Gates from the same library entry share their lines, so define
+        // them once as a symbol and reuse it. (If a gate's lines ever differ
+        // from its entry's, it gets a symbol of its own.)
+        std::vector<gateSymbol>& variants = symbols[gate->getLibraryGateName()];
+        std::string symbolID;
+        for (const gateSymbol& variant : variants) {
+            if (variant.vertices == vertices) {
+                symbolID = variant.id;
+                break;
+            }
+        }
+        if (symbolID.empty()) {
+            gateSymbol variant;
+            variant.vertices = vertices;
+            variant.id = "sym_" + symbolName(gate->getLibraryGateName());
+            if (!variants.empty()) variant.id += "_" + std::to_string(variants.size());
+            variants.push_back(variant);
+            symbolID = variant.id;
+
+            // Draw all the lines that make up the gate, joined into polylines
+            // Flip Y coordinates of vertices (these are local coordinates)
+            std::vector< std::vector<GLPoint2f> > polylines;
+            buildPolylines(vertices, polylines);
+            svgFile << "      <defs>\n";
+            svgFile << "        <symbol id=\"" << symbolID << "\" overflow=\"visible\">\n";
+            svgFile << "          <g class=\"gate-line\">\n";
+            writePolylines(svgFile, polylines, "            ", flipLocalY);
+            svgFile << "          </g>\n";
+            svgFile << "        </symbol>\n";
+            svgFile << "      </defs>\n";
         }
 
+        // Negate angle because Y-axis is flipped in SVG
+        // Note: angle is already in degrees (used with glRotatef)
+        svgFile << "      <g id=\"gate_" << gate->getID() << "\" transform=\"translate("
+                << gateX << "," << flipY(gateY, viewY, viewHeight) << ")";
+        if (angle != 0) {
+            svgFile << " rotate(" << -angle << ")";
+        }
+        svgFile << "\">\n";
+        svgFile << "        <use xlink:href=\"#" << symbolID << "\" class=\"" << pathClass << "\"/>\n";
+
         // Special handling for KEYPAD gates (highlight selected key)
         if (gate->getGUIType() == "KEYPAD" && !noColor) {
             // Get the current output value to determine which key is selected
@@ -260,10 +450,10 @@ bool SVGExporter::exportToSVG(GUICanvas* canvas, const std::string& filename,
 
                     // Draw the highlight rectangle
                     svgFile << "          <!-- Keypad selected key highlight -->\n";
-                    svgFile << "          <rect x=\"" << floatToStr(minx)
-                            << "\" y=\"" << floatToStr(flipLocalY(maxy))
-                            << "\" width=\"" << floatToStr(maxx - minx)
-                            << "\" height=\"" << floatToStr(maxy - miny)
+                    svgFile << "          <rect x=\"" << minx
+                            << "\" y=\"" << flipLocalY(maxy)
+                            << "\" width=\"" << maxx - minx
+                            << "\" height=\"" << maxy - miny
                             << "\" fill=\"rgba(0,102,255,0.3)\" stroke=\"none\"/>\n";
                 }
             }
@@ -319,58 +509,58 @@ bool SVGExporter::exportToSVG(GUICanvas* canvas, const std::string& filename,
 
                     // Top segment
                     if (c != '1' && c != '4' && c != 'B' && c != 'D') {
-                        svgFile << "          <line x1=\"" << floatToStr(baseX + diffx*0.1875)
-                                << "\" y1=\"" << floatToStr(flipLocalY(boxY1 + diffy*0.88462))
-                                << "\" x2=\"" << floatToStr(baseX + diffx*0.8125)
-                                << "\" y2=\"" << floatToStr(flipLocalY(boxY1 + diffy*0.88462))
+                        svgFile << "          <line x1=\"" << baseX + diffx*0.1875
+                                << "\" y1=\"" << flipLocalY(boxY1 + diffy*0.88462)
+                                << "\" x2=\"" << baseX + diffx*0.8125
+                                << "\" y2=\"" << flipLocalY(boxY1 + diffy*0.88462)
                                 << "\" stroke=\"" << segColor << "\" stroke-width=\"0.2\"/>\n";
                     }
                     // Middle segment
                     if (c != '0' && c != '1' && c != '7' && c != 'C') {
-                        svgFile << "          <line x1=\"" << floatToStr(baseX + diffx*0.1875)
-                                << "\" y1=\"" << floatToStr(flipLocalY(boxY1 + diffy*0.5))
-                                << "\" x2=\"" << floatToStr(baseX + diffx*0.8125)
-                                << "\" y2=\"" << floatToStr(flipLocalY(boxY1 + diffy*0.5))
+                        svgFile << "          <line x1=\"" << baseX + diffx*0.1875
+                                << "\" y1=\"" << flipLocalY(boxY1 + diffy*0.5)
+                                << "\" x2=\"" << baseX + diffx*0.8125
+                                << "\" y2=\"" << flipLocalY(boxY1 + diffy*0.5)
                                 << "\" stroke=\"" << segColor << "\" stroke-width=\"0.2\"/>\n";
                     }
                     // Bottom segment
                     if (c != '1' && c != '4' && c != '7' && c != '9' && c != 'A' && c != 'F') {
-                        svgFile << "          <line x1=\"" << floatToStr(baseX + diffx*0.1875)
-                                << "\" y1=\"" << floatToStr(flipLocalY(boxY1 + diffy*0.11538))
-                                << "\" x2=\"" << floatToStr(baseX + diffx*0.8125)
-                                << "\" y2=\"" << floatToStr(flipLocalY(boxY1 + diffy*0.11538))
+                        svgFile << "          <line x1=\"" << baseX + diffx*0.1875
+                                << "\" y1=\"" << flipLocalY(boxY1 + diffy*0.11538)
+                                << "\" x2=\"" << baseX + diffx*0.8125
+                                << "\" y2=\"" << flipLocalY(boxY1 + diffy*0.11538)
                                 << "\" stroke=\"" << segColor << "\" stroke-width=\"0.2\"/>\n";
                     }
                     // Top-left segment
                     if (c != '1' && c != '2' && c != '3' && c != '7' && c != 'D') {
-                        svgFile << "          <line x1=\"" << floatToStr(baseX + diffx*0.1875)
-                                << "\" y1=\"" << floatToStr(flipLocalY(boxY1 + diffy*0.88462))
-                                << "\" x2=\"" << floatToStr(baseX + diffx*0.1875)
-                                << "\" y2=\"" << floatToStr(flipLocalY(boxY1 + diffy*0.5))
+                        svgFile << "          <line x1=\"" << baseX + diffx*0.1875
+                                << "\" y1=\"" << flipLocalY(boxY1 + diffy*0.88462)
+                                << "\" x2=\"" << baseX + diffx*0.1875
+                                << "\" y2=\"" << flipLocalY(boxY1 + diffy*0.5)
                                 << "\" stroke=\"" << segColor << "\" stroke-width=\"0.2\"/>\n";
                     }
                     // Top-right segment
                     if (c != '5' && c != '6' && c != 'B' && c != 'C' && c != 'E' && c != 'F') {
-                        svgFile << "          <line x1=\"" << floatToStr(baseX + diffx*0.8125)
-                                << "\" y1=\"" << floatToStr(flipLocalY(boxY1 + diffy*0.88462))
-                                << "\" x2=\"" << floatToStr(baseX + diffx*0.8125)
-                                << "\" y2=\"" << floatToStr(flipLocalY(boxY1 + diffy*0.5))
+                        svgFile << "          <line x1=\"" << baseX + diffx*0.8125
+                                << "\" y1=\"" << flipLocalY(boxY1 + diffy*0.88462)
+                                << "\" x2=\"" << baseX + diffx*0.8125
+                                << "\" y2=\"" << flipLocalY(boxY1 + diffy*0.5)
                                 << "\" stroke=\"" << segColor << "\" stroke-width=\"0.2\"/>\n";
                     }
                     // Bottom-left segment
                     if (c != '1' && c != '3' && c != '4' && c != '5' && c != '7' && c != '9') {
-                        svgFile << "          <line x1=\"" << floatToStr(baseX + diffx*0.1875)
-                                << "\" y1=\"" << floatToStr(flipLocalY(boxY1 + diffy*0.11538))
-                                << "\" x2=\"" << floatToStr(baseX + diffx*0.1875)
-                                << "\" y2=\"" << floatToStr(flipLocalY(boxY1 + diffy*0.5))
+                        svgFile << "          <line x1=\"" << baseX + diffx*0.1875
+                                << "\" y1=\"" << flipLocalY(boxY1 + diffy*0.11538)
+                                << "\" x2=\"" << baseX + diffx*0.1875
+                                << "\" y2=\"" << flipLocalY(boxY1 + diffy*0.5)
                                 << "\" stroke=\"" << segColor << "\" stroke-width=\"0.2\"/>\n";
                     }
                     // Bottom-right segment
                     if (c != '2' && c != 'C' && c != 'E' && c != 'F') {
-                        svgFile << "          <line x1=\"" << floatToStr(baseX + diffx*0.8125)
-                                << "\" y1=\"" << floatToStr(flipLocalY(boxY1 + diffy*0.11538))
-                                << "\" x2=\"" << floatToStr(baseX + diffx*0.8125)
-                                << "\" y2=\"" << floatToStr(flipLocalY(boxY1 + diffy*0.5))
+                        svgFile << "          <line x1=\"" << baseX + diffx*0.8125
+                                << "\" y1=\"" << flipLocalY(boxY1 + diffy*0.11538)
+                                << "\" x2=\"" << baseX + diffx*0.8125
+                                << "\" y2=\"" << flipLocalY(boxY1 + diffy*0.5)
                                 << "\" stroke=\"" << segColor << "\" stroke-width=\"0.2\"/>\n";
                     }
                 }
@@ -397,7 +587,7 @@ bool SVGExporter::exportToSVG(GUICanvas* canvas, const std::string& filename,
             svgFile << "          <!-- Gate label text -->\n";
             svgFile << "          <text x=\"0\" y=\"0\" "
                     << "font-family=\"Arial, sans-serif\" "
-                    << "font-size=\"" << floatToStr(fontSize) << "\" "
+                    << "font-size=\"" << fontSize << "\" "
                     << "font-weight=\"bold\" "
                     << "fill=\"" << textColor << "\" "
                     << "text-anchor=\"middle\" "
@@ -405,7 +595,6 @@ bool SVGExporter::exportToSVG(GUICanvas* canvas, const std::string& filename,
                     << escapeXML(labelText) << "</text>\n";
         }
 
-        svgFile << "        </g>\n";
         svgFile << "      </g>\n";
     }
     svgFile << "    </g>\n";
@@ -423,6 +612,7 @@ bool SVGExporter::exportToSVG(GUICanvas* canvas, const std::string& filename,
         // Get wire state for color
         auto states = wire->getState();
         int dominantState = states.empty() ? ZERO : states[0];
+        std::string colorAttr;
 
         // For buses, calculate the redness gradient
         if (isBus && !noColor) {
@@ -453,45 +643,27 @@ bool SVGExporter::exportToSVG(GUICanvas* canvas, const std::string& filename,
                 redness /= pow(2, states.size()) - 1;
                 // Use gradient for bus wires
                 int r = (int)(redness * 255);
-                std::ostringstream colorStream;
-                colorStream << "stroke=\"rgb(" << r << ",0,0)\"";
-                wireClass = "wire-line wire-bus";
-
-                svgFile << "      <g id=\"wire_" << wire->getID() << "\">\n";
-
-                // Draw wire segments
-                auto segMap = wire->getSegmentMap();
-                for (auto& seg : segMap) {
-                    wireSegment& segment = seg.second;
-                    svgFile << "        <line x1=\"" << floatToStr(segment.begin.x)
-                            << "\" y1=\"" << floatToStr(flipY(segment.begin.y, viewY, viewHeight))
-                            << "\" x2=\"" << floatToStr(segment.end.x)
-                            << "\" y2=\"" << floatToStr(flipY(segment.end.y, viewY, viewHeight))
-                            << "\" class=\"" << wireClass << "\" "
-                            << colorStream.str() << "/>\n";
-                }
-
-                svgFile << "      </g>\n";
-                continue;
+                colorAttr = "stroke=\"rgb(" + std::to_string(r) + ",0,0)\"";
             }
         }
 
-        std::string colorAttr = getWireColorSVG(dominantState, noColor);
-
-        svgFile << "      <g id=\"wire_" << wire->getID() << "\">\n";
+        if (colorAttr.empty()) colorAttr = getWireColorSVG(dominantState, noColor);
 
-        // Draw wire segments
+        // Draw wire segments, joined into polylines
+        // (The class and color are inherited from the wire's group.)
+        std::vector<GLPoint2f> lines;
         auto segMap = wire->getSegmentMap();
         for (auto& seg : segMap) {
-            wireSegment& segment = seg.second;
-            svgFile << "        <line x1=\"" << floatToStr(segment.begin.x)
-                    << "\" y1=\"" << floatToStr(flipY(segment.begin.y, viewY, viewHeight))
-                    << "\" x2=\"" << floatToStr(segment.end.x)
-                    << "\" y2=\"" << floatToStr(flipY(segment.end.y, viewY, viewHeight))
-                    << "\" class=\"" << wireClass << "\" "
-                    << colorAttr << "/>\n";
+            lines.push_back(seg.second.begin);
+            lines.push_back(seg.second.end);
         }
+        std::vector< std::vector<GLPoint2f> > polylines;
+        buildPolylines(lines, polylines);
 
+        svgFile << "      <g id=\"wire_" << wire->getID() << "\" class=\"" << wireClass << "\" "
+                << colorAttr << ">\n";
+        writePolylines(svgFile, polylines, "        ",
+                       [viewY, viewHeight](float y) { return flipY(y, viewY, viewHeight); });
         svgFile << "      </g>\n";
     }
     svgFile << "    </g>\n";
@@ -505,8 +677,8 @@ bool SVGExporter::exportToSVG(GUICanvas* canvas, const std::string& filename,
         // Draw dots at wire-to-wire intersection points
         const auto& intersectPoints = wire->getIntersectPoints();
         for (const auto& pt : intersectPoints) {
-            svgFile << "      <circle cx=\"" << floatToStr(pt.x)
-                    << "\" cy=\"" << floatToStr(flipY(pt.y, viewY, viewHeight))
+            svgFile << "      <circle cx=\"" << pt.x
+                    << "\" cy=\"" << flipY(pt.y, viewY, viewHeight)
                     << "\" r=\"0.15\" class=\"wire-dot\"/>\n";
         }
 
@@ -518,8 +690,8 @@ bool SVGExporter::exportToSVG(GUICanvas* canvas, const std::string& filename,
                 auto hotspot = conn.cGate->getHotspot(conn.connection);
                 if (hotspot) {
                     GLPoint2f hotspotPos = hotspot->getLocation();
-                    svgFile << "      <circle cx=\"" << floatToStr(hotspotPos.x)
-                            << "\" cy=\"" << floatToStr(flipY(hotspotPos.y, viewY, viewHeight))
+                    svgFile << "      <circle cx=\"" << hotspotPos.x
+                            << "\" cy=\"" << flipY(hotspotPos.y, viewY, viewHeight)
                             << "\" r=\"0.15\" class=\"wire-dot\"/>\n";
                 }
             }
@@ -528,8 +700,7 @@ bool SVGExporter::exportToSVG(GUICanvas* canvas, const std::string& filename,
     svgFile << "    </g>\n";
 
     // Write SVG footer
-    svgFile << getSVGFooter();
-    svgFile.close();
+    writeSVGFooter(svgFile);
 
-    return true;
+    return svgFile.close();
 }
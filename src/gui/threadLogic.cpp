@@ -23,7 +23,14 @@
 
 DECLARE_APP(MainApp)
 
+// How often to sample gate and wire activity for the heat map (ms):
+static const long ACTIVITY_SAMPLE_TIME = 500;
+
+// How often to send the circuit's performance counters to the GUI (ms):
+static const long STATS_SAMPLE_TIME = 1000;
+
 threadLogic::threadLogic() : wxThread() {
+	activitySampled = false;
 	return;
 }
 
@@ -70,6 +77,7 @@ bool threadLogic::parseMessage(klsMessage::Message input) {
 		delete cir;
 		cir = new Circuit();
 		logicIDs->clear();
+		activitySampled = false;
 		break;
 	}
 	case klsMessage::MT_CREATE_GATE: {
@@ -219,7 +227,13 @@ bool threadLogic::parseMessage(klsMessage::Message input) {
 			// send interim done step message
 			sendMessage(klsMessage::Message(klsMessage::MT_COMPLETE_INTERIM_STEP));
 		}
-		sendMessage(klsMessage::Message(klsMessage::MT_DONESTEP, new klsMessage::Message_DONESTEP(simTime.Time())));
+		sampleActivity();
+		CircuitStats* stats = NULL;
+		if (statsTimer.Time() >= STATS_SAMPLE_TIME) {
+			statsTimer.Start();
+			stats = new CircuitStats(cir->getStats());
+		}
+		sendMessage(klsMessage::Message(klsMessage::MT_DONESTEP, new klsMessage::Message_DONESTEP(simTime.Time(), stats)));
 		delete ((klsMessage::Message_STEPSIM*)(input.mStruct));
 		break;
 	}
@@ -261,3 +275,41 @@ void threadLogic::sendMessage(klsMessage::Message message) {
 	wxMutexLocker lock(wxGetApp().mexMessages);
 	wxGetApp().dLOGICtoGUI.push_back(message);
 }
+
+void threadLogic::sampleActivity() {
+	if (!wxGetApp().activityVisible) {
+		activitySampled = false;
+		return;
+	}
+	long elapsed = activityTimer.Time();
+	if (activitySampled && elapsed < ACTIVITY_SAMPLE_TIME) return;
+	activityTimer.Start();
+
+	// Turn the change in each count since the last sample into a rate per second:
+	// (The first sample only records the counts.)
+	unordered_map<IDType, float> gateRates;
+	unordered_map<IDType, float> wireRates;
+	const ID_MAP< IDType, unsigned long long >* gateCounts = cir->getGateEvaluationCounts();
+	const ID_MAP< IDType, unsigned long long >* wireCounts = cir->getWireToggleCounts();
+	if (activitySampled && elapsed > 0) {
+		ID_MAP< IDType, unsigned long long >::const_iterator count = gateCounts->begin();
+		while (count != gateCounts->end()) {
+			unsigned long long last = lastGateEvaluations[count->first];
+			if (count->second > last) gateRates[count->first] = (count->second - last) * 1000.0f / elapsed;
+			count++;
+		}
+		count = wireCounts->begin();
+		while (count != wireCounts->end()) {
+			unsigned long long last = lastWireToggles[count->first];
+			if (count->second > last) wireRates[count->first] = (count->second - last) * 1000.0f / elapsed;
+			count++;
+		}
+	}
+	lastGateEvaluations = *gateCounts;
+	lastWireToggles = *wireCounts;
+	activitySampled = true;
+
+	wxMutexLocker lock(wxGetApp().activityMutex);
+	wxGetApp().gateActivity.swap(gateRates);
+	wxGetApp().wireActivity.swap(wireRates);
+}
@@ -76,10 +76,12 @@ public:
 	}
 
 	// Step the simulation and return an object with changed wire IDs and their new states.
-	// Returns a JS object: { changedWires: [{id, state}, ...], time: number }
+	// Returns a JS object: { changedWires: [{id, state}, ...], time: number, complete: bool }
+	// With an event budget set, complete is false until the timestep has been finished
+	// (and changedWires stays empty until then).
 	val step() {
 		ID_SET<IDType> changedWires;
-		circuit.step(&changedWires);
+		bool complete = circuit.step(&changedWires);
 
 		val result = val::object();
 		val wireChanges = val::array();
@@ -94,6 +96,7 @@ public:
 
 		result.set("changedWires", wireChanges);
 		result.set("time", static_cast<double>(circuit.getSystemTime()));
+		result.set("complete", complete);
 		return result;
 	}
 
@@ -102,7 +105,7 @@ public:
 		ID_SET<IDType> allChanged;
 		for (int i = 0; i < n; i++) {
 			ID_SET<IDType> changed;
-			circuit.step(&changed);
+			while (!circuit.step(&changed)) {}
 			allChanged.insert(changed.begin(), changed.end());
 		}
 
@@ -119,6 +122,7 @@ public:
 
 		result.set("changedWires", wireChanges);
 		result.set("time", static_cast<double>(circuit.getSystemTime()));
+		result.set("complete", true);
 		return result;
 	}
 
@@ -134,6 +138,84 @@ public:
 		circuit.destroyAllEvents();
 	}
 
+	void setInertialDelays(bool inertial) {
+		circuit.setInertialDelays(inertial);
+	}
+
+	bool getInertialDelays() {
+		return circuit.getInertialDelays();
+	}
+
+	void setEventBudget(unsigned long budget) {
+		circuit.setEventBudget(budget);
+	}
+
+	unsigned long getEventBudget() {
+		return circuit.getEventBudget();
+	}
+
+	double getOverflowSteps() {
+		return static_cast<double>(circuit.getOverflowSteps());
+	}
+
+	double getOverflowEvents() {
+		return static_cast<double>(circuit.getOverflowEvents());
+	}
+
+	// Performance counters as a JS object (see CircuitStats).
+	val getStats() {
+		CircuitStats stats = circuit.getStats();
+		val result = val::object();
+		result.set("steps", static_cast<double>(stats.steps));
+		result.set("eventsScheduled", static_cast<double>(stats.eventsScheduled));
+		result.set("eventsProcessed", static_cast<double>(stats.eventsProcessed));
+		result.set("eventsDropped", static_cast<double>(stats.eventsDropped));
+		result.set("queueHighWater", static_cast<double>(stats.queueHighWater));
+		result.set("wireGroupsResolved", static_cast<double>(stats.wireGroupsResolved));
+		result.set("wiresResolved", static_cast<double>(stats.wiresResolved));
+		result.set("largestWireGroup", static_cast<double>(stats.largestWireGroup));
+		result.set("wireToggles", static_cast<double>(stats.wireToggles));
+		result.set("gatesEvaluated", static_cast<double>(stats.gatesEvaluated));
+		val byType = val::object();
+		for (const auto &entry : stats.gatesEvaluatedByType) {
+			byType.set(entry.first, static_cast<double>(entry.second));
+		}
+		result.set("gatesEvaluatedByType", byType);
+		result.set("overflowSteps", static_cast<double>(stats.overflowSteps));
+		result.set("overflowEvents", static_cast<double>(stats.overflowEvents));
+		result.set("gateQueueSeconds", stats.gateQueueSeconds);
+		result.set("eventSeconds", stats.eventSeconds);
+		result.set("wireSeconds", stats.wireSeconds);
+		result.set("gateSeconds", stats.gateSeconds);
+		return result;
+	}
+
+	void resetStats() {
+		circuit.resetStats();
+	}
+
+	double getGateEvaluations(IDType gateID) {
+		return static_cast<double>(circuit.getGateEvaluations(gateID));
+	}
+
+	double getWireToggles(IDType wireID) {
+		return static_cast<double>(circuit.getWireToggles(wireID));
+	}
+
+	// Snapshot the simulation state as a Uint8Array.
+	val saveSimulationState() {
+		std::string snapshot = circuit.saveSimulationState();
+		return val::global("Uint8Array").new_(typed_memory_view(snapshot.size(),
+			reinterpret_cast<const unsigned char *>(snapshot.data())));
+	}
+
+	// Restore a snapshot from saveSimulationState(). Returns false if it
+	// doesn't match this circuit.
+	bool restoreSimulationState(const val &snapshot) {
+		std::vector<unsigned char> bytes = convertJSArrayToNumberVector<unsigned char>(snapshot);
+		return circuit.restoreSimulationState(std::string(bytes.begin(), bytes.end()));
+	}
+
 	// Get all wire states as a flat array: [wireID, state, wireID, state, ...]
 	// Useful for full state sync.
 	val getAllWireStates() {
@@ -177,5 +259,17 @@ EMSCRIPTEN_BINDINGS(cedarlogic) {
 		.function("stepN", &CircuitWrapper::stepN)
 		.function("stepOnlyGates", &CircuitWrapper::stepOnlyGates)
 		.function("getSystemTime", &CircuitWrapper::getSystemTime)
-		.function("destroyAllEvents", &CircuitWrapper::destroyAllEvents);
+		.function("destroyAllEvents", &CircuitWrapper::destroyAllEvents)
+		.function("setInertialDelays", &CircuitWrapper::setInertialDelays)
+		.function("getInertialDelays", &CircuitWrapper::getInertialDelays)
+		.function("setEventBudget", &CircuitWrapper::setEventBudget)
+		.function("getEventBudget", &CircuitWrapper::getEventBudget)
+		.function("getOverflowSteps", &CircuitWrapper::getOverflowSteps)
+		.function("getOverflowEvents", &CircuitWrapper::getOverflowEvents)
+		.function("getStats", &CircuitWrapper::getStats)
+		.function("resetStats", &CircuitWrapper::resetStats)
+		.function("getGateEvaluations", &CircuitWrapper::getGateEvaluations)
+		.function("getWireToggles", &CircuitWrapper::getWireToggles)
+		.function("saveSimulationState", &CircuitWrapper::saveSimulationState)
+		.function("restoreSimulationState", &CircuitWrapper::restoreSimulationState);
 }
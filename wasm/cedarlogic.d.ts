@@ -126,6 +126,32 @@ export interface WireChange {
 export interface StepResult {
   changedWires: WireChange[];
   time: number;
+  /** False if the event budget ran out part of the way through the timestep. */
+  complete: boolean;
+}
+
+/** Performance counters kept by the simulator since creation or resetStats(). */
+export interface CircuitStats {
+  steps: number;
+  eventsScheduled: number;
+  eventsProcessed: number;
+  /** Events cancelled or swallowed before they happened. */
+  eventsDropped: number;
+  queueHighWater: number;
+  /** Groups of junction-joined wires that had their state calculated. */
+  wireGroupsResolved: number;
+  wiresResolved: number;
+  largestWireGroup: number;
+  wireToggles: number;
+  gatesEvaluated: number;
+  gatesEvaluatedByType: Partial<Record<GateType, number>>;
+  overflowSteps: number;
+  overflowEvents: number;
+  /** Seconds spent in each phase of step(). */
+  gateQueueSeconds: number;
+  eventSeconds: number;
+  wireSeconds: number;
+  gateSeconds: number;
 }
 
 export interface Circuit {
@@ -155,9 +181,13 @@ export interface Circuit {
 
   getWireState(wireID: number): WireState;
 
-  /** Advance simulation by one step. Returns changed wires and current time. */
+  /**
+   * Advance simulation by one step. Returns changed wires and current time.
+   * With an event budget set, a busy timestep may take several calls; the
+   * result has complete === false (and no changed wires) until it is done.
+   */
   step(): StepResult;
-  /** Advance simulation by n steps. Returns all wires that changed and final time. */
+  /** Advance simulation by n whole steps. Returns all wires that changed and final time. */
   stepN(n: number): StepResult;
   /** Re-evaluate gates without advancing time (e.g. after parameter changes). */
   stepOnlyGates(): void;
@@ -165,6 +195,39 @@ export interface Circuit {
   getSystemTime(): number;
   destroyAllEvents(): void;
 
+  /**
+   * Use inertial delays: pulses shorter than a gate's delay are swallowed
+   * instead of passed through. Defaults to false (transport delays).
+   */
+  setInertialDelays(inertial: boolean): void;
+  getInertialDelays(): boolean;
+
+  /**
+   * Limit the events handled per step() call so that busy timesteps can be
+   * spread across frames. 0 (the default) means no limit. Events are never dropped.
+   */
+  setEventBudget(budget: number): void;
+  getEventBudget(): number;
+  /** Number of timesteps that had more events than the budget. */
+  getOverflowSteps(): number;
+  /** Total events past the budget across those timesteps. */
+  getOverflowEvents(): number;
+
+  getStats(): CircuitStats;
+  resetStats(): void;
+  /** Number of times a gate has been updated since creation or resetStats(). */
+  getGateEvaluations(gateID: GateId): number;
+  /** Number of times a wire has changed state since creation or resetStats(). */
+  getWireToggles(wireID: number): number;
+
+  /** Snapshot the simulation state (wires, pending events, gate memory, time). */
+  saveSimulationState(): Uint8Array;
+  /**
+   * Restore a snapshot in place. The circuit must have the same gates and wires
+   * as when it was saved; returns false (and changes nothing) otherwise.
+   */
+  restoreSimulationState(snapshot: Uint8Array): boolean;
+
   /** Free the C++ Circuit object. Must be called when done. */
   delete(): void;
 }